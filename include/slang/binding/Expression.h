@@ -277,6 +277,10 @@ public:
     /// Returns true if any subexpression of this expression is a hierarchical reference.
     bool hasHierarchicalReference() const;
 
+    /// Applies the given binary operator to two already evaluated operands.
+    static ConstantValue evalBinaryOperator(BinaryOperator op, const ConstantValue& cvl,
+                                            const ConstantValue& cvr);
+
     template<typename T>
     T& as() {
         ASSERT(T::isKind(kind));
@@ -305,9 +309,6 @@ protected:
     static const Type* binaryOperatorType(Compilation& compilation, const Type* lt, const Type* rt,
                                           bool forceFourState, bool signednessFromRt = false);
 
-    static ConstantValue evalBinaryOperator(BinaryOperator op, const ConstantValue& cvl,
-                                            const ConstantValue& cvr);
-
     static Expression& create(Compilation& compilation, const ExpressionSyntax& syntax,
                               const BindContext& context,
                               bitmask<BindFlags> extraFlags = BindFlags::None,
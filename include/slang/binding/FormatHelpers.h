@@ -6,6 +6,7 @@
 //------------------------------------------------------------------------------
 #pragma once
 
+#include "slang/mir/Instr.h"
 #include "slang/numeric/SVInt.h"
 #include "slang/text/SourceLocation.h"
 #include "slang/util/Util.h"
@@ -37,8 +38,10 @@ public:
     static optional<std::string> formatDisplay(const Scope& scope, EvalContext& context,
                                                const span<const Expression* const>& args);
 
+    /// Lowers the arguments of a display-like call into runtime print calls.
+    /// If @a fd is provided the output goes to that file descriptor instead of stdout.
     static void lowerFormatArgs(mir::Procedure& proc, const span<const Expression* const>& args,
-                                LiteralBase defaultIntFmt, bool newline);
+                                LiteralBase defaultIntFmt, bool newline, mir::MIRValue fd = {});
 
     static bool checkFinishNum(const BindContext& context, const Expression& arg);
 
@@ -53,6 +53,14 @@ public:
     ConstantValue evalImpl(EvalContext& context) const;
     LValue evalLValueImpl(EvalContext& context) const;
 
+    /// Gets a pointer to the current value of the referenced symbol without copying it,
+    /// for callers that only need to read part of a potentially large value.
+    /// Returns nullptr if the value can't be referenced in place, in which case the
+    /// caller should fall back to a normal eval(). If the reference is not allowed
+    /// in a constant context, a diagnostic is issued and a pointer to an invalid
+    /// value is returned.
+    const ConstantValue* evalInPlace(EvalContext& context) const;
+
     static bool isKind(ExpressionKind kind) { return kind == ExpressionKind::NamedValue; }
 
 private:
@@ -8,6 +8,7 @@
 
 #include "slang/binding/CallExpression.h"
 #include "slang/binding/Expression.h"
+#include "slang/mir/Instr.h"
 #include "slang/symbols/SemanticFacts.h"
 #include "slang/types/AllTypes.h"
 #include "slang/util/SmallVector.h"
@@ -42,7 +43,7 @@ public:
     virtual ConstantValue eval(EvalContext& context, const Args& args, SourceRange range,
                                const CallExpression::SystemCallInfo& callInfo) const = 0;
 
-    virtual void lower(mir::Procedure&, const Args&) const {}
+    virtual mir::MIRValue lower(mir::Procedure&, const Args&) const { return {}; }
 
 protected:
     SystemSubroutine(const std::string& name, SubroutineKind kind) : name(name), kind(kind) {}
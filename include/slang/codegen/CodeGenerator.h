@@ -40,33 +40,74 @@ enum class SysCallKind;
 
 struct CodegenOptions {
     uint32_t maxIntBits = 128;
+
+    /// The level of LLVM optimization (0-3) to run on generated code
+    /// before it is handed off for execution. Level 0 disables optimization;
+    /// levels 2 and above also enable loop and SLP vectorization.
+    uint32_t optLevel = 0;
+
+    /// The number of threads to use for generating code. When greater than one,
+    /// procedures are partitioned across that many separate LLVM modules (each
+    /// with its own context) which are generated and optimized concurrently.
+    uint32_t numThreads = 1;
+
     bool flattenFourState = false;
 };
 
+/// Time spent producing a module of generated code, in seconds.
+struct CodegenTiming {
+    /// Time spent generating LLVM IR from MIR procedures.
+    double codegen = 0.0;
+
+    /// Time spent running the LLVM optimization pipeline.
+    double optimize = 0.0;
+};
+
 class GeneratedCode {
 public:
-    GeneratedCode(std::unique_ptr<llvm::LLVMContext> context, std::unique_ptr<llvm::Module> module);
+    GeneratedCode(std::unique_ptr<llvm::LLVMContext> context, std::unique_ptr<llvm::Module> module,
+                  CodegenTiming timing = {});
     GeneratedCode(GeneratedCode&&);
     ~GeneratedCode();
 
+    /// @return the name of the generated module.
+    std::string getName() const;
+
+    /// @return timing information about how long it took to produce the code.
+    const CodegenTiming& getTiming() const { return timing; }
+
     std::pair<std::unique_ptr<llvm::LLVMContext>, std::unique_ptr<llvm::Module>> release();
     std::string toString() const;
 
+    /// Compiles the generated code ahead of time and writes it as a native object
+    /// file to the given path. The object defines a C-compatible @a main entry point
+    /// and can be linked against the slangruntime library to produce a standalone
+    /// executable. Code is generated for a generic CPU of the host architecture so
+    /// that the result can be run on other machines. Throws an exception on failure.
+    void writeObjectFile(const std::string& path);
+
 private:
     std::unique_ptr<llvm::LLVMContext> context;
     std::unique_ptr<llvm::Module> module;
+    CodegenTiming timing;
 };
 
 class CodeGenerator {
 public:
-    explicit CodeGenerator(const Compilation& compilation);
+    explicit CodeGenerator(const Compilation& compilation, const CodegenOptions& options = {});
     ~CodeGenerator();
 
+    /// Emits code for all procedures in the given design. If the options specify
+    /// more than one thread, procedures are generated concurrently into separate
+    /// modules, which will all be returned from @a finish.
     void emitAll(const mir::MIRBuilder& design);
 
     void emit(const mir::Procedure& proc);
 
-    GeneratedCode finish();
+    /// Finishes code generation and returns the generated modules. The first
+    /// module always contains the main entry point; any others contain procedures
+    /// generated in parallel that the main module refers to by name.
+    std::vector<GeneratedCode> finish();
 
     llvm::LLVMContext& getContext() { return *ctx; }
     llvm::Module& getModule() { return *module; }
@@ -80,6 +121,16 @@ public:
     llvm::GlobalVariable* getOrCreateStringConstant(const std::string& str);
 
 private:
+    struct PartitionTag {};
+    CodeGenerator(const Compilation& compilation, const CodegenOptions& options,
+                  const std::string& moduleName, PartitionTag);
+
+    void initTarget();
+    void emitPartitioned(span<const std::unique_ptr<mir::Procedure>> procs);
+    void emitExternal(const mir::Procedure& proc, const std::string& name);
+    void finalizeModule();
+    void optimize();
+
     std::unique_ptr<llvm::LLVMContext> ctx;
     std::unique_ptr<llvm::Module> module;
     std::unique_ptr<CodeGenTypes> types;
@@ -87,9 +138,12 @@ private:
     flat_hash_map<std::string, llvm::GlobalVariable*> stringConstants;
     const Compilation& compilation;
     CodegenOptions options;
-    llvm::BasicBlock* globalInitBlock;
+    llvm::BasicBlock* globalInitBlock = nullptr;
     std::vector<llvm::BasicBlock*> initialBlocks;
-    llvm::Function* mainFunc;
+    llvm::Function* mainFunc = nullptr;
+    CodegenTiming timing;
+    std::vector<std::unique_ptr<CodeGenerator>> partitions;
+    uint32_t externalProcCount = 0;
 };
 
 } // namespace slang
@@ -17,15 +17,37 @@ class LLLazyJIT;
 
 namespace slang {
 
+class DiskObjectCache;
+
+struct JITOptions {
+    /// If non-empty, compiled object code is stored in this directory, keyed by
+    /// a hash of the module it came from, and reused by later runs that
+    /// generate identical code.
+    std::string objectCacheDir;
+
+    /// The number of threads to use for compiling code on demand.
+    /// If zero, code is compiled on the thread that requests it.
+    uint32_t numCompileThreads = 0;
+};
+
 class JIT {
 public:
-    JIT();
+    explicit JIT(const JITOptions& options = {});
     ~JIT();
 
     void addCode(GeneratedCode code);
+    void addCode(std::vector<GeneratedCode> code);
     int run();
 
+    /// @return the number of modules loaded from the object cache instead of being compiled.
+    uint64_t getNumCacheHits() const;
+
+    /// @return the number of modules that were compiled because they were not in the cache.
+    uint64_t getNumCacheMisses() const;
+
 private:
+    // Note: the cache must outlive the JIT that refers to it.
+    std::unique_ptr<DiskObjectCache> objectCache;
     std::unique_ptr<llvm::orc::LLLazyJIT> jit;
 };
 
@@ -6,7 +6,10 @@
 //------------------------------------------------------------------------------
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <shared_mutex>
 
 #include "slang/diagnostics/Diagnostics.h"
 #include "slang/numeric/Time.h"
@@ -23,6 +26,7 @@ class AttributeSymbol;
 class BindContext;
 class CompilationUnitSymbol;
 class Definition;
+class DependencyGraph;
 class Expression;
 class GenericClassDefSymbol;
 class PackageSymbol;
@@ -62,6 +66,9 @@ enum class MinTypMax {
     Max
 };
 
+/// Kinds of relationships between types that are cached by the compilation.
+enum class TypeRelation : uint8_t { Matching, Equivalent, AssignmentCompatible };
+
 /// Contains various options that can control compilation behavior.
 struct CompilationOptions {
     /// The maximum depth of nested module instances (and interfaces/programs),
@@ -124,6 +131,10 @@ struct CompilationOptions {
     /// for tests; for end users, they can use warning flags to control output.
     bool suppressUnused = true;
 
+    /// If true, measure how much memory and constant evaluation time goes into
+    /// elaborating each definition. See Compilation::getDefinitionStats.
+    bool collectStats = false;
+
     /// If non-empty, specifies the list of modules that should serve as the
     /// top modules in the design. If empty, this will be automatically determined
     /// based on which modules are unreferenced elsewhere.
@@ -164,6 +175,52 @@ public:
     /// Gets the set of syntax trees that have been added to the compilation.
     span<const std::shared_ptr<SyntaxTree>> getSyntaxTrees() const;
 
+    /// Gets a graph of the dependencies between the design elements declared in the
+    /// compilation's syntax trees. The graph is built the first time this is called.
+    const DependencyGraph& getDependencyGraph();
+
+    /// Creates a new compilation with the same options and syntax trees as this one,
+    /// except that @a oldTree is replaced by @a newTree (which could for example be the
+    /// result of calling SyntaxTree::reparse on it), and reuses as many of this
+    /// compilation's semantic diagnostics as possible.
+    ///
+    /// No symbols are shared between the two compilations; the new one elaborates its
+    /// design from scratch. What gets reused is checking: if semantic diagnostics have
+    /// already been collected for this compilation, the new compilation keeps the
+    /// diagnostics for all of the modules, interfaces, programs, and packages that are
+    /// unaffected by the change (as determined by the dependency graph), and doesn't bind
+    /// and check their contents again when its own diagnostics are requested. The new
+    /// compilation can otherwise be used like one created from scratch, and this one can
+    /// be safely destroyed afterwards.
+    ///
+    /// If diagnostics haven't been collected for this compilation yet, the only ones it
+    /// has are those that it carried over itself, so those are passed along for any of
+    /// their elements that are still unaffected. This means several replacements can be
+    /// made in a row without checking each intermediate compilation. A compilation that
+    /// has neither collected nor carried over any diagnostics has nothing to reuse, in
+    /// which case the new compilation checks its entire design; see
+    /// @a getNumReusedElements.
+    ///
+    /// Note that system subroutines and methods added by the user are not carried over.
+    std::unique_ptr<Compilation> replaceSyntaxTreeReusingDiagnostics(
+        const SyntaxTree& oldTree, std::shared_ptr<SyntaxTree> newTree);
+
+    /// A syntax tree in a compilation along with the tree that should replace it.
+    using TreeReplacement = std::pair<const SyntaxTree*, std::shared_ptr<SyntaxTree>>;
+
+    /// Creates a new compilation like @a replaceSyntaxTreeReusingDiagnostics does, except
+    /// that any number of syntax trees can be replaced at once, which saves creating (and
+    /// adding all of the syntax trees to) a compilation for each intermediate step. Each
+    /// tree can only be listed once. Diagnostics are reused for everything that none of
+    /// the changes affect.
+    std::unique_ptr<Compilation> replaceSyntaxTreesReusingDiagnostics(
+        span<const TreeReplacement> replacements);
+
+    /// Gets the number of modules, interfaces, programs, and packages whose diagnostics
+    /// were carried over from another compilation by @a replaceSyntaxTreeReusingDiagnostics,
+    /// and which therefore won't be checked again.
+    size_t getNumReusedElements() const { return reusedElements.size(); }
+
     /// Gets the compilation unit for the given syntax node. The compilation unit must have
     /// already been added to the compilation previously via a call to @a addSyntaxTree
     const CompilationUnitSymbol* getCompilationUnit(const CompilationUnitSyntax& syntax) const;
@@ -343,6 +400,13 @@ public:
     /// Gets all of the diagnostics produced during compilation.
     const Diagnostics& getAllDiagnostics();
 
+    /// Returns true if collecting semantic diagnostics visited the entire design, which
+    /// forces the evaluation of everything that is evaluated lazily. This is false until
+    /// diagnostics have been collected, and stays false if collecting them stopped early
+    /// because the error limit was reached or the instance hierarchy was too deep, or if
+    /// some design elements had their diagnostics reused from another compilation.
+    bool isFullyElaborated() const { return fullyElaborated; }
+
     /// Adds a set of diagnostics to the compilation's list of semantic diagnostics.
     void addDiagnostics(const Diagnostics& diagnostics);
 
@@ -361,8 +425,129 @@ public:
 
     const Type& getType(bitwidth_t width, bitmask<IntegralFlags> flags);
     const Type& getScalarType(bitmask<IntegralFlags> flags);
+
+    /// Gets a packed array type with the given element type and range. Array types are
+    /// uniquified, so asking for the same element type and range again returns the
+    /// same object. If the type is created by this call, it is given @a syntax.
+    const Type& getPackedArrayType(const Type& elementType, ConstantRange range,
+                                   const SyntaxNode* syntax = nullptr);
+
+    /// Gets a fixed size unpacked array type with the given element type and range.
+    /// These are uniquified in the same way as packed array types.
+    const Type& getUnpackedArrayType(const Type& elementType, ConstantRange range,
+                                     const SyntaxNode* syntax = nullptr);
     const NetType& getNetType(TokenKind kind) const;
 
+    /// Looks up the cached result of checking the given relation between two
+    /// canonical types. This is used by the Type class to avoid repeating deep
+    /// structural comparisons; see @a cacheTypeRelation. The cache is safe to use
+    /// from multiple threads at once.
+    optional<bool> findTypeRelation(TypeRelation relation, const Type& left, const Type& right);
+
+    /// Records the result of checking the given relation between two canonical types.
+    void cacheTypeRelation(TypeRelation relation, const Type& left, const Type& right,
+                           bool result);
+
+    /// Counters for the type relation cache.
+    struct TypeRelationStats {
+        /// The number of relation checks answered from the cache.
+        size_t hits = 0;
+
+        /// The number of relation checks that had to be computed.
+        size_t misses = 0;
+    };
+
+    /// Gets counters describing how effective the type relation cache has been.
+    TypeRelationStats getTypeRelationStats() const;
+
+    /// Counters for work done while elaborating the design, collected when
+    /// the @a collectStats compilation option is set.
+    struct ElaborationCounters {
+        /// The number of name lookups performed.
+        size_t lookups = 0;
+
+        /// The number of type symbols created.
+        size_t typesCreated = 0;
+
+        /// The number of steps taken by constant evaluation.
+        size_t evalSteps = 0;
+    };
+
+    /// Gets counters describing how much work has gone into elaboration so far.
+    ElaborationCounters getElaborationCounters() const;
+
+    /// Records a name lookup in the elaboration counters, if they're being collected.
+    void noteLookup() {
+        if (options.collectStats)
+            lookupCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// Records a constant evaluation step in the elaboration counters,
+    /// if they're being collected.
+    void noteEvalStep() {
+        if (options.collectStats)
+            evalStepCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// Measurements for a single definition, collected when the @a collectStats
+    /// compilation option is set.
+    struct DefinitionStats {
+        /// The number of bytes allocated from the compilation while creating and
+        /// elaborating instances of the definition, not counting nested instances.
+        size_t bytesAllocated = 0;
+
+        /// The time spent in constant evaluation while elaborating instances
+        /// of the definition, not counting nested instances.
+        std::chrono::nanoseconds constEvalTime{ 0 };
+    };
+
+    /// Gets the measurements collected for the given definition, or nullptr
+    /// if there aren't any.
+    const DefinitionStats* getDefinitionStats(const Definition& definition) const;
+
+    /// While alive, charges memory allocated from the compilation and time spent
+    /// in constant evaluation to the given definition, if the @a collectStats option
+    /// is set. These can nest; the innermost one is charged until it ends.
+    class DefinitionStatsScope {
+    public:
+        DefinitionStatsScope(Compilation& compilation, const Definition& definition);
+        ~DefinitionStatsScope();
+
+        DefinitionStatsScope(const DefinitionStatsScope&) = delete;
+        DefinitionStatsScope& operator=(const DefinitionStatsScope&) = delete;
+
+    private:
+        Compilation* compilation = nullptr;
+        const Definition* savedDefinition = nullptr;
+    };
+
+    /// While alive, counts as time spent in constant evaluation if the @a collectStats
+    /// option is set. Only the outermost of a set of nested timers is measured.
+    class ConstEvalTimer {
+    public:
+        explicit ConstEvalTimer(Compilation& compilation);
+        ~ConstEvalTimer();
+
+        ConstEvalTimer(const ConstEvalTimer&) = delete;
+        ConstEvalTimer& operator=(const ConstEvalTimer&) = delete;
+
+    private:
+        Compilation* compilation = nullptr;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    /// Constructs a new object using the compilation's allocator.
+    /// NOTE: the type of object being created must be trivially destructible,
+    /// since the allocator won't run destructors when freeing memory.
+    template<typename T, typename... Args>
+    T* emplace(Args&&... args) {
+        if constexpr (std::is_base_of_v<Type, T>) {
+            if (options.collectStats)
+                typeCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        return BumpAllocator::emplace<T>(std::forward<Args>(args)...);
+    }
+
     /// Various built-in type symbols for easy access.
     const Type& getBitType() const { return *bitType; }
     const Type& getLogicType() const { return *logicType; }
@@ -418,6 +603,7 @@ private:
     Scope::DeferredMemberData& getOrAddDeferredData(Scope::DeferredMemberIndex& index);
     void trackImport(Scope::ImportDataIndex& index, const WildcardImportSymbol& import);
     span<const WildcardImportSymbol*> queryImports(Scope::ImportDataIndex index);
+    Scope::ImportData& getImportData(Scope::ImportDataIndex index) { return importData[index]; }
 
     bool doTypoCorrection() const { return typoCorrections < options.typoCorrectionLimit; }
     void didTypoCorrection() { typoCorrections++; }
@@ -472,6 +658,32 @@ private:
     // A cache of vector types, keyed on various properties such as bit width.
     flat_hash_map<uint32_t, const Type*> vectorTypeCache;
 
+    // A cache of fixed size array types, keyed on the kind of array, the element type,
+    // and the range. Signedness and four-statedness come from the element type.
+    flat_hash_map<std::tuple<SymbolKind, const Type*, int32_t, int32_t>, const Type*>
+        arrayTypeCache;
+
+    // A cache of relations between types that are expensive to compare. Relations
+    // can also be checked by visitors running in parallel, so it has its own lock.
+    flat_hash_map<std::tuple<const Type*, const Type*, TypeRelation>, bool> typeRelationCache;
+    mutable std::shared_mutex typeRelationMutex;
+    std::atomic<size_t> typeRelationHits = 0;
+    std::atomic<size_t> typeRelationMisses = 0;
+
+    // Statistics about elaboration. Allocations are charged to the definition
+    // in statsDefinition each time it changes, based on how much the allocator
+    // has handed out since the last change.
+    void switchStatsDefinition(const Definition* definition);
+    flat_hash_map<const Definition*, DefinitionStats> definitionStats;
+    const Definition* statsDefinition = nullptr;
+    size_t statsBytesCheckpoint = 0;
+
+    // Elaboration counters. These are atomic because lookups and constant evaluation
+    // can also happen on other threads, from visitors run by a ParallelASTVisitor.
+    std::atomic<size_t> lookupCount = 0;
+    std::atomic<size_t> typeCount = 0;
+    std::atomic<size_t> evalStepCount = 0;
+
     // Map from syntax kinds to the built-in types.
     flat_hash_map<SyntaxKind, const Type*> knownTypes;
 
@@ -542,6 +754,9 @@ private:
     optional<Diagnostics> cachedSemanticDiagnostics;
     optional<Diagnostics> cachedAllDiagnostics;
 
+    // Set when collecting semantic diagnostics visited the entire design.
+    bool fullyElaborated = false;
+
     // A list of compilation units that have been added to the compilation.
     std::vector<const CompilationUnitSymbol*> compilationUnits;
 
@@ -592,6 +807,15 @@ private:
 
     // The built-in std package.
     const PackageSymbol* stdPkg = nullptr;
+
+    // The graph of dependencies between design elements, built on demand.
+    std::unique_ptr<DependencyGraph> dependencyGraph;
+
+    // Syntax for design elements whose diagnostics were carried over from a previous
+    // compilation instead of being checked again, along with the diagnostics themselves
+    // and the hierarchical paths of the instances they were coalesced to, if any.
+    flat_hash_set<const SyntaxNode*> reusedElements;
+    std::vector<std::pair<Diagnostic, std::string>> carriedDiagnostics;
 };
 
 } // namespace slang
@@ -0,0 +1,104 @@
+//------------------------------------------------------------------------------
+//! @file DependencyGraph.h
+//! @brief Tracking of dependencies between design elements
+//
+// File is under the MIT license; see LICENSE for details
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "slang/syntax/SyntaxNode.h"
+#include "slang/text/SourceLocation.h"
+#include "slang/util/Hash.h"
+
+namespace slang {
+
+class SyntaxTree;
+
+/// Tracks dependencies between the top-level design elements (modules, interfaces,
+/// programs, packages, and primitives) declared in a set of syntax trees. This works
+/// purely from syntax so it can be kept up to date without elaborating anything, and
+/// it errs on the side of reporting too many dependencies: an element is considered
+/// to depend on every other element whose name appears as an identifier inside of it.
+///
+/// Declarations at the compilation unit level that aren't part of any design element
+/// are grouped into a single unnamed element for each syntax tree, which every other
+/// element in that tree depends on.
+///
+/// Copying the graph is cheap; the elements for each tree are shared between copies.
+class DependencyGraph {
+public:
+    /// Information about a single design element.
+    struct Element {
+        /// The name of the element. This is empty for the element
+        /// representing compilation unit level declarations.
+        string_view name;
+
+        /// The kind of syntax that declares the element.
+        SyntaxKind kind;
+
+        /// The syntax node that declares the element; for the compilation unit
+        /// element this is the root of the tree.
+        const SyntaxNode* syntax;
+
+        /// The syntax tree that contains the element.
+        const SyntaxTree* tree;
+
+        /// A hash of the element's text along with any parser state that was
+        /// in effect for it, used to detect changes between versions of a tree.
+        size_t hash = 0;
+
+        /// The range of text covered by the element. This is only valid if
+        /// the element is self contained (see @a isSelfContained).
+        SourceRange range;
+
+        /// The names of identifiers used within the element.
+        flat_hash_set<string_view> references;
+
+        /// Set if all of the element's tokens come straight from its own source
+        /// text with no preprocessor directives or macros involved, meaning that
+        /// two elements with the same hash will always be parsed the same way.
+        bool isSelfContained = true;
+
+        /// Set if the element contains dotted names that could be hierarchical
+        /// references into the instances below it.
+        bool hasHierarchicalRefs = false;
+
+        /// Set if the element contains constructs such as defparams, bind directives, or
+        /// DPI imports and exports, which can affect arbitrary other parts of the design.
+        bool hasGlobalEffects = false;
+
+        /// Indicates whether this is the element representing compilation unit declarations.
+        bool isCompilationUnit() const { return kind == SyntaxKind::CompilationUnit; }
+
+        /// Indicates whether this element represents a module, interface, or program,
+        /// which are the elements that can be instantiated in the design hierarchy.
+        bool isInstantiable() const;
+    };
+
+    /// Adds all of the design elements in the given syntax tree to the graph.
+    /// The tree must stay alive for as long as it remains in the graph.
+    void addTree(const SyntaxTree& tree);
+
+    /// Removes all of the design elements in the given syntax tree from the graph.
+    void removeTree(const SyntaxTree& tree);
+
+    /// Gets the design elements declared in the given syntax tree.
+    span<const Element> getElements(const SyntaxTree& tree) const;
+
+    /// Determines which design elements in the graph are affected by changes to the given
+    /// elements, which can include elements from other graphs (such as old versions of
+    /// elements that have since been removed). The result includes every element that
+    /// transitively depends on a changed element, along with everything instantiated
+    /// beneath elements that could be passing different parameter values to their
+    /// children as a result. If any affected element has global effects, every element
+    /// in the graph is considered affected.
+    flat_hash_set<const Element*> getAffected(span<const Element* const> changed) const;
+
+private:
+    flat_hash_map<const SyntaxTree*, std::shared_ptr<const std::vector<Element>>> elementsByTree;
+};
+
+} // namespace slang
@@ -16,6 +16,8 @@
 namespace slang {
 
 struct CompilationUnitSyntax;
+class Expression;
+class JsonWriter;
 
 class SemanticModel {
 public:
@@ -35,10 +37,63 @@ public:
     const EnumType* getDeclaredSymbol(const EnumTypeSyntax& syntax);
     const TypeAliasType* getDeclaredSymbol(const TypedefDeclarationSyntax& syntax);
 
+    /// Gets the symbol that is declared or referenced at the given source location,
+    /// or nullptr if there isn't one. If the location is in code that gets elaborated
+    /// more than once (such as a module with several instances) the symbol from the
+    /// first instance is returned.
+    ///
+    /// The first query of the symbol index walks the entire elaborated design to build
+    /// it; later queries are a binary search.
+    const Symbol* getSymbolAt(SourceLocation location);
+
+    /// Gets all of the expressions in the design that refer to the given symbol,
+    /// either by name or through a subroutine call.
+    span<const Expression* const> getReferences(const Symbol& symbol);
+
+    /// Adds the declarations and references within @a symbol to the symbol index.
+    /// This is useful for parts of the design that aren't reachable from the root,
+    /// such as the placeholder instances created by getDeclaredSymbol. Adding a
+    /// symbol that has already been indexed does nothing.
+    void addToIndex(const Symbol& symbol);
+
+    /// Writes the contents of the symbol index out as JSON, with symbols identified
+    /// by their hierarchical paths, so that it can be stored alongside the design.
+    /// Locations are ordered by file and offset, and references by symbol path, so
+    /// the output is the same each time for the same design.
+    ///
+    /// This is an export format meant for other tools to consume; there is no way
+    /// to load it back into a SemanticModel, which always builds its index from
+    /// the compilation.
+    void serializeIndex(JsonWriter& writer);
+
 private:
+    struct IndexEntry {
+        size_t start;
+        size_t end;
+        const Symbol* symbol;
+    };
+
+    struct BufferIndex {
+        std::vector<IndexEntry> entries;
+        bool sorted = true;
+    };
+
+    friend struct SymbolIndexBuilder;
+
+    static void sortIndex(BufferIndex& index);
+
+    void ensureIndex();
+    void addIndexEntry(SourceRange range, const Symbol& symbol);
+    void addReference(const Expression& expr, SourceRange range, const Symbol& symbol);
+
     Compilation& compilation;
 
     flat_hash_map<const SyntaxNode*, const Symbol*> symbolCache;
+
+    flat_hash_map<BufferID, BufferIndex> locationIndex;
+    flat_hash_map<const Symbol*, std::vector<const Expression*>> referenceIndex;
+    flat_hash_set<const Symbol*> indexedSymbols;
+    bool indexBuilt = false;
 };
 
 } // namespace slang
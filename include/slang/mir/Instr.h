@@ -42,7 +42,12 @@ ENUM(InstrKind, INSTR);
     x(flush) \
     x(printStr) \
     x(printInt) \
-    x(printFloat)
+    x(printFloat) \
+    x(fileOpen) \
+    x(fileClose) \
+    x(fileFlush) \
+    x(filePrintStr) \
+    x(filePrintInt)
 
 ENUM(SysCallKind, SYSCALL);
 #undef SYSCALL
@@ -181,9 +181,16 @@ private:
     Variant value;
 };
 
+/// Orders the keys of an associative array. This is the same ordering as the
+/// one given by ConstantValue's operator<, with a fast path for integral keys
+/// of matching type that fit in a single word, which is by far the most common case.
+struct AssociativeKeyLess {
+    bool operator()(const ConstantValue& lhs, const ConstantValue& rhs) const;
+};
+
 /// Represents a SystemVerilog associative array, for use during constant evaluation.
-struct AssociativeArray : public std::map<ConstantValue, ConstantValue> {
-    using std::map<ConstantValue, ConstantValue>::map;
+struct AssociativeArray : public std::map<ConstantValue, ConstantValue, AssociativeKeyLess> {
+    using std::map<ConstantValue, ConstantValue, AssociativeKeyLess>::map;
     ConstantValue defaultValue;
 };
 
@@ -383,6 +383,12 @@ public:
     /// Reverses the bit ordering of the number.
     [[nodiscard]] SVInt reverse() const;
 
+    /// Reverses the order of consecutive blocks of bits, as done by the streaming
+    /// operator. Blocks are taken starting from the least significant end; the first
+    /// one is @a firstBlockSize bits wide and the rest are @a blockSize bits wide,
+    /// except possibly the most significant block, which gets whatever bits remain.
+    [[nodiscard]] SVInt reverseBlocks(bitwidth_t blockSize, bitwidth_t firstBlockSize) const;
+
     SVInt& operator=(const SVInt& rhs) {
         if (isSingleWord() && rhs.isSingleWord()) {
             val = rhs.val;
@@ -126,6 +126,16 @@ public:
     /// Gets all macros that have been defined thus far in the preprocessor.
     std::vector<const DefineDirectiveSyntax*> getDefinedMacros() const;
 
+    /// Frees the memory used by the tokens that have been returned from @a next so far.
+    /// Definitions of the currently defined macros are copied over to fresh memory, which
+    /// then replaces the contents of the allocator passed to the constructor. Everything
+    /// else that was allocated from it, including previously returned tokens and the
+    /// results of getDefinedMacros, is invalidated. This lets callers that consume tokens
+    /// as they go, such as when printing preprocessed output, keep memory bounded.
+    /// @returns false, without freeing anything, if the preprocessor is holding on to
+    /// tokens of its own, such as the rest of a macro expansion.
+    bool releaseTokens();
+
 private:
     Preprocessor(const Preprocessor& other);
     Preprocessor& operator=(const Preprocessor& other) = delete;
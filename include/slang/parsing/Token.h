@@ -109,6 +109,11 @@ public:
     /// If the trivia represents skipped tokens, returns the list of tokens that were
     /// skipped. Otherwise returns an empty span.
     span<Token const> getSkippedTokens() const;
+
+    /// Moves raw source text trivia from buffer @a from into buffer @a to, adjusting its
+    /// offset by @a shift. This modifies the trivia in place; see Token::relocateInPlace.
+    /// @return false if the trivia has an explicit location in some other buffer.
+    bool relocateInPlace(const SourceBuffer& from, const SourceBuffer& to, ptrdiff_t shift);
 };
 static_assert(sizeof(Trivia) == 16);
 
@@ -178,6 +183,20 @@ public:
     [[nodiscard]] Token clone(BumpAllocator& alloc, span<Trivia const> trivia, string_view rawText,
                               SourceLocation location) const;
 
+    /// Moves the token, along with its trivia, from buffer @a from into buffer @a to by
+    /// modifying its data in place. Its location is adjusted by @a shift, and any text
+    /// that points into @a from is pointed at the same text in @a to instead. Anything
+    /// already in @a to is left alone, so moving a token into another buffer more than
+    /// once is harmless; when @a from and @a to are the same buffer (whose text has been
+    /// edited) each token must only be moved once.
+    ///
+    /// Tokens are otherwise immutable and freely shared, so this is only safe when the
+    /// caller owns all of the syntax that refers to the token. Directive and skipped
+    /// token trivia are not visited; callers need to walk those themselves.
+    /// @return false if the token is located in some buffer other than @a from or @a to,
+    /// such as the expansion of a macro.
+    bool relocateInPlace(const SourceBuffer& from, const SourceBuffer& to, ptrdiff_t shift);
+
     static Token createMissing(BumpAllocator& alloc, TokenKind kind, SourceLocation location);
     static Token createExpected(BumpAllocator& alloc, Diagnostics& diagnostics, Token actual,
                                 TokenKind expected, Token lastConsumed, Token matchingDelim);
@@ -7,11 +7,10 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include <string_view>
 #include <vector>
 
-#include "slang/util/Function.h"
-
 #define EXPORT extern "C"
 
 namespace slang::runtime {
@@ -25,7 +24,18 @@ ExportList getExportedFunctions();
 
 /// Sets a callback that will be invoked whenever the simulation outputs text.
 /// The callback can display that text however it likes. The string_view
-/// parameter is only valid for the duration of the callback.
-void setOutputHandler(function_ref<void(std::string_view)> handler);
+/// parameter is only valid for the duration of the callback. The callback is
+/// copied and kept until it's replaced by another call to this function.
+/// By default text is printed to stdout through stdio.
+///
+/// Output is buffered, so the callback is invoked with large chunks of text
+/// at a time rather than once per line, except when stdout is a terminal, in
+/// which case each line is handed off as soon as it's finished. Use
+/// @a flushOutput to force pending text to be handed off.
+void setOutputHandler(std::function<void(std::string_view)> handler);
+
+/// Hands off all buffered simulation output, both to the output handler
+/// and to any files that have been opened by the simulation.
+void flushOutput();
 
 } // namespace slang::runtime
\ No newline at end of file
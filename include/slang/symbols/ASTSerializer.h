@@ -23,9 +23,39 @@ class Symbol;
 class Type;
 class TimingControl;
 
+/// The output side of an ASTSerializer. The serializer produces a tree of
+/// objects, arrays, and scalar values, and implementations of this interface
+/// encode that tree in some particular format.
+class ASTWriter {
+public:
+    virtual ~ASTWriter() = default;
+
+    virtual void startObject() = 0;
+    virtual void endObject() = 0;
+    virtual void startArray() = 0;
+    virtual void endArray() = 0;
+    virtual void writeProperty(string_view name) = 0;
+    virtual void writeValue(string_view value) = 0;
+    virtual void writeValue(int64_t value) = 0;
+    virtual void writeValue(uint64_t value) = 0;
+    virtual void writeValue(double value) = 0;
+    virtual void writeValue(bool value) = 0;
+
+    /// Begins the object that describes the given symbol.
+    virtual void startSymbol(const Symbol&) { startObject(); }
+
+    /// Ends an object started via @a startSymbol.
+    virtual void endSymbol(const Symbol&) { endObject(); }
+
+    /// Writes a reference to another symbol. The @a text is a human readable
+    /// description of the target.
+    virtual void writeLink(const Symbol&, string_view text) { writeValue(text); }
+};
+
 class ASTSerializer {
 public:
     ASTSerializer(Compilation& compilation, JsonWriter& writer);
+    ASTSerializer(Compilation& compilation, ASTWriter& writer);
 
     void setIncludeAddresses(bool set) { includeAddrs = set; }
 
@@ -98,7 +128,8 @@ private:
     void visitInvalid(const BinsSelectExpr& expr);
 
     Compilation& compilation;
-    JsonWriter& writer;
+    std::unique_ptr<ASTWriter> jsonWriter;
+    ASTWriter& writer;
     bool includeAddrs = true;
 };
 
@@ -49,6 +49,9 @@ struct ASTDetectors {
 
     template<typename T, typename Arg>
     using visitStmts_t = decltype(std::declval<T>().visitStmts(std::declval<Arg>()));
+
+    template<typename T>
+    using split_t = decltype(std::declval<T>().trySplit(std::declval<const Symbol&>()));
 };
 
 /// Use this type as a base class for AST visitors. It will default to
@@ -86,12 +89,15 @@ public:
         }
 
         if constexpr (std::is_base_of_v<Scope, T>) {
-            for (auto& member : t.members())
-                member.visit(DERIVED);
+            for (auto& member : t.members()) {
+                if (member.kind != SymbolKind::GenerateBlock || !shouldSplit(member))
+                    member.visit(DERIVED);
+            }
         }
 
         if constexpr (std::is_same_v<InstanceSymbol, T>) {
-            t.body.visit(DERIVED);
+            if (!shouldSplit(t.body))
+                t.body.visit(DERIVED);
         }
     }
 
@@ -102,6 +108,18 @@ public:
     void visitInvalid(const AssertionExpr&) {}
     void visitInvalid(const BinsSelectExpr&) {}
 
+private:
+    // Visitors that support parallel traversal (see ParallelASTVisitor.h) can take
+    // ownership of visiting instance bodies and generate blocks by returning true here.
+    bool shouldSplit(const Symbol& symbol) {
+        if constexpr (is_detected_v<split_t, TDerived>)
+            return static_cast<TDerived*>(this)->trySplit(symbol);
+        else {
+            (void)symbol;
+            return false;
+        }
+    }
+
 #undef DERIVED
 };
 
@@ -0,0 +1,79 @@
+//------------------------------------------------------------------------------
+//! @file BinaryASTWriter.h
+//! @brief Support for writing the AST in a compact binary format
+//
+// File is under the MIT license; see LICENSE for details
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "slang/symbols/ASTSerializer.h"
+#include "slang/text/BinaryAST.h"
+#include "slang/util/Hash.h"
+
+namespace slang {
+
+/// An ASTWriter that produces the binary AST format described in BinaryAST.h.
+/// The body is built up in memory, since each object's size is only known once
+/// it's been finished; call @a finish to emit the complete file.
+class BinaryASTWriter : public ASTWriter {
+public:
+    void startObject() final;
+    void endObject() final;
+    void startArray() final;
+    void endArray() final;
+    void writeProperty(string_view name) final;
+    void writeValue(string_view value) final;
+    void writeValue(int64_t value) final;
+    void writeValue(uint64_t value) final;
+    void writeValue(double value) final;
+    void writeValue(bool value) final;
+
+    void startSymbol(const Symbol& symbol) final;
+    void endSymbol(const Symbol& symbol) final;
+    void writeLink(const Symbol& symbol, string_view text) final;
+
+    /// Writes out the complete file, including the string table, symbol
+    /// table, and scope index, by passing it in pieces to @a output.
+    void finish(function_ref<void(string_view)> output);
+
+private:
+    void startValue();
+    void startComposite(BinaryAST::Tag tag);
+    void endComposite();
+    void writeTag(BinaryAST::Tag tag);
+    uint32_t getStringId(string_view str);
+    uint32_t getSymbolId(const Symbol& symbol);
+
+    template<typename T>
+    void append(T value);
+
+    struct OpenComposite {
+        size_t sizeOffset;
+        uint32_t count;
+        bool isArray;
+    };
+
+    struct ScopeEntry {
+        uint32_t pathId;
+        uint32_t symbolId;
+    };
+
+    std::vector<char> body;
+    std::vector<OpenComposite> stack;
+    uint32_t numRoots = 0;
+
+    // Strings are stored in a deque so that the views used
+    // as map keys stay valid as more strings are added.
+    std::deque<std::string> strings;
+    flat_hash_map<string_view, uint32_t> stringIds;
+
+    flat_hash_map<const Symbol*, uint32_t> symbolIds;
+    std::vector<uint64_t> symbolOffsets;
+    std::vector<ScopeEntry> scopes;
+};
+
+} // namespace slang
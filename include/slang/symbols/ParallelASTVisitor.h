@@ -0,0 +1,119 @@
+//------------------------------------------------------------------------------
+//! @file ParallelASTVisitor.h
+//! @brief Parallel AST traversal
+//
+// File is under the MIT license; see LICENSE for details
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "slang/compilation/Compilation.h"
+#include "slang/symbols/ASTVisitor.h"
+#include "slang/util/ThreadPool.h"
+
+namespace slang {
+
+/// Use this type as a base class for AST visitors that can be run in parallel via
+/// ParallelASTVisitor. It works exactly like ASTVisitor when used on its own; when
+/// driven by a ParallelASTVisitor, instance bodies and generate blocks get handed
+/// off to be visited as separate tasks, possibly by a different visitor object.
+template<typename TDerived, bool VisitStatements, bool VisitExpressions>
+struct ParallelASTVisitorBase : public ASTVisitor<TDerived, VisitStatements, VisitExpressions> {
+    /// Called during traversal for each instance body and generate block.
+    /// @return true if the symbol will be visited by a separate task, in
+    /// which case the current traversal should skip over it.
+    bool trySplit(const Symbol& symbol) {
+        if (!spawner)
+            return false;
+
+        spawner(symbol);
+        return true;
+    }
+
+private:
+    template<typename>
+    friend class ParallelASTVisitor;
+
+    std::function<void(const Symbol&)> spawner;
+};
+
+/// Runs a visitor over an elaborated design using a pool of threads.
+///
+/// @a TVisitor must derive from ParallelASTVisitorBase. One visitor object is created
+/// for each thread that can run tasks (the pool's workers plus the thread that waits
+/// on it), and each visitor is only ever used by one thread at a time, so visitors can
+/// keep whatever state they want without locking. Every symbol, statement, and
+/// expression in the design is visited exactly once by one of the visitors; which one
+/// is up to the scheduler, so results should be combined with an order-independent
+/// reduction via @a reduce once the visit is done.
+///
+/// Before visiting a compilation, semantic diagnostics are collected for it (if that
+/// hasn't happened already). When that pass gets through the whole design it elaborates
+/// every scope and forces everything it touches: declared types and initializers,
+/// procedural block and subroutine bodies, port connections, and parameter values. After
+/// that the AST is only read during traversal. The pass can stop early, though, such as
+/// when the error limit is reached, and it doesn't force elements whose diagnostics were
+/// reused from another compilation; see Compilation::isFullyElaborated. In those cases
+/// the design is instead visited serially on the calling thread by the first visitor.
+///
+/// Visitors can evaluate expressions that have already been bound and check relations
+/// between types (the compilation's type relation cache and elaboration counters are
+/// thread safe). Visitors must not do anything that lazily creates or mutates symbols,
+/// such as performing new lookups or binding new expressions, and must not share mutable
+/// state with each other.
+template<typename TVisitor>
+class ParallelASTVisitor {
+public:
+    /// Creates the per-thread visitors, passing @a args to each one's constructor.
+    template<typename... Args>
+    explicit ParallelASTVisitor(ThreadPool& pool, const Args&... args) : pool(pool) {
+        for (uint32_t i = 0; i <= pool.getThreadCount(); i++) {
+            auto& visitor = visitors.emplace_back(std::make_unique<TVisitor>(args...));
+            visitor->spawner = [this](const Symbol& symbol) { spawn(symbol); };
+        }
+    }
+
+    /// Visits the entire design of the given compilation.
+    void visit(Compilation& compilation) {
+        compilation.getAllDiagnostics();
+        if (compilation.isFullyElaborated()) {
+            visit(compilation.getRoot());
+            return;
+        }
+
+        // Parts of the design may still be created lazily while they're visited,
+        // which isn't safe to do from more than one thread.
+        auto& visitor = *visitors[0];
+        auto spawner = std::exchange(visitor.spawner, nullptr);
+        compilation.getRoot().visit(visitor);
+        visitor.spawner = std::move(spawner);
+    }
+
+    /// Visits the given symbol and everything beneath it. Any lazily computed
+    /// parts of that subtree must already have been forced; see the class
+    /// documentation for details.
+    void visit(const Symbol& symbol) {
+        spawn(symbol);
+        pool.waitForAll();
+    }
+
+    /// Calls @a func with each of the per-thread visitors, in order.
+    template<typename TFunc>
+    void reduce(TFunc&& func) {
+        for (auto& visitor : visitors)
+            func(*visitor);
+    }
+
+private:
+    void spawn(const Symbol& symbol) {
+        pool.push([this, &symbol] { symbol.visit(*visitors[pool.getCurrentThreadIndex()]); });
+    }
+
+    ThreadPool& pool;
+    std::vector<std::unique_ptr<TVisitor>> visitors;
+};
+
+} // namespace slang
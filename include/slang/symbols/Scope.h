@@ -211,13 +211,29 @@ public:
 
     const SymbolMap& getNameMap() const {
         ensureElaborated();
-        return *nameMap;
+        return getUnelaboratedNameMap();
     }
 
-    const SymbolMap& getUnelaboratedNameMap() const { return *nameMap; }
+    const SymbolMap& getUnelaboratedNameMap() const {
+        return nameMap ? *nameMap : emptyNameMap;
+    }
 
     span<const WildcardImportSymbol* const> getWildcardImports() const;
 
+    /// A symbol that was found through one of the scope's wildcard imports.
+    struct WildcardImportMatch {
+        const Symbol* imported;
+        const WildcardImportSymbol* import;
+    };
+
+    /// Searches the wildcard imports in this scope that are visible from the given
+    /// location for symbols with the given name, appending any matches to @a results
+    /// in import order. The results of searching each import are remembered per name,
+    /// so later lookups only need to search imports not covered by earlier ones.
+    /// @returns true if any of the visible imports name a package that doesn't exist.
+    bool findWildcardImports(string_view name, LookupLocation location,
+                             SmallVector<WildcardImportMatch>& results) const;
+
 protected:
     Scope(Compilation& compilation_, const Symbol* thisSym_);
 
@@ -284,8 +300,24 @@ private:
         std::vector<const Symbol*> nameConflicts;
     };
 
-    // Sideband collection of wildcard imports stored in the Compilation object.
-    using ImportData = std::vector<const WildcardImportSymbol*>;
+    // The results of searching a scope's wildcard imports for a particular name.
+    struct ImportCacheEntry {
+        // Symbols found so far, along with the index of the import they came from.
+        std::vector<std::pair<uint32_t, const Symbol*>> found;
+
+        // The number of imports, in declaration order, that have been searched.
+        uint32_t numSearched = 0;
+
+        // The index of the first searched import whose package doesn't exist.
+        uint32_t firstMissing = UINT32_MAX;
+    };
+
+    // Sideband collection of wildcard imports stored in the Compilation object,
+    // along with the cached results of looking up names through them.
+    struct ImportData {
+        std::vector<const WildcardImportSymbol*> imports;
+        flat_hash_map<string_view, ImportCacheEntry> lookupCache;
+    };
 
     void insertMember(const Symbol* member, const Symbol* at, bool isElaborating,
                       bool incrementIndex) const;
@@ -310,7 +342,10 @@ private:
     const Symbol* thisSym;
 
     // The map of names to members that can be looked up within this scope.
-    SymbolMap* nameMap;
+    // Many scopes never have any named members, so this is only allocated
+    // once the first one is added.
+    mutable SymbolMap* nameMap = nullptr;
+    static const SymbolMap emptyNameMap;
 
     // A linked list of member symbols in the scope. These are mutable because a
     // scope might have only deferred members, and realization of deferred members
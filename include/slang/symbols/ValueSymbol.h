@@ -112,15 +112,25 @@ public:
 
     const Driver* getFirstDriver() const { return firstDriver; }
 
+    /// Collects the drivers of this value whose longest static prefix overlaps the given
+    /// range of its outermost dimension (for example, a range of bits in a packed vector
+    /// or of elements in an unpacked array). Drivers of the entire value are always
+    /// included, and drivers whose prefix could not be evaluated never are. The results
+    /// are in the order in which the drivers were added.
+    void getOverlappingDrivers(ConstantRange range, SmallVector<const Driver*>& results) const;
+
 protected:
     ValueSymbol(SymbolKind kind, string_view name, SourceLocation location,
                 bitmask<DeclaredTypeFlags> flags = DeclaredTypeFlags::None);
 
 private:
+    struct DriverIndex;
+
     void addDriverImpl(const Scope& scope, const Driver& driver) const;
 
     DeclaredType declaredType;
     mutable const Driver* firstDriver = nullptr;
+    mutable DriverIndex* driverIndex = nullptr;
 };
 
 } // namespace slang
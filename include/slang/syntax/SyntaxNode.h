@@ -320,4 +320,69 @@ SeparatedSyntaxList<T>::SeparatedSyntaxList(span<TokenOrSyntax> elements) :
     SyntaxListBase(SyntaxKind::SeparatedList, elements.size()), elements(elements) {
 }
 
+/// An interface for reconstructing syntax nodes from some external representation,
+/// such as a serialized syntax tree. SyntaxFactory::deserialize pulls the children
+/// of each node from the reader, in order, and then constructs the node from them.
+class SyntaxNodeReader {
+public:
+    virtual ~SyntaxNodeReader() = default;
+
+    /// Reads the next token, which may be empty if it was optional.
+    virtual Token readToken() = 0;
+
+    /// Reads the next node, which must be of type T.
+    template<typename T>
+    T& readRequired() {
+        return *static_cast<T*>(readNode(&T::isKind, false));
+    }
+
+    /// Reads the next node, which must either be null or of type T.
+    template<typename T>
+    T* readOptional() {
+        return static_cast<T*>(readNode(&T::isKind, true));
+    }
+
+    /// Reads a list of nodes of type T.
+    template<typename T>
+    SyntaxList<T> readList(BumpAllocator& alloc) {
+        size_t count = readListSize(SyntaxKind::SyntaxList);
+        SmallVectorSized<T*, 8> buffer(count);
+        for (size_t i = 0; i < count; i++)
+            buffer.append(&readRequired<T>());
+        return buffer.copy(alloc);
+    }
+
+    /// Reads a list of tokens.
+    TokenList readTokenList(BumpAllocator& alloc) {
+        size_t count = readListSize(SyntaxKind::TokenList);
+        SmallVectorSized<Token, 8> buffer(count);
+        for (size_t i = 0; i < count; i++)
+            buffer.append(readToken());
+        return buffer.copy(alloc);
+    }
+
+    /// Reads a list of nodes of type T separated by tokens.
+    template<typename T>
+    SeparatedSyntaxList<T> readSeparatedList(BumpAllocator& alloc) {
+        size_t count = readListSize(SyntaxKind::SeparatedList);
+        SmallVectorSized<TokenOrSyntax, 8> buffer(count);
+        for (size_t i = 0; i < count; i++) {
+            if (i % 2 == 0)
+                buffer.append(&readRequired<T>());
+            else
+                buffer.append(readToken());
+        }
+        return buffer.copy(alloc);
+    }
+
+protected:
+    /// Reads the next node, which must satisfy @a isKind. If @a optional is true
+    /// the node is allowed to be null.
+    virtual SyntaxNode* readNode(bool (*isKind)(SyntaxKind), bool optional) = 0;
+
+    /// Reads the header for a list of the given kind and returns the number of
+    /// children (including any separators) that follow it.
+    virtual size_t readListSize(SyntaxKind listKind) = 0;
+};
+
 } // namespace slang
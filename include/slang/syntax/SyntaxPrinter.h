@@ -6,6 +6,7 @@
 //------------------------------------------------------------------------------
 #pragma once
 
+#include <functional>
 #include <string>
 
 #include "slang/syntax/SyntaxNode.h"
@@ -86,6 +87,22 @@ public:
         return *this;
     }
 
+    /// Sets a callback that receives printed text as it is produced, instead of
+    /// accumulating all of it in the internal buffer. Text is handed to the callback
+    /// in chunks once at least @a chunkSize bytes have built up; call @a flush to
+    /// hand off whatever remains once printing is finished.
+    /// @return a reference to this object, to allow chaining additional method calls.
+    SyntaxPrinter& setOutput(std::function<void(string_view)> callback,
+                             size_t chunkSize = 64 * 1024) {
+        output = std::move(callback);
+        outputChunkSize = chunkSize;
+        return *this;
+    }
+
+    /// Hands off any pending text in the internal buffer to the output callback
+    /// set via @a setOutput. Does nothing if there is no output callback.
+    void flush();
+
     /// @return a copy of the internal text buffer.
     std::string str() const { return buffer; }
 
@@ -96,8 +113,12 @@ public:
 
 private:
     void append(string_view text);
+    bool endsWithNewline() const;
 
     std::string buffer;
+    std::function<void(string_view)> output;
+    size_t outputChunkSize = 0;
+    char lastFlushed = 0;
     const SourceManager* sourceManager = nullptr;
     bool includeTrivia = true;
     bool includeMissing = false;
@@ -85,9 +85,71 @@ public:
                                                    SourceManager& sourceManager,
                                                    const Bag& options = {});
 
+    /// Creates a new syntax tree by applying a text edit to an existing one.
+    /// @a tree is the tree to update, which must have been parsed from a single source buffer.
+    /// @a range is the range of text in that buffer that should be replaced.
+    /// @a text is the new text to put in place of @a range.
+    ///
+    /// Top-level members of the old tree that aren't touched by the edit are reused and
+    /// only the affected region of the text gets lexed and parsed again. If the edit
+    /// could change how the rest of the file gets preprocessed (for example by touching a
+    /// directive or macro usage) the entire file is parsed again instead.
+    ///
+    /// The resulting tree is loaded into a new source buffer and does not depend
+    /// on any of the memory of @a tree; reused members are copied over. That buffer
+    /// (along with a scratch buffer used to parse the affected region) belongs to the
+    /// new tree and is released by the source manager once the tree is destroyed.
+    /// @return the updated syntax tree.
+    static std::shared_ptr<SyntaxTree> reparse(const SyntaxTree& tree, SourceRange range,
+                                               string_view text);
+
+    /// Creates a new syntax tree by applying a text edit to an existing one, taking
+    /// ownership of the old tree. This works like the overload above, except that if
+    /// @a tree is the only remaining reference to the old tree, its memory is taken
+    /// over by the new tree and the reused members are updated in place instead of being
+    /// copied, which makes the cost of an edit mostly independent of its size.
+    ///
+    /// If the old tree's text is in a buffer that it got from an earlier reparse, the edit
+    /// is made to that buffer directly: tokens before the edit are left where they are and
+    /// those after it are shifted over, using a list of each member's tokens that the tree
+    /// keeps so that the syntax doesn't have to be walked again.
+    ///
+    /// Memory used by replaced members is only reclaimed once it adds up to as much as
+    /// the rest of the tree, at which point everything gets copied into a fresh tree.
+    /// @return the updated syntax tree.
+    static std::shared_ptr<SyntaxTree> reparse(std::shared_ptr<SyntaxTree>&& tree,
+                                               SourceRange range, string_view text);
+
+    /// Information about how a syntax tree was created by @a reparse.
+    struct ReparseStats {
+        /// The number of top-level members that were parsed again.
+        size_t membersParsed = 0;
+
+        /// The number of top-level members carried over from the old tree.
+        size_t membersReused = 0;
+
+        /// Set if the old tree's members were updated in place instead of being copied.
+        bool reusedInPlace = false;
+
+        /// Set if the edit was made to the old tree's source buffer
+        /// instead of copying its text into a new one.
+        bool bufferReused = false;
+
+        /// Set if the edit couldn't be applied incrementally
+        /// and the entire file was parsed again instead.
+        bool fullParse = false;
+    };
+
+    /// Gets information about how this tree was created by @a reparse,
+    /// or nullopt if it was created some other way.
+    const optional<ReparseStats>& getReparseStats() const { return reparseStats; }
+
     /// Gets any diagnostics generated while parsing.
     Diagnostics& diagnostics() { return diagnosticsBuffer; }
 
+    /// Gets any diagnostics generated while parsing.
+    const Diagnostics& diagnostics() const { return diagnosticsBuffer; }
+
     /// Gets the allocator containing the memory for the parse tree.
     BumpAllocator& allocator() { return alloc; }
 
@@ -127,6 +189,8 @@ public:
     static SourceManager& getDefaultSourceManager();
 
 private:
+    friend class SyntaxTreeCache;
+
     SyntaxTree(SyntaxNode* root, SourceManager& sourceManager, BumpAllocator&& alloc,
                Diagnostics&& diagnostics, Parser::Metadata&& metadata, Bag options, Token eof);
 
@@ -134,6 +198,42 @@ private:
                                               span<const SourceBuffer> source, const Bag& options,
                                               bool guess);
 
+    static std::shared_ptr<SyntaxTree> reparseImpl(const SyntaxTree& tree, SyntaxTree* owned,
+                                                   SourceRange range, string_view text);
+
+    // A source buffer that was created for the tree, which gets released along with it.
+    struct OwnedBuffer {
+        SourceManager* sourceManager = nullptr;
+        BufferID id;
+
+        OwnedBuffer() = default;
+        OwnedBuffer(SourceManager& sourceManager, BufferID id) :
+            sourceManager(&sourceManager), id(id) {}
+        OwnedBuffer(OwnedBuffer&& other) noexcept;
+        OwnedBuffer& operator=(OwnedBuffer&& other) noexcept;
+        ~OwnedBuffer();
+    };
+
+    // The tokens of one top-level member (or of the EndOfFile token), including the
+    // ones in its trivia, which lets reparse move the member around in its buffer.
+    struct MemberTokens {
+        std::vector<Token> tokens;
+
+        // Type names of the global instantiations within the member.
+        std::vector<Token> instances;
+
+        // Cleared if the member has tokens that can't be moved,
+        // such as ones from include files or macro expansions.
+        bool movable = true;
+
+        // Set if the member has directives that change the way
+        // the rest of the file is parsed, such as `timescale.
+        bool hasStateDirectives = false;
+    };
+
+    static MemberTokens collectTokens(const SyntaxNode& member, BufferID buffer);
+    static MemberTokens collectTokens(Token eof, BufferID buffer);
+
     SyntaxNode* rootNode;
     SourceManager& sourceMan;
     Parser::Metadata metadata;
@@ -142,6 +242,21 @@ private:
     Bag options_;
     std::shared_ptr<SyntaxTree> parentTree;
     Token eof;
+    optional<ReparseStats> reparseStats;
+
+    // The amount of memory the tree's allocator held the last time the tree was
+    // created from scratch, used to decide when edits have left behind enough
+    // unused memory to be worth copying everything into a fresh tree.
+    size_t compactedSize = 0;
+
+    // Buffers created by reparse for this tree; see @a OwnedBuffer.
+    OwnedBuffer textBuffer;
+    OwnedBuffer scratchBuffer;
+
+    // Tokens of each top-level member, followed by the EndOfFile token. This is built
+    // the first time the tree's members get moved in place, and kept up to date by
+    // each in-place reparse after that.
+    std::vector<MemberTokens> memberTokens;
 };
 
 } // namespace slang
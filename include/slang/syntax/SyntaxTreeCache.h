@@ -0,0 +1,70 @@
+//------------------------------------------------------------------------------
+//! @file SyntaxTreeCache.h
+//! @brief On-disk cache of parsed syntax trees
+//
+// File is under the MIT license; see LICENSE for details
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "slang/text/SourceLocation.h"
+#include "slang/util/Util.h"
+
+namespace slang {
+
+class Bag;
+class SourceManager;
+class SyntaxTree;
+class SyntaxTreeCache;
+
+/// Contains options for caching parsed syntax trees.
+struct SyntaxCacheOptions {
+    /// If set, syntax trees are looked up in this cache before being
+    /// parsed, and stored in it after being parsed.
+    SyntaxTreeCache* cache = nullptr;
+};
+
+/// A cache of parsed syntax trees that persists across runs of the tool by
+/// storing them in a directory on disk. Trees are stored in a compact binary
+/// form that includes all of their nodes, tokens, trivia, and parser metadata,
+/// keyed by a hash of the source text along with the lexer, preprocessor, and
+/// parser options (which include any predefined macros). Each entry also records
+/// the contents of every file that was included while parsing; if any of those
+/// have changed the entry is ignored.
+///
+/// Trees that produced diagnostics, or whose preprocessing had side effects on
+/// the source manager beyond loading files and expanding macros (such as `line
+/// directives and diagnostic pragmas), are not cached.
+class SyntaxTreeCache {
+public:
+    explicit SyntaxTreeCache(std::string directory);
+
+    /// Attempts to load a tree for the given source buffers from the cache.
+    /// @return the loaded tree, or nullptr if there was no valid cache entry.
+    std::shared_ptr<SyntaxTree> load(SourceManager& sourceManager,
+                                     span<const SourceBuffer> sources, const Bag& options);
+
+    /// Stores a tree that was parsed from the given source buffers in the cache,
+    /// if it's eligible to be cached.
+    void store(const SyntaxTree& tree, span<const SourceBuffer> sources);
+
+    /// @return the number of trees that were successfully loaded from the cache.
+    uint64_t getNumHits() const { return numHits; }
+
+    /// @return the number of trees that had to be parsed because they were
+    /// not present in the cache.
+    uint64_t getNumMisses() const { return numMisses; }
+
+private:
+    std::string getPath(span<const SourceBuffer> sources, const Bag& options) const;
+
+    std::string directory;
+
+    std::atomic<uint64_t> numHits = 0;
+    std::atomic<uint64_t> numMisses = 0;
+};
+
+} // namespace slang
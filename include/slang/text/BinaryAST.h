@@ -0,0 +1,204 @@
+//------------------------------------------------------------------------------
+//! @file BinaryAST.h
+//! @brief Binary AST export format and reader
+//
+// File is under the MIT license; see LICENSE for details
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+
+#include "slang/util/Function.h"
+#include "slang/util/Util.h"
+
+namespace slang {
+
+/// The binary AST format is a compact alternative to JSON output that can be
+/// memory mapped and navigated without parsing the whole thing. All integers
+/// and doubles are stored little-endian, whatever the byte order of the host
+/// that wrote them, and unaligned. The file is laid out as:
+///
+/// - A fixed size header (see BinaryAST::Header) that holds offsets to each of
+///   the following sections.
+/// - The body, a sequence of root values. Each value is a one byte tag followed
+///   by a tag-specific payload. Objects and arrays are prefixed with their size
+///   in bytes so that readers can skip over them without looking inside.
+/// - The string table. All strings, including property names, are interned and
+///   referred to by index.
+/// - The symbol table, which maps symbol IDs to the offset of the symbol's
+///   object in the body, or zero if the symbol was only referenced and never
+///   serialized itself.
+/// - The scope index, a list of instance paths and their symbol IDs sorted by
+///   path, allowing a reader to jump straight to a given instance.
+namespace BinaryAST {
+
+constexpr char Magic[8] = { 'S', 'L', 'A', 'N', 'G', 'A', 'S', 'T' };
+constexpr uint32_t Version = 1;
+
+/// Identifies the kind of each value in the body.
+///
+/// Payloads are as follows:
+/// - Object: u64 size, then { u32 name string ID, value } pairs
+/// - Symbol: u64 size, u32 symbol ID, then pairs as for Object
+/// - Array: u64 size, u32 element count, then the elements
+/// - String: u32 string ID
+/// - Int / UInt / Double: 8 byte value
+/// - True / False: no payload
+/// - Link: u32 symbol ID, u32 string ID of the link text
+///
+/// Sizes count the bytes following the size field itself.
+enum class Tag : uint8_t { Object = 1, Symbol, Array, String, Int, UInt, Double, True, False, Link };
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t numRoots;
+    uint64_t bodyOffset;
+    uint64_t stringTableOffset;
+    uint64_t symbolTableOffset;
+    uint64_t scopeIndexOffset;
+};
+
+static_assert(sizeof(Header) == 48);
+
+/// Converts a value between host byte order and the little-endian order used
+/// in the file. The conversion is its own inverse, so it's used for both reading
+/// and writing, and it does nothing on little-endian hosts.
+template<typename T>
+T littleEndian(T value) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    char bytes[sizeof(T)];
+    memcpy(bytes, &value, sizeof(T));
+    std::reverse(bytes, bytes + sizeof(T));
+    memcpy(&value, bytes, sizeof(T));
+#endif
+    return value;
+}
+
+/// Converts all of the integer fields of a header between host byte order and
+/// file byte order, as with @a littleEndian.
+inline Header littleEndian(Header header) {
+    header.version = littleEndian(header.version);
+    header.numRoots = littleEndian(header.numRoots);
+    header.bodyOffset = littleEndian(header.bodyOffset);
+    header.stringTableOffset = littleEndian(header.stringTableOffset);
+    header.symbolTableOffset = littleEndian(header.symbolTableOffset);
+    header.scopeIndexOffset = littleEndian(header.scopeIndexOffset);
+    return header;
+}
+
+} // namespace BinaryAST
+
+class BinaryASTReader;
+
+/// A reference to a single value inside of a binary AST file.
+/// These are cheap to copy; they just point into the reader's data.
+class BinaryASTValue {
+public:
+    BinaryAST::Tag getTag() const;
+
+    bool isObject() const;
+    bool isArray() const { return getTag() == BinaryAST::Tag::Array; }
+    bool isString() const { return getTag() == BinaryAST::Tag::String; }
+    bool isLink() const { return getTag() == BinaryAST::Tag::Link; }
+
+    string_view getString() const;
+    int64_t getInt() const;
+    uint64_t getUInt() const;
+    double getDouble() const;
+    bool getBool() const;
+
+    /// Gets the ID of the symbol for a Symbol object or the target of a Link.
+    uint32_t getSymbolId() const;
+
+    /// Gets the human readable text of a Link value.
+    string_view getLinkText() const;
+
+    /// Looks up the property with the given name in an object.
+    /// @return the property value, or nullopt if there is no such property.
+    optional<BinaryASTValue> find(string_view name) const;
+
+    /// Invokes @a callback for each property of an object, in order.
+    void forEachProperty(function_ref<void(string_view, BinaryASTValue)> callback) const;
+
+    /// @return the number of elements in an array.
+    uint32_t size() const;
+
+    /// Invokes @a callback for each element of an array, in order.
+    void forEachElement(function_ref<void(BinaryASTValue)> callback) const;
+
+    /// @return the offset of this value within the file.
+    size_t getOffset() const { return offset; }
+
+private:
+    friend class BinaryASTReader;
+
+    BinaryASTValue(const BinaryASTReader& reader, size_t offset) :
+        reader(&reader), offset(offset) {}
+
+    size_t getEnd() const;
+    size_t getPayload() const { return offset + 1; }
+    size_t getFirstProperty() const;
+    void expect(BinaryAST::Tag tag) const;
+
+    const BinaryASTReader* reader;
+    size_t offset;
+};
+
+/// Reads binary AST files produced by BinaryASTWriter. The reader doesn't copy
+/// the data it's given, so the caller can hand it a memory mapped file and only
+/// the parts that are actually visited will be paged in.
+///
+/// Malformed input results in a std::runtime_error being thrown.
+class BinaryASTReader {
+public:
+    /// Constructs a reader over the given file contents, which must remain
+    /// valid for as long as the reader and any values obtained from it are used.
+    explicit BinaryASTReader(span<const char> data);
+
+    /// @return the number of top level values written to the file.
+    uint32_t getNumRoots() const { return header.numRoots; }
+
+    /// @return the root value with the given index.
+    BinaryASTValue getRoot(uint32_t index) const;
+
+    /// @return the number of strings in the string table.
+    uint32_t getNumStrings() const { return numStrings; }
+
+    /// @return the string with the given ID.
+    string_view getString(uint32_t id) const;
+
+    /// @return the number of distinct symbols that were written or referenced.
+    uint32_t getNumSymbols() const { return numSymbols; }
+
+    /// Finds the object for the given symbol ID.
+    /// @return the symbol's object, or nullopt if it was never serialized.
+    optional<BinaryASTValue> findSymbol(uint32_t id) const;
+
+    /// @return the number of entries in the scope index.
+    uint32_t getNumScopes() const { return numScopes; }
+
+    /// @return the hierarchical path of the scope index entry with the given index.
+    string_view getScopePath(uint32_t index) const;
+
+    /// Finds an instance by its full hierarchical path, using the scope index.
+    /// @return the instance's object, or nullopt if no such instance was serialized.
+    optional<BinaryASTValue> findScope(string_view path) const;
+
+private:
+    friend class BinaryASTValue;
+
+    template<typename T>
+    T read(size_t offset) const;
+
+    void check(bool condition) const;
+
+    span<const char> data;
+    BinaryAST::Header header;
+    uint32_t numStrings = 0;
+    uint32_t numSymbols = 0;
+    uint32_t numScopes = 0;
+};
+
+} // namespace slang
@@ -6,6 +6,11 @@
 //------------------------------------------------------------------------------
 #pragma once
 
+#include <functional>
+#include <string>
+#include <variant>
+#include <vector>
+
 #include "slang/util/Util.h"
 
 namespace slang {
@@ -31,7 +36,21 @@ public:
     /// and indentation are added to make the output more human friendly.
     void setPrettyPrint(bool enabled) { pretty = enabled; }
 
-    /// @return a view of the emitted JSON text so far.
+    /// Sets a callback that receives the emitted JSON text as it is produced,
+    /// instead of accumulating the whole document in memory. Text is handed off
+    /// in chunks of roughly @a chunkSize bytes; call @a flush once writing is
+    /// finished to hand off whatever remains.
+    void setOutput(std::function<void(string_view)> callback, size_t chunkSize = 64 * 1024) {
+        output = std::move(callback);
+        outputChunkSize = chunkSize;
+    }
+
+    /// Hands off any pending text to the output callback set via @a setOutput.
+    /// Does nothing if there is no output callback.
+    void flush();
+
+    /// @return a view of the emitted JSON text so far. If an output callback
+    /// has been set this only includes text that hasn't been handed off yet.
     /// @note the returned view is not guaranteed to remain valid once
     /// additional writes are performed.
     string_view view() const;
@@ -71,16 +90,86 @@ public:
     /// Writes an array or property boolean value ("true" or "false").
     void writeValue(bool value);
 
+    /// Writes an array or property null value.
+    void writeNull();
+
 private:
+    void startValue();
     void endValue();
-    size_t findLastComma() const;
+    void writeNewline();
     void writeQuoted(string_view str);
 
     std::unique_ptr<FormatBuffer> buffer;
+    std::function<void(string_view)> output;
+    size_t outputChunkSize = 0;
 
     int currentIndent = 0;
     int indentSize = 2;
+    int depth = 0;
     bool pretty = false;
+    bool needComma = false;
+    bool afterProperty = false;
+};
+
+/// A very lightweight JSON value, along with a parser to produce one from text.
+///
+/// This is intended for reading small documents, such as requests sent to
+/// a long running tool; it favors simplicity over speed. Object properties
+/// are kept in the order in which they appear in the source text.
+class JsonValue {
+public:
+    /// The various kinds of JSON values.
+    enum class Kind { Null, Boolean, Number, String, Array, Object };
+
+    using Array = std::vector<JsonValue>;
+    using Object = std::vector<std::pair<std::string, JsonValue>>;
+
+    JsonValue() = default;
+    JsonValue(bool value) : value(value) {}
+    JsonValue(double value) : value(value) {}
+    JsonValue(std::string value) : value(std::move(value)) {}
+    JsonValue(Array value) : value(std::move(value)) {}
+    JsonValue(Object value) : value(std::move(value)) {}
+
+    /// Parses the given text as a single JSON value.
+    /// @throws std::runtime_error if the text is not valid JSON.
+    static JsonValue parse(string_view text);
+
+    /// Gets the kind of value this is.
+    Kind kind() const { return Kind(value.index()); }
+
+    bool isNull() const { return kind() == Kind::Null; }
+    bool isBoolean() const { return kind() == Kind::Boolean; }
+    bool isNumber() const { return kind() == Kind::Number; }
+    bool isString() const { return kind() == Kind::String; }
+    bool isArray() const { return kind() == Kind::Array; }
+    bool isObject() const { return kind() == Kind::Object; }
+
+    /// Gets the value as a boolean. The value must be of that kind.
+    bool getBoolean() const { return std::get<bool>(value); }
+
+    /// Gets the value as a number. The value must be of that kind.
+    double getNumber() const { return std::get<double>(value); }
+
+    /// Gets the value as a string. The value must be of that kind.
+    const std::string& getString() const { return std::get<std::string>(value); }
+
+    /// Gets the value as an array. The value must be of that kind.
+    const Array& getArray() const { return std::get<Array>(value); }
+
+    /// Gets the value as an object. The value must be of that kind.
+    const Object& getObject() const { return std::get<Object>(value); }
+
+    /// Looks up a property by name, if this value is an object.
+    /// @return the value of the property, or nullptr if there is no such
+    /// property or this value isn't an object.
+    const JsonValue* find(string_view name) const;
+
+    /// Writes the value out to the given JSON writer.
+    void write(JsonWriter& writer) const;
+
+private:
+    std::variant<std::nullptr_t, bool, double, std::string, Array, Object> value;
 };
 
 } // namespace slang
\ No newline at end of file
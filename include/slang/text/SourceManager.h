@@ -59,6 +59,10 @@ public:
     /// into account any `line directives that may be in the file.
     string_view getRawFileName(BufferID buffer) const;
 
+    /// Gets the full path of the file that was loaded into the given buffer.
+    /// Returns an empty path if the buffer wasn't loaded from a file.
+    fs::path getFullPath(BufferID buffer) const;
+
     /// Gets the column line number for a given source location.
     /// @a location must be a file location.
     size_t getColumnNumber(SourceLocation location) const;
@@ -141,6 +145,45 @@ public:
     /// Returns true if the given file path is already loaded and cached in the source manager.
     bool isCached(const fs::path& path) const;
 
+    /// Gets the IDs of all buffers that have been loaded from files or assigned from text,
+    /// in the order in which they were created. Macro expansion buffers are not included.
+    std::vector<BufferID> getAllBuffers() const;
+
+    /// Removes the given file path from the cache of loaded files, so that the next
+    /// time it's requested it will be read from disk again. Buffers that have already
+    /// been created for the file remain valid until @a releaseRemovedFiles is called.
+    /// @return true if the file was in the cache, and false otherwise.
+    bool removeCachedFile(const fs::path& path);
+
+    /// Frees the memory held by files that were removed with @a removeCachedFile.
+    /// Buffers that were created for those files are left behind without any text
+    /// or file name, so the caller must make sure that nothing (such as a syntax tree
+    /// or a diagnostic) still refers to them, and that no other thread is using
+    /// the source manager at the same time.
+    /// @return the number of files that were released.
+    size_t releaseRemovedFiles();
+
+    /// Replaces @a length characters of the text in @a buffer, starting at @a offset, with
+    /// @a text, reusing the buffer instead of assigning a new one. This is only meant for
+    /// buffers that were created by @a assignText or @a assignBuffer and that belong to a
+    /// single client, such as a syntax tree that is being edited, since locations past the
+    /// start of the edit no longer refer to the same text afterwards.
+    ///
+    /// The text before the edit stays where it is in memory unless the buffer has to grow,
+    /// in which case all of it gets moved; the returned SourceBuffer points at the new text.
+    /// Line and diagnostic directives that were added for the buffer are left as they are.
+    /// Nothing else may be using the buffer while it's being edited.
+    /// @return the updated buffer, or an empty buffer if @a buffer doesn't hold any text.
+    SourceBuffer replaceText(BufferID buffer, size_t offset, size_t length, string_view text);
+
+    /// Frees the memory held by a buffer that was created by @a assignText or
+    /// @a assignBuffer once it's no longer needed. Like the buffers released by
+    /// @a releaseRemovedFiles, it is left behind without any text or file name,
+    /// so the caller must make sure that nothing still refers to it. Any other
+    /// buffers that share the same text are released along with it.
+    /// @return true if the buffer was released, and false if it didn't hold any text.
+    bool releaseBuffer(BufferID buffer);
+
     /// Sets whether filenames should be made "proximate" to the current directory
     /// for diagnostic reporting purposes. This is on by default but can be
     /// disabled to always use the simple filename.
@@ -196,7 +239,7 @@ private:
     // Stores actual file contents and metadata; only one per loaded file
     struct FileData {
         const std::string name;          // name of the file
-        const std::vector<char> mem;     // file contents
+        std::vector<char> mem;           // file contents
         std::vector<size_t> lineOffsets; // cache of compute line offsets
         const fs::path* const directory; // directory in which the file exists
 
@@ -252,6 +295,10 @@ private:
     // cache for file lookups; this holds on to the actual file data
     std::unordered_map<std::string, std::unique_ptr<FileData>> lookupCache;
 
+    // file data that has been removed from the lookup cache but may still be
+    // referenced by existing buffers
+    std::vector<std::unique_ptr<FileData>> retiredFiles;
+
     // directories for system and user includes
     std::vector<fs::path> systemDirectories;
     std::vector<fs::path> userDirectories;
@@ -50,17 +50,75 @@ public:
     /// The other allocator will be in a moved-from state after the call.
     void steal(BumpAllocator&& other);
 
+    /// Frees everything that has been allocated so far, making the memory available for
+    /// new allocations. Segments obtained from the system are kept around for reuse
+    /// instead of being released, which makes this much cheaper than destroying the
+    /// allocator and creating a new one. Any previously allocated memory becomes invalid.
+    void reset();
+
+    /// Sets whether the largest segments should be backed by huge pages, on platforms
+    /// that support it. This can reduce TLB pressure for very large compilations.
+    /// It only affects segments allocated after the call.
+    void setUseHugePages(bool enabled) { useHugePages = enabled; }
+
+    /// Statistics about the memory used by an allocator.
+    struct Stats {
+        /// The number of bytes handed out by the allocator, including alignment padding.
+        size_t bytesAllocated = 0;
+
+        /// The number of bytes obtained from the system, including memory kept
+        /// around for reuse after calling @a reset.
+        size_t bytesReserved = 0;
+
+        /// The number of bytes left unused at the ends of segments that the
+        /// allocator has moved on from.
+        size_t bytesWasted = 0;
+
+        /// The number of segments obtained from the system.
+        size_t segmentCount = 0;
+
+        Stats& operator+=(const Stats& other);
+    };
+
+    /// Computes statistics about the memory used by the allocator. This walks over
+    /// all of the allocator's segments so it shouldn't be called in a hot path.
+    Stats getStats() const;
+
+    /// Gets the number of bytes handed out by the allocator so far. This is the
+    /// same as the @a bytesAllocated field of @a getStats but is cheap to call.
+    size_t getBytesAllocated() const {
+        return retiredBytes + size_t(head->current - (byte*)(head + 1));
+    }
+
 protected:
-    // Allocations are tracked as a linked list of segments.
+    // Allocations are tracked as a linked list of segments. Segments that hold
+    // a single large allocation don't bump their current pointer.
     struct Segment {
         Segment* prev;
         byte* current;
+        size_t size;
+        bool isLarge;
     };
 
     Segment* head;
     byte* endPtr;
 
-    enum { INITIAL_SIZE = 512, SEGMENT_SIZE = 4096 };
+    // Segments that have been kept for reuse by @a reset.
+    Segment* freeList = nullptr;
+
+    // The number of bytes handed out from segments other than the head.
+    size_t retiredBytes = 0;
+
+    // The size of the next segment to get from the system; this grows geometrically
+    // so that big allocators make fewer, larger requests.
+    size_t nextSegmentSize = SEGMENT_SIZE;
+    bool useHugePages = false;
+
+    enum : size_t {
+        INITIAL_SIZE = 512,
+        SEGMENT_SIZE = 4096,
+        MAX_SEGMENT_SIZE = 2 * 1024 * 1024
+    };
 
     // Slow path handling of allocation.
     byte* allocateSlow(size_t size, size_t alignment);
@@ -70,7 +128,8 @@ protected:
                                        ~(alignment - 1));
     }
 
-    static Segment* allocSegment(Segment* prev, size_t size);
+    Segment* allocSegment(Segment* prev, size_t size, bool isLarge = false);
+    static void freeSegments(Segment* seg);
 };
 
 /// A strongly-typed version of the BumpAllocator, which has the additional
@@ -81,7 +140,23 @@ class TypedBumpAllocator : public BumpAllocator {
 public:
     TypedBumpAllocator() = default;
     TypedBumpAllocator(TypedBumpAllocator&& other) noexcept : BumpAllocator(std::move(other)) {}
-    ~TypedBumpAllocator() {
+    ~TypedBumpAllocator() { destroyAll(); }
+
+    /// Construct a new item using the allocator.
+    template<typename... Args>
+    T* emplace(Args&&... args) {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    /// Destroys all of the items in the allocator and makes
+    /// the memory available for reuse. See BumpAllocator::reset.
+    void reset() {
+        destroyAll();
+        BumpAllocator::reset();
+    }
+
+private:
+    void destroyAll() {
         Segment* seg = head;
         while (seg) {
             for (T* cur = (T*)(seg + 1); cur != (T*)seg->current; cur++)
@@ -89,12 +164,6 @@ public:
             seg = seg->prev;
         }
     }
-
-    /// Construct a new item using the allocator.
-    template<typename... Args>
-    T* emplace(Args&&... args) {
-        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
-    }
 };
 
 } // namespace slang
@@ -34,6 +34,17 @@ public:
     /// Note that the buffer will be null-terminated.
     static bool readFile(const std::filesystem::path& path, std::vector<char>& buffer);
 
+    /// @return the full path of the currently running executable, or an empty path
+    /// if it can't be determined on this platform.
+    static std::filesystem::path getExecutablePath();
+
+    /// Runs the program named by the first element of @a args, passing the remaining
+    /// elements as its arguments, and waits for it to finish. The program is searched
+    /// for in the PATH if it isn't given as a path. Arguments are passed through as-is,
+    /// without going through a shell.
+    /// @return the exit code of the program, or -1 if it could not be run.
+    static int runProcess(const std::vector<std::string>& args);
+
 #if defined(_MSC_VER)
     /// Prints formatted text to stdout, handling Unicode conversions where necessary.
     template<typename... Args>
@@ -0,0 +1,88 @@
+//------------------------------------------------------------------------------
+//! @file ThreadPool.h
+//! @brief Work-stealing pool of worker threads
+//
+// File is under the MIT license; see LICENSE for details
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "slang/util/Util.h"
+
+namespace slang {
+
+/// A pool of worker threads that run submitted tasks.
+///
+/// Each worker has its own queue of tasks. Tasks submitted from within a worker
+/// go on that worker's queue, and are taken from the back so that recently spawned
+/// (and usually smaller) pieces of work run first. Idle workers steal from the
+/// front of other workers' queues.
+///
+/// The thread that calls @a waitForAll helps run tasks until all of them have
+/// finished, so a pool created with zero threads runs everything on the caller.
+/// Only one thread should wait on a given pool at a time.
+class ThreadPool {
+public:
+    /// Creates a pool with the given number of worker threads. If @a numThreads
+    /// is zero, all tasks run on the thread that calls @a waitForAll.
+    explicit ThreadPool(uint32_t numThreads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// Gets the number of worker threads in the pool.
+    uint32_t getThreadCount() const { return uint32_t(threads.size()); }
+
+    /// Submits a task to be run by the pool. This can be called from within
+    /// a running task to spawn additional work.
+    void push(std::function<void()> task);
+
+    /// Waits for all submitted tasks (including any that they spawn) to finish,
+    /// running tasks on the calling thread in the meantime. If any task threw an
+    /// exception, the first one is rethrown here once everything is done.
+    void waitForAll();
+
+    /// Gets the index of the pool worker running on the current thread, or the
+    /// thread count of the pool if the current thread isn't one of its workers
+    /// (such as the thread calling @a waitForAll). This is useful for indexing
+    /// per-thread state, which needs getThreadCount() + 1 slots.
+    uint32_t getCurrentThreadIndex() const;
+
+    /// Gets the number of hardware threads available, or 1 if it can't be determined.
+    static uint32_t getHardwareThreads();
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool tryRunOne(uint32_t self);
+    void runTask(std::function<void()>& task);
+    void workerMain(uint32_t index);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> threads;
+
+    std::mutex sleepMutex;
+    std::condition_variable sleepCond;
+    std::atomic<size_t> queuedTasks = 0;
+    std::atomic<size_t> pendingTasks = 0;
+    std::atomic<uint32_t> nextQueue = 0;
+    bool stopping = false;
+
+    std::mutex errorMutex;
+    std::exception_ptr firstError;
+};
+
+} // namespace slang
@@ -236,6 +236,50 @@ namespace slang {
         cppf.write('    return *alloc.emplace<{}>({});\n'.format(k, argNames))
         cppf.write('}\n\n')
 
+    # Write out the deserialization method, which reads the children of a node
+    # in the same order as its constructor arguments.
+    outf.write('\n')
+    outf.write('    /// Creates a node of the given kind, pulling each of its children in order from @a reader.\n')
+    outf.write('    SyntaxNode* deserialize(SyntaxKind kind, SyntaxNodeReader& reader);\n')
+
+    cppf.write('SyntaxNode* SyntaxFactory::deserialize(SyntaxKind kind, SyntaxNodeReader& reader) {\n')
+    cppf.write('    switch (kind) {\n')
+
+    kindsByType = {}
+    for k,v in sorted(kindmap.items()):
+        kindsByType.setdefault(v, []).append(k)
+
+    for k,kinds in sorted(kindsByType.items()):
+        v = alltypes[k]
+        for kind in kinds:
+            cppf.write('        case SyntaxKind::{}:'.format(kind))
+            cppf.write(' {\n' if kind == kinds[-1] else '\n')
+
+        for m in v.processedMembers:
+            space = m.index(' ')
+            typename = m[:space]
+            name = m[space + 1:]
+            if typename == 'Token':
+                cppf.write('            auto {} = reader.readToken();\n'.format(name))
+            elif typename == 'TokenList':
+                cppf.write('            auto {} = reader.readTokenList(alloc);\n'.format(name))
+            elif typename.startswith('SyntaxList<'):
+                cppf.write('            auto {} = reader.readList<{}>(alloc);\n'.format(name, typename[11:-1]))
+            elif typename.startswith('SeparatedSyntaxList<'):
+                cppf.write('            auto {} = reader.readSeparatedList<{}>(alloc);\n'.format(name, typename[20:-1]))
+            elif typename.endswith('*'):
+                cppf.write('            auto {} = reader.readOptional<{}>();\n'.format(name, typename[:-1]))
+            else:
+                cppf.write('            auto& {} = reader.readRequired<{}>();\n'.format(name, typename[:-1]))
+
+        cppf.write('            return alloc.emplace<{}>({});\n'.format(k, ', '.join(v.argNames)))
+        cppf.write('        }\n')
+
+    cppf.write('        default:\n')
+    cppf.write('            return nullptr;\n')
+    cppf.write('    }\n')
+    cppf.write('}\n\n')
+
     cppf.write('''
 std::ostream& operator<<(std::ostream& os, SyntaxKind kind) {
     os << toString(kind);
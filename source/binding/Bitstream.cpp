@@ -289,11 +289,13 @@ static SVInt slicePacked(PackIterator& iter, const PackIterator iterEnd, bitwidt
         return SVInt(width, 0, false); // filling with zero bits on the right
     }
 
-    ConstantValue cp = **iter;
-    if (cp.isString())
-        cp = cp.convertToInt();
+    // Strings need converting; integers can be sliced in place without
+    // copying the (potentially very wide) source element.
+    ConstantValue converted;
+    if ((*iter)->isString())
+        converted = (*iter)->convertToInt();
 
-    auto& ci = cp.integer();
+    const SVInt& ci = converted ? converted.integer() : (*iter)->integer();
     ASSERT(bit < ci.getBitWidth());
     bitwidth_t msb = ci.getBitWidth() - bit - 1;
     bitwidth_t lsb = std::min(bit + width, ci.getBitWidth());
@@ -307,11 +309,28 @@ static SVInt slicePacked(PackIterator& iter, const PackIterator iterEnd, bitwidt
     }
 
     if (lsb == 0 && msb == ci.getBitWidth() - 1)
-        return std::move(ci);
+        return ci;
 
     return ci.slice(static_cast<int32_t>(msb), static_cast<int32_t>(lsb));
 }
 
+/// Concatenates a packed bit-stream into a single integer. The caller must ensure
+/// the total width fits within SVInt::MAX_BITS.
+static SVInt flattenPacked(span<ConstantValue* const> packed) {
+    if (packed.size() == 1 && packed[0]->isInteger())
+        return std::move(packed[0]->integer());
+
+    SmallVectorSized<SVInt, 8> buffer;
+    for (auto cv : packed) {
+        if (cv->isString())
+            buffer.emplace(cv->convertToInt().integer());
+        else
+            buffer.emplace(std::move(cv->integer()));
+    }
+
+    return SVInt::concat(buffer);
+}
+
 /// Performs unpack operation on a bit-stream.
 static ConstantValue unpackBitstream(const Type& type, PackIterator& iter,
                                      const PackIterator iterEnd, bitwidth_t& bit,
@@ -564,6 +583,30 @@ ConstantValue Bitstream::reOrder(ConstantValue&& value, size_t sliceSize, size_t
     if (packed.empty())
         return std::move(value);
 
+    if (totalWidth <= SVInt::MAX_BITS) {
+        // Fast path: flatten the whole stream into one integer and reverse the
+        // blocks in place, rather than slicing out and collecting each block.
+        auto flat = flattenPacked(packed);
+        flat.setSigned(false);
+
+        size_t firstBlock = sliceSize;
+        if (unpackWidth) {
+            if (unpackWidth < totalWidth) { // left-aligned so trim rightmost
+                flat = flat.slice(static_cast<int32_t>(totalWidth - 1),
+                                  static_cast<int32_t>(totalWidth - unpackWidth));
+            }
+
+            // For unpack, a partial block comes first instead of last.
+            if (unpackWidth % sliceSize)
+                firstBlock = unpackWidth % sliceSize;
+        }
+
+        std::vector<ConstantValue> result;
+        result.emplace_back(flat.reverseBlocks(static_cast<bitwidth_t>(sliceSize),
+                                               static_cast<bitwidth_t>(firstBlock)));
+        return result;
+    }
+
     size_t rightIndex = packed.size() - 1; // Right-to-left
     bitwidth_t rightWidth = static_cast<bitwidth_t>(packed.back()->bitstreamWidth());
     size_t extraBits = 0;
@@ -91,6 +91,7 @@ LValue* EvalContext::getTopLValue() const {
 }
 
 bool EvalContext::step(SourceLocation loc) {
+    compilation.noteEvalStep();
     if (++steps < compilation.getOptions().maxConstexprSteps)
         return true;
 
@@ -346,6 +346,7 @@ const Expression& Expression::bindSelector(Expression& value, const ElementSelec
 }
 
 ConstantValue Expression::eval(EvalContext& context) const {
+    Compilation::ConstEvalTimer timer(context.compilation);
     EvalVisitor visitor;
     return visit(visitor, context);
 }
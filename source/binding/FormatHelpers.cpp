@@ -366,16 +366,58 @@ optional<std::string> FmtHelpers::formatDisplay(const Scope& scope, EvalContext&
     return result;
 }
 
-static void lowerFormatArg(mir::Procedure& proc, const Expression& arg, char,
+namespace {
+
+// Emits the runtime calls for printing lowered values, either to stdout
+// or to a specific file descriptor.
+struct PrintEmitter {
+    mir::Procedure& proc;
+    mir::MIRValue fd;
+
+    void printStr(mir::MIRValue str) {
+        if (fd) {
+            auto args = { fd, str };
+            proc.emitCall(mir::SysCallKind::filePrintStr, args);
+        }
+        else {
+            proc.emitCall(mir::SysCallKind::printStr, str);
+        }
+    }
+
+    void printInt(mir::MIRValue value, LiteralBase base, const SFormat::FormatOptions& options) {
+        auto baseVal = proc.emitInt(8, uint64_t(base), false);
+        auto width = proc.emitInt(32, options.width.value_or(0), false);
+        auto hasWidth = proc.emitInt(1, options.width.has_value(), false);
+        if (fd) {
+            auto args = { fd, value, baseVal, width, hasWidth };
+            proc.emitCall(mir::SysCallKind::filePrintInt, args);
+        }
+        else {
+            auto args = { value, baseVal, width, hasWidth };
+            proc.emitCall(mir::SysCallKind::printInt, args);
+        }
+    }
+
+    void flush(bool newline) {
+        if (fd) {
+            auto args = { fd, proc.emitBool(newline) };
+            proc.emitCall(mir::SysCallKind::fileFlush, args);
+        }
+        else {
+            proc.emitCall(mir::SysCallKind::flush, proc.emitBool(newline));
+        }
+    }
+};
+
+} // namespace
+
+static void lowerFormatArg(PrintEmitter& emitter, const Expression& arg, char,
                            const SFormat::FormatOptions& options, LiteralBase defaultBase) {
     // TODO: actually use the options
-    mir::MIRValue argVal = proc.emitExpr(arg);
+    mir::MIRValue argVal = emitter.proc.emitExpr(arg);
     const Type& type = arg.type->getCanonicalType();
     if (type.isIntegral()) {
-        auto args = { argVal, proc.emitInt(8, uint64_t(defaultBase), false),
-                      proc.emitInt(32, options.width.value_or(0), false),
-                      proc.emitInt(1, options.width.has_value(), false) };
-        proc.emitCall(mir::SysCallKind::printInt, args);
+        emitter.printInt(argVal, defaultBase, options);
         return;
     }
 
@@ -395,7 +437,8 @@ static void lowerFormatArg(mir::Procedure& proc, const Expression& arg, char,
 }
 
 void FmtHelpers::lowerFormatArgs(mir::Procedure& proc, const Args& args, LiteralBase defaultBase,
-                                 bool newline) {
+                                 bool newline, mir::MIRValue fd) {
+    PrintEmitter emitter{ proc, fd };
     auto argIt = args.begin();
     while (argIt != args.end()) {
         auto arg = *argIt++;
@@ -404,7 +447,7 @@ void FmtHelpers::lowerFormatArgs(mir::Procedure& proc, const Args& args, Literal
 
         // Empty arguments always print a space.
         if (arg->kind == ExpressionKind::EmptyArgument) {
-            proc.emitCall(mir::SysCallKind::printStr, proc.emitString(" "));
+            emitter.printStr(proc.emitString(" "));
             continue;
         }
 
@@ -417,14 +460,11 @@ void FmtHelpers::lowerFormatArgs(mir::Procedure& proc, const Args& args, Literal
                 fmt = fmt.substr(1, fmt.length() - 2);
 
             bool result = SFormat::parse(
-                fmt,
-                [&](string_view text) {
-                    proc.emitCall(mir::SysCallKind::printStr, proc.emitString(std::string(text)));
-                },
+                fmt, [&](string_view text) { emitter.printStr(proc.emitString(std::string(text))); },
                 [&](char specifier, size_t, size_t, const SFormat::FormatOptions& options) {
                     if (argIt != args.end()) {
                         auto currentArg = *argIt++;
-                        lowerFormatArg(proc, *currentArg, specifier, options, defaultBase);
+                        lowerFormatArg(emitter, *currentArg, specifier, options, defaultBase);
                     }
                 },
                 [](DiagCode, size_t, size_t, optional<char>) {});
@@ -435,11 +475,11 @@ void FmtHelpers::lowerFormatArgs(mir::Procedure& proc, const Args& args, Literal
         else {
             // Otherwise, print the value with default options.
             // TODO: set correct specifier
-            lowerFormatArg(proc, *arg, ' ', {}, defaultBase);
+            lowerFormatArg(emitter, *arg, ' ', {}, defaultBase);
         }
     }
 
-    proc.emitCall(mir::SysCallKind::flush, proc.emitBool(newline));
+    emitter.flush(newline);
 }
 
 bool FmtHelpers::checkFinishNum(const BindContext& context, const Expression& arg) {
@@ -825,6 +825,8 @@ bool withinCovergroup(const Symbol& symbol, const Scope& initialScope) {
 void Lookup::name(const NameSyntax& syntax, const BindContext& context, bitmask<LookupFlags> flags,
                   LookupResult& result) {
     auto& scope = *context.scope;
+    scope.getCompilation().noteLookup();
+
     NameComponents name;
     switch (syntax.kind) {
         case SyntaxKind::IdentifierName:
@@ -912,6 +914,8 @@ const Symbol* Lookup::unqualified(const Scope& scope, string_view name,
     if (name.empty())
         return nullptr;
 
+    scope.getCompilation().noteLookup();
+
     LookupResult result;
     unqualifiedImpl(scope, name, LookupLocation::max, std::nullopt, flags, {}, result);
     ASSERT(result.selectors.empty());
@@ -925,6 +929,8 @@ const Symbol* Lookup::unqualifiedAt(const Scope& scope, string_view name, Lookup
     if (name.empty())
         return nullptr;
 
+    scope.getCompilation().noteLookup();
+
     LookupResult result;
     unqualifiedImpl(scope, name, location, sourceRange, flags, {}, result);
     ASSERT(result.selectors.empty());
@@ -1526,28 +1532,16 @@ void Lookup::unqualifiedImpl(const Scope& scope, string_view name, LookupLocatio
 
     // Look through any wildcard imports prior to the lookup point and see if their packages
     // contain the name we're looking for.
-    auto wildcardImports = scope.getWildcardImports();
-    if (!wildcardImports.empty()) {
-        struct Import {
-            const Symbol* imported;
-            const WildcardImportSymbol* import;
-        };
-        SmallVectorSized<Import, 8> imports;
-        SmallSet<const Symbol*, 2> importDedup;
+    if (!scope.getWildcardImports().empty()) {
+        SmallVectorSized<Scope::WildcardImportMatch, 8> matches;
+        if (scope.findWildcardImports(name, location, matches))
+            result.suppressUndeclared = true;
 
-        for (auto import : wildcardImports) {
-            if (location < LookupLocation::after(*import))
-                break;
-
-            auto package = import->getPackage();
-            if (!package) {
-                result.suppressUndeclared = true;
-                continue;
-            }
-
-            const Symbol* imported = package->findForImport(name);
-            if (imported && importDedup.emplace(imported).second)
-                imports.emplace(Import{ imported, import });
+        SmallVectorSized<Scope::WildcardImportMatch, 8> imports;
+        SmallSet<const Symbol*, 2> importDedup;
+        for (auto& match : matches) {
+            if (importDedup.emplace(match.imported).second)
+                imports.append(match);
         }
 
         if (!imports.empty()) {
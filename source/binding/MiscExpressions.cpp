@@ -324,6 +324,29 @@ ConstantValue NamedValueExpression::evalImpl(EvalContext& context) const {
     return nullptr;
 }
 
+const ConstantValue* NamedValueExpression::evalInPlace(EvalContext& context) const {
+    if (bad())
+        return nullptr;
+
+    if (constant)
+        return constant;
+
+    if (!checkConstant(context))
+        return &ConstantValue::Invalid;
+
+    switch (symbol.kind) {
+        case SymbolKind::Parameter: {
+            auto& v = symbol.as<ParameterSymbol>().getValue(sourceRange);
+            return v.isUnbounded() ? nullptr : &v;
+        }
+        case SymbolKind::EnumValue:
+        case SymbolKind::Specparam:
+            return nullptr;
+        default:
+            return context.findLocal(&symbol);
+    }
+}
+
 LValue NamedValueExpression::evalLValueImpl(EvalContext& context) const {
     if (!checkConstant(context))
         return nullptr;
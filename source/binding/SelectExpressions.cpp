@@ -207,7 +207,19 @@ bool ElementSelectExpression::isConstantSelect(EvalContext& context) const {
 }
 
 ConstantValue ElementSelectExpression::evalImpl(EvalContext& context) const {
-    ConstantValue cv = value().eval(context);
+    // When selecting from a local variable or parameter, look at its value in
+    // place instead of copying the entire array just to pull out one element.
+    const ConstantValue* valuePtr = nullptr;
+    if (value().kind == ExpressionKind::NamedValue)
+        valuePtr = value().as<NamedValueExpression>().evalInPlace(context);
+
+    ConstantValue storage;
+    if (!valuePtr) {
+        storage = value().eval(context);
+        valuePtr = &storage;
+    }
+
+    const ConstantValue& cv = *valuePtr;
     if (!cv)
         return nullptr;
 
@@ -251,7 +263,7 @@ ConstantValue ElementSelectExpression::evalImpl(EvalContext& context) const {
     if (range->left == -1)
         return type->getDefaultValue();
 
-    return std::move(cv).at(size_t(range->left));
+    return cv.at(size_t(range->left));
 }
 
 LValue ElementSelectExpression::evalLValueImpl(EvalContext& context) const {
@@ -259,17 +271,28 @@ LValue ElementSelectExpression::evalLValueImpl(EvalContext& context) const {
     if (!lval)
         return nullptr;
 
+    // Dynamically sized arrays need their current value for bounds checking.
+    // If the array is a plain variable, look at it in place instead of
+    // copying the whole thing. Associative arrays don't need it at all.
+    const Type& valType = *value().type;
     ConstantValue loadedVal;
-    if (!value().type->hasFixedRange())
-        loadedVal = lval.load();
+    const ConstantValue* currentVal = &loadedVal;
+    if (!valType.hasFixedRange() && !valType.isAssociativeArray()) {
+        if (value().kind == ExpressionKind::NamedValue)
+            currentVal = lval.resolve();
+
+        if (!currentVal) {
+            loadedVal = lval.load();
+            currentVal = &loadedVal;
+        }
+    }
 
     ConstantValue associativeIndex;
-    auto range = evalIndex(context, loadedVal, associativeIndex);
+    auto range = evalIndex(context, *currentVal, associativeIndex);
     if (!range && associativeIndex.bad())
         return nullptr;
 
     // Handling for packed and unpacked arrays, all integer types.
-    const Type& valType = *value().type;
     if (valType.hasFixedRange()) {
         // For fixed types, we know we will always be in range, so just do the selection.
         if (valType.isUnpackedArray())
@@ -536,11 +559,10 @@ Expression& RangeSelectExpression::fromSyntax(Compilation& compilation, Expressi
         // At this point, all expressions are good, ranges have been validated and
         // we know the final width of the selection, so pick the result type and we're done.
         if (valueType.isUnpackedArray()) {
-            result->type =
-                compilation.emplace<FixedSizeUnpackedArrayType>(elementType, selectionRange);
+            result->type = &compilation.getUnpackedArrayType(elementType, selectionRange);
         }
         else {
-            result->type = compilation.emplace<PackedArrayType>(elementType, selectionRange);
+            result->type = &compilation.getPackedArrayType(elementType, selectionRange);
         }
     }
     else {
@@ -569,7 +591,7 @@ Expression& RangeSelectExpression::fromSyntax(Compilation& compilation, Expressi
             selectionRange.right = *rv - 1;
         }
 
-        result->type = compilation.emplace<FixedSizeUnpackedArrayType>(elementType, selectionRange);
+        result->type = &compilation.getUnpackedArrayType(elementType, selectionRange);
     }
 
     return *result;
@@ -602,9 +624,9 @@ Expression& RangeSelectExpression::fromConstant(Compilation& compilation, Expres
     ASSERT(valueType.hasFixedRange());
 
     if (valueType.isUnpackedArray())
-        result->type = compilation.emplace<FixedSizeUnpackedArrayType>(elementType, range);
+        result->type = &compilation.getUnpackedArrayType(elementType, range);
     else
-        result->type = compilation.emplace<PackedArrayType>(elementType, range);
+        result->type = &compilation.getPackedArrayType(elementType, range);
 
     return *result;
 }
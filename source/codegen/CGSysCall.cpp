@@ -34,6 +34,22 @@ llvm::Function* CodeGenFunction::getSysFunc(mir::SysCallKind kind) const {
         case SysCallKind::printInt:
             ft = getFuncType(types.Void, ptr(types.BoxedInt), types.Int8, types.Int32, types.Int1);
             break;
+        case SysCallKind::fileOpen:
+            ft = getFuncType(types.Int32, ptr(types.Int8), types.Size, ptr(types.Int8), types.Size);
+            break;
+        case SysCallKind::fileClose:
+            ft = getFuncType(types.Void, ptr(types.BoxedInt));
+            break;
+        case SysCallKind::fileFlush:
+            ft = getFuncType(types.Void, ptr(types.BoxedInt), types.Int1);
+            break;
+        case SysCallKind::filePrintStr:
+            ft = getFuncType(types.Void, ptr(types.BoxedInt), ptr(types.Int8), types.Size);
+            break;
+        case SysCallKind::filePrintInt:
+            ft = getFuncType(types.Void, ptr(types.BoxedInt), ptr(types.BoxedInt), types.Int8,
+                             types.Int32, types.Int1);
+            break;
         default:
             THROW_UNREACHABLE;
     }
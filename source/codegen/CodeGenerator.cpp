@@ -10,19 +10,40 @@
 #include "CGBuilder.h"
 #include "CodeGenFunction.h"
 #include "CodeGenTypes.h"
+#include <chrono>
+#include <exception>
+#include <fmt/format.h>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Verifier.h>
+#include <llvm/MC/TargetRegistry.h>
+#include <llvm/Passes/OptimizationLevel.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Host.h>
 #include <llvm/Support/TargetSelect.h>
+#include <llvm/Target/TargetMachine.h>
+#include <llvm/Target/TargetOptions.h>
+#include <thread>
 
 #include "slang/compilation/Compilation.h"
 #include "slang/mir/Procedure.h"
+#include "slang/symbols/VariableSymbols.h"
+#include "slang/types/Type.h"
 
 namespace slang {
 
+using Clock = std::chrono::steady_clock;
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
 GeneratedCode::GeneratedCode(std::unique_ptr<llvm::LLVMContext> context,
-                             std::unique_ptr<llvm::Module> module) :
+                             std::unique_ptr<llvm::Module> module, CodegenTiming timing) :
     context(std::move(context)),
-    module(std::move(module)) {
+    module(std::move(module)), timing(timing) {
 }
 
 GeneratedCode::GeneratedCode(GeneratedCode&&) = default;
@@ -33,6 +54,10 @@ std::pair<std::unique_ptr<llvm::LLVMContext>, std::unique_ptr<llvm::Module>> Gen
     return { std::move(context), std::move(module) };
 }
 
+std::string GeneratedCode::getName() const {
+    return module->getName().str();
+}
+
 std::string GeneratedCode::toString() const {
     std::string result;
     llvm::raw_string_ostream os(result);
@@ -40,10 +65,43 @@ std::string GeneratedCode::toString() const {
     return os.str();
 }
 
-CodeGenerator::CodeGenerator(const Compilation& compilation) : compilation(compilation) {
-    llvm::InitializeNativeTarget();
-    llvm::InitializeNativeTargetAsmPrinter();
-    llvm::InitializeNativeTargetAsmParser();
+void GeneratedCode::writeObjectFile(const std::string& path) {
+    std::string triple = llvm::sys::getProcessTriple();
+    std::string error;
+    auto target = llvm::TargetRegistry::lookupTarget(triple, error);
+    if (!target)
+        throw std::runtime_error(error);
+
+    llvm::TargetOptions targetOptions;
+    std::unique_ptr<llvm::TargetMachine> tm(
+        target->createTargetMachine(triple, "generic", "", targetOptions, llvm::Reloc::PIC_,
+                                    llvm::None, llvm::CodeGenOpt::Aggressive));
+    if (!tm)
+        throw std::runtime_error(fmt::format("Unable to create target machine for '{}'", triple));
+
+    module->setTargetTriple(triple);
+    module->setDataLayout(tm->createDataLayout());
+
+    std::error_code ec;
+    llvm::raw_fd_ostream os(path, ec, llvm::sys::fs::OF_None);
+    if (ec)
+        throw std::runtime_error(fmt::format("Unable to open '{}': {}", path, ec.message()));
+
+    llvm::legacy::PassManager passes;
+    if (tm->addPassesToEmitFile(passes, os, nullptr, llvm::CGFT_ObjectFile))
+        throw std::runtime_error("Target does not support emitting object files");
+
+    passes.run(*module);
+    os.flush();
+    if (os.has_error()) {
+        os.clear_error();
+        throw std::runtime_error(fmt::format("Unable to write object file '{}'", path));
+    }
+}
+
+CodeGenerator::CodeGenerator(const Compilation& compilation, const CodegenOptions& options) :
+    compilation(compilation), options(options) {
+    initTarget();
 
     ctx = std::make_unique<llvm::LLVMContext>();
     module = std::make_unique<llvm::Module>("primary", *ctx);
@@ -59,37 +117,211 @@ CodeGenerator::CodeGenerator(const Compilation& compilation) : compilation(compi
     globalInitBlock = llvm::BasicBlock::Create(*ctx, "", mainFunc);
 }
 
+CodeGenerator::CodeGenerator(const Compilation& compilation, const CodegenOptions& options,
+                             const std::string& moduleName, PartitionTag) :
+    compilation(compilation), options(options) {
+    // Partitions only hold procedures that are called from the primary module,
+    // so they have no main function of their own.
+    ctx = std::make_unique<llvm::LLVMContext>();
+    module = std::make_unique<llvm::Module>(moduleName, *ctx);
+    types = std::make_unique<CodeGenTypes>(*this);
+}
+
 CodeGenerator::~CodeGenerator() = default;
 
+void CodeGenerator::initTarget() {
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+    llvm::InitializeNativeTargetAsmParser();
+}
+
 void CodeGenerator::emitAll(const mir::MIRBuilder& design) {
-    for (auto& proc : design.getInitialProcs())
+    auto procs = design.getInitialProcs();
+    if (options.numThreads > 1 && procs.size() > 1) {
+        emitPartitioned(procs);
+        return;
+    }
+
+    for (auto& proc : procs)
         emit(*proc);
 }
 
 void CodeGenerator::emit(const mir::Procedure& proc) {
+    auto start = Clock::now();
     CodeGenFunction cgf(*this, proc);
     llvm::IRBuilder<> caller(globalInitBlock);
     caller.CreateCall(cgf.finalize(), {});
+    timing.codegen += secondsSince(start);
 }
 
-GeneratedCode CodeGenerator::finish() {
-    // Insert all initial blocks into the main function.
-    auto lastBlock = globalInitBlock;
-    for (auto block : initialBlocks) {
-        llvm::IRBuilder<>(lastBlock).CreateBr(block);
-        lastBlock = block;
+void CodeGenerator::emitPartitioned(span<const std::unique_ptr<mir::Procedure>> procs) {
+    // Some type information is computed lazily and cached on first access;
+    // force all of it now so that worker threads only ever read from the AST.
+    auto forceType = [](const Type& type) { type.getCanonicalType(); };
+    for (auto& proc : procs) {
+        for (auto local : proc->getLocals())
+            forceType(local->getType());
+
+        for (auto& instr : proc->getInstructions()) {
+            forceType(instr.type);
+            for (auto& op : instr.getOperands()) {
+                if (op.getKind() == mir::MIRValue::Constant)
+                    forceType(op.asConstant().type);
+            }
+        }
     }
 
-    // Finish the main function.
-    auto intType = llvm::Type::getInt32Ty(*ctx);
-    llvm::IRBuilder<>(lastBlock).CreateRet(llvm::ConstantInt::get(intType, 0));
+    // Procedures are assigned to partitions round robin. The primary module declares
+    // each one as an external function and calls them in their original order.
+    size_t numPartitions = std::min(size_t(options.numThreads), procs.size());
+    size_t firstPartition = partitions.size();
+    for (size_t i = 0; i < numPartitions; i++) {
+        auto name = fmt::format("partition{}", firstPartition + i);
+        partitions.emplace_back(new CodeGenerator(compilation, options, name, PartitionTag{}));
+    }
+
+    auto funcType = llvm::FunctionType::get(llvm::Type::getVoidTy(*ctx), /* isVarArg */ false);
+    std::vector<std::string> names;
+    names.reserve(procs.size());
+    for (size_t i = 0; i < procs.size(); i++) {
+        auto& name = names.emplace_back(fmt::format("__slang_proc{}", externalProcCount++));
+        auto decl = llvm::Function::Create(funcType, llvm::Function::ExternalLinkage, name, *module);
+        llvm::IRBuilder<>(globalInitBlock).CreateCall(decl, {});
+    }
+
+    std::vector<std::exception_ptr> errors(numPartitions);
+    std::vector<std::thread> threads;
+    threads.reserve(numPartitions);
+    for (size_t p = 0; p < numPartitions; p++) {
+        threads.emplace_back([&, p] {
+            try {
+                auto& partition = *partitions[firstPartition + p];
+                for (size_t i = p; i < procs.size(); i += numPartitions)
+                    partition.emitExternal(*procs[i], names[i]);
+
+                partition.finalizeModule();
+            }
+            catch (...) {
+                errors[p] = std::current_exception();
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    for (auto& error : errors) {
+        if (error)
+            std::rethrow_exception(error);
+    }
+}
+
+void CodeGenerator::emitExternal(const mir::Procedure& proc, const std::string& name) {
+    auto start = Clock::now();
+    CodeGenFunction cgf(*this, proc);
+    auto func = cgf.finalize();
+    func->setName(name);
+    func->setLinkage(llvm::Function::ExternalLinkage);
+    timing.codegen += secondsSince(start);
+}
+
+std::vector<GeneratedCode> CodeGenerator::finish() {
+    finalizeModule();
+
+    std::vector<GeneratedCode> results;
+    results.emplace_back(std::move(ctx), std::move(module), timing);
+    for (auto& partition : partitions) {
+        results.emplace_back(std::move(partition->ctx), std::move(partition->module),
+                             partition->timing);
+    }
+
+    partitions.clear();
+    return results;
+}
+
+void CodeGenerator::finalizeModule() {
+    if (mainFunc) {
+        // Insert all initial blocks into the main function.
+        auto lastBlock = globalInitBlock;
+        for (auto block : initialBlocks) {
+            llvm::IRBuilder<>(lastBlock).CreateBr(block);
+            lastBlock = block;
+        }
+
+        // Finish the main function.
+        auto intType = llvm::Type::getInt32Ty(*ctx);
+        llvm::IRBuilder<>(lastBlock).CreateRet(llvm::ConstantInt::get(intType, 0));
+    }
 
     // Verify all generated code.
     bool bad = llvm::verifyModule(*module, &llvm::errs());
     if (bad)
         module->print(llvm::errs(), nullptr); // ld: undefined symbol llvm::Module::dump()
+    else
+        optimize();
+}
+
+void CodeGenerator::optimize() {
+    if (options.optLevel == 0)
+        return;
+
+    auto start = Clock::now();
+
+    // Optimize for the host machine, which is where the JIT will be running the code.
+    // If we can't figure out what that is we can still run target-independent passes.
+    std::unique_ptr<llvm::TargetMachine> tm;
+    auto jtmb = llvm::orc::JITTargetMachineBuilder::detectHost();
+    if (jtmb) {
+        auto result = jtmb->createTargetMachine();
+        if (result) {
+            tm = std::move(*result);
+            module->setTargetTriple(tm->getTargetTriple().str());
+            module->setDataLayout(tm->createDataLayout());
+        }
+        else {
+            llvm::consumeError(result.takeError());
+        }
+    }
+    else {
+        llvm::consumeError(jtmb.takeError());
+    }
+
+    llvm::OptimizationLevel level;
+    switch (options.optLevel) {
+        case 1:
+            level = llvm::OptimizationLevel::O1;
+            break;
+        case 2:
+            level = llvm::OptimizationLevel::O2;
+            break;
+        default:
+            level = llvm::OptimizationLevel::O3;
+            break;
+    }
+
+    // Procedures that operate on arrays benefit greatly from vectorization,
+    // so turn it on explicitly for the higher optimization levels.
+    llvm::PipelineTuningOptions tuning;
+    tuning.LoopInterleaving = options.optLevel >= 2;
+    tuning.LoopVectorization = options.optLevel >= 2;
+    tuning.SLPVectorization = options.optLevel >= 2;
+
+    llvm::LoopAnalysisManager lam;
+    llvm::FunctionAnalysisManager fam;
+    llvm::CGSCCAnalysisManager cgam;
+    llvm::ModuleAnalysisManager mam;
+
+    llvm::PassBuilder pb(tm.get(), tuning);
+    pb.registerModuleAnalyses(mam);
+    pb.registerCGSCCAnalyses(cgam);
+    pb.registerFunctionAnalyses(fam);
+    pb.registerLoopAnalyses(lam);
+    pb.crossRegisterProxies(lam, fam, cgam, mam);
+
+    auto mpm = pb.buildPerModuleDefaultPipeline(level);
+    mpm.run(*module, mam);
 
-    return GeneratedCode(std::move(ctx), std::move(module));
+    timing.optimize += secondsSince(start);
 }
 
 llvm::Function* CodeGenerator::getOrCreateSystemFunction(mir::SysCallKind kind,
@@ -7,7 +7,9 @@
 //------------------------------------------------------------------------------
 #include "slang/codegen/JIT.h"
 
+#include "ObjectCache.h"
 #include <llvm/ExecutionEngine/JITSymbol.h>
+#include <llvm/ExecutionEngine/Orc/CompileUtils.h>
 #include <llvm/ExecutionEngine/Orc/LLJIT.h>
 
 #include "slang/runtime/Runtime.h"
@@ -28,8 +30,19 @@ static void report(llvm::Expected<T>& e) {
     report(e.takeError());
 }
 
-JIT::JIT() {
-    auto result = LLLazyJITBuilder().create();
+JIT::JIT(const JITOptions& options) {
+    LLLazyJITBuilder builder;
+    builder.setNumCompileThreads(options.numCompileThreads);
+    if (!options.objectCacheDir.empty()) {
+        objectCache = std::make_unique<DiskObjectCache>(options.objectCacheDir);
+        builder.setCompileFunctionCreator(
+            [cache = objectCache.get()](JITTargetMachineBuilder jtmb)
+                -> llvm::Expected<std::unique_ptr<IRCompileLayer::IRCompiler>> {
+                return std::make_unique<ConcurrentIRCompiler>(std::move(jtmb), cache);
+            });
+    }
+
+    auto result = builder.create();
     if (!result)
         report(result);
 
@@ -38,12 +51,15 @@ JIT::JIT() {
     // Register all exported simrt functions with the JIT.
     // Mangle names according to https://llvm.org/docs/ORCv2.html
     MangleAndInterner mangle(jit->getExecutionSession(), jit->getDataLayout());
+    SymbolMap symbols;
     for (auto& [name, ptr] : slang::runtime::getExportedFunctions()) {
-        llvm::JITEvaluatedSymbol sym(static_cast<llvm::JITTargetAddress>(ptr), {});
-        auto err = jit->defineAbsolute(*mangle(llvm::StringRef(name.data(), name.length())), sym);
-        if (err)
-            report(std::move(err));
+        symbols[mangle(llvm::StringRef(name.data(), name.length()))] = llvm::JITEvaluatedSymbol(
+            static_cast<llvm::JITTargetAddress>(ptr), llvm::JITSymbolFlags::Exported);
     }
+
+    auto err = jit->getMainJITDylib().define(absoluteSymbols(std::move(symbols)));
+    if (err)
+        report(std::move(err));
 }
 
 JIT::~JIT() = default;
@@ -55,13 +71,29 @@ void JIT::addCode(GeneratedCode code) {
         report(std::move(err));
 }
 
+void JIT::addCode(std::vector<GeneratedCode> code) {
+    for (auto& c : code)
+        addCode(std::move(c));
+}
+
 int JIT::run() {
     auto sym = jit->lookup("main");
     if (!sym)
         report(sym);
 
     auto fp = (int (*)())(intptr_t)sym->getAddress();
-    return fp();
+    int result = fp();
+
+    slang::runtime::flushOutput();
+    return result;
+}
+
+uint64_t JIT::getNumCacheHits() const {
+    return objectCache ? objectCache->getNumHits() : 0;
+}
+
+uint64_t JIT::getNumCacheMisses() const {
+    return objectCache ? objectCache->getNumMisses() : 0;
 }
 
 } // namespace slang
@@ -0,0 +1,90 @@
+//------------------------------------------------------------------------------
+// ObjectCache.cpp
+// On-disk cache of JIT compiled object code
+//
+// File is under the MIT license; see LICENSE for details
+//------------------------------------------------------------------------------
+#include "ObjectCache.h"
+
+#include <fmt/format.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+
+namespace slang {
+
+DiskObjectCache::DiskObjectCache(std::string directory) : directory(std::move(directory)) {
+    // Compiled objects are only valid for the exact version of LLVM and the target
+    // that produced them, so mix those into every key.
+    salt = fmt::format("{};{};{}", LLVM_VERSION_STRING, llvm::sys::getProcessTriple(),
+                       llvm::sys::getHostCPUName().str());
+
+    // If this fails we'll just end up missing in the cache every time.
+    llvm::sys::fs::create_directories(this->directory);
+}
+
+void DiskObjectCache::notifyObjectCompiled(const llvm::Module* module, llvm::MemoryBufferRef obj) {
+    uint64_t key;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = pendingKeys.find(module);
+        if (it == pendingKeys.end())
+            return;
+
+        key = it->second;
+        pendingKeys.erase(it);
+    }
+
+    // Write to a temporary file and then rename it into place, so that other
+    // processes sharing the cache directory never observe a partially written object.
+    std::string path = getPath(key);
+    llvm::SmallString<128> tmpPath;
+    int fd;
+    if (llvm::sys::fs::createUniqueFile(path + ".%%%%%%%%.tmp", fd, tmpPath))
+        return;
+
+    bool ok;
+    {
+        llvm::raw_fd_ostream os(fd, /* shouldClose */ true);
+        os << obj.getBuffer();
+        os.close();
+        ok = !os.has_error();
+        os.clear_error();
+    }
+
+    if (!ok || llvm::sys::fs::rename(tmpPath, path))
+        llvm::sys::fs::remove(tmpPath);
+}
+
+std::unique_ptr<llvm::MemoryBuffer> DiskObjectCache::getObject(const llvm::Module* module) {
+    uint64_t key = hashModule(*module);
+    auto buffer = llvm::MemoryBuffer::getFile(getPath(key));
+    if (buffer) {
+        numHits++;
+        return std::move(*buffer);
+    }
+
+    numMisses++;
+    std::lock_guard<std::mutex> lock(mutex);
+    pendingKeys[module] = key;
+    return nullptr;
+}
+
+uint64_t DiskObjectCache::hashModule(const llvm::Module& module) const {
+    llvm::SmallVector<char, 0> buffer;
+    llvm::raw_svector_ostream os(buffer);
+    llvm::WriteBitcodeToFile(module, os);
+
+    buffer.append(salt.begin(), salt.end());
+    return xxhash(buffer.data(), buffer.size());
+}
+
+std::string DiskObjectCache::getPath(uint64_t key) const {
+    return fmt::format("{}/{:016x}.o", directory, key);
+}
+
+} // namespace slang
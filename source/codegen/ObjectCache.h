@@ -0,0 +1,54 @@
+//------------------------------------------------------------------------------
+// ObjectCache.h
+// On-disk cache of JIT compiled object code
+//
+// File is under the MIT license; see LICENSE for details
+//------------------------------------------------------------------------------
+#pragma once
+
+#include <atomic>
+#include <llvm/ExecutionEngine/ObjectCache.h>
+#include <mutex>
+#include <string>
+
+#include "slang/util/Hash.h"
+
+namespace slang {
+
+/// An implementation of the LLVM ObjectCache interface that stores compiled
+/// object files in a directory on disk. Each object is keyed by a hash of the
+/// module it was compiled from (along with the target it was compiled for),
+/// so identical code generated across separate runs of the tool will be loaded
+/// from disk instead of being compiled again.
+class DiskObjectCache : public llvm::ObjectCache {
+public:
+    explicit DiskObjectCache(std::string directory);
+
+    void notifyObjectCompiled(const llvm::Module* module, llvm::MemoryBufferRef obj) final;
+    std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module* module) final;
+
+    /// @return the number of modules that were successfully loaded from the cache.
+    uint64_t getNumHits() const { return numHits; }
+
+    /// @return the number of modules that had to be compiled because they
+    /// were not present in the cache.
+    uint64_t getNumMisses() const { return numMisses; }
+
+private:
+    uint64_t hashModule(const llvm::Module& module) const;
+    std::string getPath(uint64_t key) const;
+
+    std::string directory;
+    std::string salt;
+
+    // Keys computed in getObject for modules that missed in the cache,
+    // so that they don't need to be rehashed once compilation finishes.
+    // The JIT may compile on multiple threads, so this is guarded by a mutex.
+    std::mutex mutex;
+    flat_hash_map<const llvm::Module*, uint64_t> pendingKeys;
+
+    std::atomic<uint64_t> numHits = 0;
+    std::atomic<uint64_t> numMisses = 0;
+};
+
+} // namespace slang
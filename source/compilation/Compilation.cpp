@@ -11,6 +11,7 @@
 
 #include "slang/binding/SystemSubroutine.h"
 #include "slang/compilation/Definition.h"
+#include "slang/compilation/DependencyGraph.h"
 #include "slang/compilation/ScriptSession.h"
 #include "slang/diagnostics/DiagnosticEngine.h"
 #include "slang/diagnostics/LookupDiags.h"
@@ -228,6 +229,9 @@ void Compilation::addSyntaxTree(std::shared_ptr<SyntaxTree> tree) {
         unit->addMembers(node);
     }
 
+    if (dependencyGraph)
+        dependencyGraph->addTree(*tree);
+
     syntaxTrees.emplace_back(std::move(tree));
     cachedParseDiagnostics.reset();
 }
@@ -236,6 +240,280 @@ span<const std::shared_ptr<SyntaxTree>> Compilation::getSyntaxTrees() const {
     return syntaxTrees;
 }
 
+const DependencyGraph& Compilation::getDependencyGraph() {
+    if (!dependencyGraph) {
+        dependencyGraph = std::make_unique<DependencyGraph>();
+        for (auto& tree : syntaxTrees)
+            dependencyGraph->addTree(*tree);
+    }
+    return *dependencyGraph;
+}
+
+static bool canCarryDiag(const Diagnostic& diag, SourceRange range) {
+    auto contains = [&](SourceLocation loc) {
+        return loc.buffer() == range.start().buffer() && loc.offset() >= range.start().offset() &&
+               loc.offset() <= range.end().offset();
+    };
+
+    if (!contains(diag.location))
+        return false;
+
+    for (auto& r : diag.ranges) {
+        if (!contains(r.start()) || !contains(r.end()))
+            return false;
+    }
+
+    // Arbitrary arguments can point at symbols and types in the old compilation.
+    for (auto& arg : diag.args) {
+        if (std::holds_alternative<std::any>(arg))
+            return false;
+    }
+
+    for (auto& note : diag.notes) {
+        if (!canCarryDiag(note, range))
+            return false;
+    }
+    return true;
+}
+
+static void relocateDiag(Diagnostic& diag, BufferID buffer, ptrdiff_t shift) {
+    auto relocate = [&](SourceLocation loc) {
+        return SourceLocation(buffer, size_t(ptrdiff_t(loc.offset()) + shift));
+    };
+
+    diag.location = relocate(diag.location);
+    diag.symbol = nullptr;
+    for (auto& r : diag.ranges)
+        r = SourceRange(relocate(r.start()), relocate(r.end()));
+
+    for (auto& note : diag.notes)
+        relocateDiag(note, buffer, shift);
+}
+
+std::unique_ptr<Compilation> Compilation::replaceSyntaxTreeReusingDiagnostics(
+    const SyntaxTree& oldTree, std::shared_ptr<SyntaxTree> newTree) {
+    TreeReplacement replacement{ &oldTree, std::move(newTree) };
+    return replaceSyntaxTreesReusingDiagnostics(span(&replacement, 1));
+}
+
+std::unique_ptr<Compilation> Compilation::replaceSyntaxTreesReusingDiagnostics(
+    span<const TreeReplacement> replacements) {
+    flat_hash_map<const SyntaxTree*, std::shared_ptr<SyntaxTree>> replaced;
+    for (auto& [oldTree, newTree] : replacements) {
+        auto treeIt = std::find_if(syntaxTrees.begin(), syntaxTrees.end(),
+                                   [&](auto& tree) { return tree.get() == oldTree; });
+        if (treeIt == syntaxTrees.end())
+            throw std::invalid_argument("The syntax tree to replace is not part of the compilation");
+        if (!newTree)
+            throw std::invalid_argument("The replacement syntax tree must not be null");
+
+        if (!replaced.emplace(oldTree, newTree).second)
+            throw std::invalid_argument("The same syntax tree can only be replaced once");
+    }
+
+    auto result = std::make_unique<Compilation>();
+    result->options = options;
+    result->defaultTimeScale = defaultTimeScale;
+    for (auto& tree : syntaxTrees) {
+        auto it = replaced.find(tree.get());
+        result->addSyntaxTree(it == replaced.end() ? tree : it->second);
+    }
+
+    // The new graph shares the elements for all of the other trees with ours.
+    using Element = DependencyGraph::Element;
+    auto& oldGraph = getDependencyGraph();
+    result->dependencyGraph = std::make_unique<DependencyGraph>(oldGraph);
+
+    auto& newGraph = *result->dependencyGraph;
+    for (auto& replacement : replacements)
+        newGraph.removeTree(*replacement.first);
+    for (auto& replacement : replacements)
+        newGraph.addTree(*replacement.second);
+
+    // Match up the elements in each old and new tree to find what changed.
+    SmallVectorSized<const Element*, 8> changed;
+    flat_hash_map<const Element*, const Element*> newToOld;
+    flat_hash_set<const SyntaxTree*> newTrees;
+    for (auto& [oldTree, newTree] : replacements) {
+        newTrees.emplace(newTree.get());
+        auto oldElements = oldGraph.getElements(*oldTree);
+        auto newElements = newGraph.getElements(*newTree);
+
+        flat_hash_map<std::tuple<string_view, SyntaxKind>, const Element*> oldByName;
+        flat_hash_set<std::tuple<string_view, SyntaxKind>> duplicates;
+        for (auto& elem : oldElements) {
+            std::tuple key{ elem.name, elem.kind };
+            if (!oldByName.emplace(key, &elem).second)
+                duplicates.emplace(key);
+        }
+
+        SmallVectorSized<std::pair<const Element*, const Element*>, 8> matched;
+        bool unitChanged = false;
+        for (auto& elem : newElements) {
+            std::tuple key{ elem.name, elem.kind };
+            auto it = oldByName.find(key);
+            if (it == oldByName.end() || duplicates.find(key) != duplicates.end()) {
+                changed.append(&elem);
+                continue;
+            }
+
+            auto old = it->second;
+            oldByName.erase(it);
+
+            if (old->hash != elem.hash || !old->isSelfContained || !elem.isSelfContained) {
+                changed.append(&elem);
+                changed.append(old);
+                unitChanged |= elem.isCompilationUnit();
+            }
+            else {
+                matched.append({ &elem, old });
+            }
+        }
+
+        // Anything left over in the old tree has been removed.
+        for (auto& [key, elem] : oldByName) {
+            changed.append(elem);
+            unitChanged |= elem->isCompilationUnit();
+        }
+
+        // A change to the compilation unit can change the meaning of everything in it.
+        if (unitChanged) {
+            for (auto& elem : oldElements)
+                changed.append(&elem);
+            for (auto& elem : newElements)
+                changed.append(&elem);
+        }
+        else {
+            for (auto [elem, old] : matched)
+                newToOld[elem] = old;
+        }
+    }
+
+    // If we haven't been checked ourselves, the only diagnostics we have are the ones
+    // that were carried over into this compilation, which can be passed along again
+    // for any of the elements they came with that are still unaffected.
+    bool chained = !cachedSemanticDiagnostics;
+    if (chained && reusedElements.empty())
+        return result;
+
+    if (!chained) {
+        // If checking stopped early we can't know whether we have all of the
+        // diagnostics for any given element, so there's nothing to carry over.
+        if (options.errorLimit && numErrors > options.errorLimit)
+            return result;
+
+        for (auto& diag : *cachedSemanticDiagnostics) {
+            if (diag.code == diag::InfinitelyRecursiveHierarchy ||
+                diag.code == diag::MaxInstanceDepthExceeded) {
+                return result;
+            }
+        }
+    }
+
+    // Find the elements that could be skipped, keyed by their old version. Diagnostics
+    // that were carried over already have the path of the instance they were coalesced to.
+    struct Candidate {
+        const Element* element = nullptr;
+        ptrdiff_t shift = 0;
+        std::vector<std::pair<const Diagnostic*, const std::string*>> diags;
+        bool valid = true;
+    };
+
+    auto affected = newGraph.getAffected(changed);
+    flat_hash_map<const Element*, Candidate> candidates;
+    flat_hash_map<uint32_t, std::vector<std::pair<size_t, const Element*>>> candidatesByBuffer;
+    for (auto& tree : result->syntaxTrees) {
+        for (auto& elem : newGraph.getElements(*tree)) {
+            if (!ModuleDeclarationSyntax::isKind(elem.kind) || !elem.isSelfContained ||
+                affected.find(&elem) != affected.end()) {
+                continue;
+            }
+
+            auto old = &elem;
+            if (newTrees.find(tree.get()) != newTrees.end()) {
+                auto it = newToOld.find(&elem);
+                if (it == newToOld.end())
+                    continue;
+                old = it->second;
+            }
+
+            if (chained && reusedElements.find(old->syntax) == reusedElements.end())
+                continue;
+
+            auto& candidate = candidates[old];
+            candidate.element = &elem;
+            candidate.shift = ptrdiff_t(elem.range.start().offset()) -
+                              ptrdiff_t(old->range.start().offset());
+
+            auto start = old->range.start();
+            candidatesByBuffer[start.buffer().getId()].emplace_back(start.offset(), old);
+        }
+    }
+
+    for (auto& [id, list] : candidatesByBuffer)
+        std::sort(list.begin(), list.end());
+
+    // Attribute each of our diagnostics to the element it's located in.
+    auto attribute = [&](const Diagnostic& diag, const std::string* path) {
+        auto loc = diag.location;
+        auto listIt = candidatesByBuffer.find(loc.buffer().getId());
+        if (!loc.valid() || listIt == candidatesByBuffer.end())
+            return;
+
+        auto& list = listIt->second;
+        auto it = std::upper_bound(list.begin(), list.end(),
+                                   std::make_pair(loc.offset(), (const Element*)nullptr),
+                                   [](auto& a, auto& b) { return a.first < b.first; });
+        if (it == list.begin())
+            return;
+
+        auto old = std::prev(it)->second;
+        if (loc.offset() > old->range.end().offset())
+            return;
+
+        // Diagnostics from global checks get recomputed from scratch.
+        if (diag.code == diag::UnusedDefinition || diag.code == diag::TopModuleIfacePort ||
+            diag.code == diag::TopModuleRefPort || diag.code == diag::TopModuleUnnamedRefPort) {
+            return;
+        }
+
+        auto& candidate = candidates[old];
+        if (canCarryDiag(diag, old->range))
+            candidate.diags.emplace_back(&diag, path);
+        else
+            candidate.valid = false;
+    };
+
+    if (chained) {
+        for (auto& [diag, path] : carriedDiagnostics)
+            attribute(diag, &path);
+    }
+    else {
+        for (auto& diag : *cachedSemanticDiagnostics)
+            attribute(diag, nullptr);
+    }
+
+    for (auto& [old, candidate] : candidates) {
+        if (!candidate.valid)
+            continue;
+
+        result->reusedElements.emplace(candidate.element->syntax);
+        for (auto [diag, carriedPath] : candidate.diags) {
+            std::string path;
+            if (carriedPath)
+                path = *carriedPath;
+            else if (diag->coalesceCount && diag->symbol)
+                diag->symbol->getHierarchicalPath(path);
+
+            Diagnostic copy = *diag;
+            relocateDiag(copy, candidate.element->range.start().buffer(), candidate.shift);
+            result->carriedDiagnostics.emplace_back(std::move(copy), std::move(path));
+        }
+    }
+
+    return result;
+}
+
 span<const CompilationUnitSymbol* const> Compilation::getCompilationUnits() const {
     return compilationUnits;
 }
@@ -311,7 +589,7 @@ const RootSymbol& Compilation::getRoot(bool skipDefParamResolution) {
     else {
         // If the list of top modules has already been provided we just need to
         // find and instantiate them.
-        auto& tm = options.topModules;
+        auto tm = options.topModules;
         for (auto& [key, definition] : definitionMap) {
             if (std::get<1>(key) != root.get())
                 continue;
@@ -795,8 +1073,10 @@ const Diagnostics& Compilation::getSemanticDiagnostics() {
     // If we haven't already done so, touch every symbol, scope, statement,
     // and expression tree so that we can be sure we have all the diagnostics.
     DiagnosticVisitor visitor(*this, numErrors,
-                              options.errorLimit == 0 ? UINT32_MAX : options.errorLimit);
+                              options.errorLimit == 0 ? UINT32_MAX : options.errorLimit,
+                              &reusedElements);
     getRoot().visit(visitor);
+    fullyElaborated = !visitor.stoppedEarly() && reusedElements.empty();
     visitor.finalize();
 
     // Check all DPI methods for correctness.
@@ -917,6 +1197,36 @@ const Diagnostics& Compilation::getSemanticDiagnostics() {
         }
     }
 
+    // Add in diagnostics carried over from a previous compilation for elements
+    // that we skipped checking, unless we happened to issue them again anyway.
+    for (auto& [diag, path] : carriedDiagnostics) {
+        if (diagMap.find({ diag.code, diag.location }) != diagMap.end())
+            continue;
+
+        Diagnostic copy = diag;
+        if (!path.empty()) {
+            // Find the instance in our own hierarchy that the diagnostic was coalesced to.
+            Diagnostics localDiags;
+            auto& name = tryParseName(path, localDiags);
+
+            LookupResult lookupResult;
+            if (localDiags.empty()) {
+                BindContext context(*root, LookupLocation::max);
+                Lookup::name(name, context, LookupFlags::None, lookupResult);
+            }
+
+            if (lookupResult.found && lookupResult.selectors.empty() &&
+                lookupResult.found->kind == SymbolKind::Instance) {
+                copy.symbol = lookupResult.found;
+            }
+            else {
+                copy.coalesceCount.reset();
+            }
+        }
+
+        results.emplace(std::move(copy));
+    }
+
     if (sourceManager)
         results.sort(*sourceManager);
 
@@ -1016,12 +1326,133 @@ const Type& Compilation::getType(bitwidth_t width, bitmask<IntegralFlags> flags)
     if (it != vectorTypeCache.end())
         return *it->second;
 
-    auto type =
-        emplace<PackedArrayType>(getScalarType(flags), ConstantRange{ int32_t(width - 1), 0 });
-    vectorTypeCache.emplace_hint(it, key, type);
+    auto& type = getPackedArrayType(getScalarType(flags), ConstantRange{ int32_t(width - 1), 0 });
+    vectorTypeCache.emplace_hint(it, key, &type);
+    return type;
+}
+
+const Type& Compilation::getPackedArrayType(const Type& elementType, ConstantRange range,
+                                            const SyntaxNode* syntax) {
+    auto key = std::make_tuple(SymbolKind::PackedArrayType, &elementType, range.left, range.right);
+    auto it = arrayTypeCache.find(key);
+    if (it != arrayTypeCache.end())
+        return *it->second;
+
+    auto type = emplace<PackedArrayType>(elementType, range);
+    if (syntax)
+        type->setSyntax(*syntax);
+
+    arrayTypeCache.emplace_hint(it, key, type);
+    return *type;
+}
+
+const Type& Compilation::getUnpackedArrayType(const Type& elementType, ConstantRange range,
+                                              const SyntaxNode* syntax) {
+    auto key = std::make_tuple(SymbolKind::FixedSizeUnpackedArrayType, &elementType, range.left,
+                               range.right);
+    auto it = arrayTypeCache.find(key);
+    if (it != arrayTypeCache.end())
+        return *it->second;
+
+    auto type = emplace<FixedSizeUnpackedArrayType>(elementType, range);
+    if (syntax)
+        type->setSyntax(*syntax);
+
+    arrayTypeCache.emplace_hint(it, key, type);
     return *type;
 }
 
+optional<bool> Compilation::findTypeRelation(TypeRelation relation, const Type& left,
+                                             const Type& right) {
+    std::shared_lock lock(typeRelationMutex);
+    auto it = typeRelationCache.find(std::make_tuple(&left, &right, relation));
+    if (it == typeRelationCache.end()) {
+        typeRelationMisses.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+
+    typeRelationHits.fetch_add(1, std::memory_order_relaxed);
+    return it->second;
+}
+
+void Compilation::cacheTypeRelation(TypeRelation relation, const Type& left, const Type& right,
+                                    bool result) {
+    std::unique_lock lock(typeRelationMutex);
+    typeRelationCache.emplace(std::make_tuple(&left, &right, relation), result);
+}
+
+Compilation::TypeRelationStats Compilation::getTypeRelationStats() const {
+    TypeRelationStats result;
+    result.hits = typeRelationHits.load(std::memory_order_relaxed);
+    result.misses = typeRelationMisses.load(std::memory_order_relaxed);
+    return result;
+}
+
+Compilation::ElaborationCounters Compilation::getElaborationCounters() const {
+    ElaborationCounters result;
+    result.lookups = lookupCount.load(std::memory_order_relaxed);
+    result.typesCreated = typeCount.load(std::memory_order_relaxed);
+    result.evalSteps = evalStepCount.load(std::memory_order_relaxed);
+    return result;
+}
+
+const Compilation::DefinitionStats* Compilation::getDefinitionStats(
+    const Definition& definition) const {
+    auto it = definitionStats.find(&definition);
+    if (it == definitionStats.end())
+        return nullptr;
+    return &it->second;
+}
+
+void Compilation::switchStatsDefinition(const Definition* definition) {
+    size_t bytes = getBytesAllocated();
+    if (statsDefinition)
+        definitionStats[statsDefinition].bytesAllocated += bytes - statsBytesCheckpoint;
+
+    statsBytesCheckpoint = bytes;
+    statsDefinition = definition;
+}
+
+Compilation::DefinitionStatsScope::DefinitionStatsScope(Compilation& compilation,
+                                                        const Definition& definition) {
+    if (!compilation.options.collectStats)
+        return;
+
+    this->compilation = &compilation;
+    savedDefinition = compilation.statsDefinition;
+    compilation.switchStatsDefinition(&definition);
+}
+
+Compilation::DefinitionStatsScope::~DefinitionStatsScope() {
+    if (compilation)
+        compilation->switchStatsDefinition(savedDefinition);
+}
+
+// Nesting depth of constant evaluation timers. This is per thread, since
+// expressions can also be evaluated by visitors running in parallel.
+static thread_local uint32_t constEvalDepth = 0;
+
+Compilation::ConstEvalTimer::ConstEvalTimer(Compilation& compilation) {
+    if (!compilation.options.collectStats || constEvalDepth++ > 0)
+        return;
+
+    this->compilation = &compilation;
+    start = std::chrono::steady_clock::now();
+}
+
+Compilation::ConstEvalTimer::~ConstEvalTimer() {
+    // Nested timers always finish before the outermost one, so only
+    // the outermost timer needs to reset the depth.
+    if (!compilation)
+        return;
+
+    constEvalDepth = 0;
+    if (auto def = compilation->statsDefinition) {
+        compilation->definitionStats[def].constEvalTime +=
+            std::chrono::steady_clock::now() - start;
+    }
+}
+
 const Type& Compilation::getScalarType(bitmask<IntegralFlags> flags) {
     Type* ptr = scalarTypeTable[flags.bits() & 0x7];
     ASSERT(ptr);
@@ -1058,15 +1489,15 @@ Scope::DeferredMemberData& Compilation::getOrAddDeferredData(Scope::DeferredMemb
 
 void Compilation::trackImport(Scope::ImportDataIndex& index, const WildcardImportSymbol& import) {
     if (index != Scope::ImportDataIndex::Invalid)
-        importData[index].push_back(&import);
+        importData[index].imports.push_back(&import);
     else
-        index = importData.add({ &import });
+        index = importData.add({ { &import }, {} });
 }
 
 span<const WildcardImportSymbol*> Compilation::queryImports(Scope::ImportDataIndex index) {
     if (index == Scope::ImportDataIndex::Invalid)
         return {};
-    return importData[index];
+    return importData[index].imports;
 }
 
 void Compilation::parseParamOverrides(flat_hash_map<string_view, const ConstantValue*>& results) {
@@ -0,0 +1,305 @@
+//------------------------------------------------------------------------------
+// DependencyGraph.cpp
+// Tracking of dependencies between design elements
+//
+// File is under the MIT license; see LICENSE for details
+//------------------------------------------------------------------------------
+#include "slang/compilation/DependencyGraph.h"
+
+#include "slang/syntax/AllSyntax.h"
+#include "slang/syntax/SyntaxTree.h"
+#include "slang/syntax/SyntaxVisitor.h"
+#include "slang/text/SourceManager.h"
+
+namespace {
+
+using namespace slang;
+using Element = DependencyGraph::Element;
+
+struct ElementScanner : public SyntaxVisitor<ElementScanner> {
+    ElementScanner(const SourceManager& sourceManager, Element& element, BufferID buffer) :
+        sourceManager(sourceManager), element(element), buffer(buffer) {}
+
+    void handle(const ScopedNameSyntax& syntax) {
+        if (syntax.separator.kind == TokenKind::Dot)
+            element.hasHierarchicalRefs = true;
+        visitDefault(syntax);
+    }
+
+    void handle(const DefParamSyntax& syntax) { noteGlobal(syntax); }
+    void handle(const BindDirectiveSyntax& syntax) { noteGlobal(syntax); }
+    void handle(const DPIImportSyntax& syntax) { noteGlobal(syntax); }
+    void handle(const DPIExportSyntax& syntax) { noteGlobal(syntax); }
+
+    void visitToken(Token token) {
+        for (auto& trivia : token.trivia()) {
+            if (trivia.kind == TriviaKind::Directive)
+                element.isSelfContained = false;
+        }
+
+        auto loc = token.location();
+        if (loc.buffer() != buffer || !sourceManager.isFileLoc(loc))
+            element.isSelfContained = false;
+
+        if (token.kind == TokenKind::Identifier)
+            element.references.emplace(token.valueText());
+        else if (token.kind == TokenKind::RootSystemName)
+            element.hasHierarchicalRefs = true;
+    }
+
+private:
+    void noteGlobal(const SyntaxNode& syntax) {
+        element.hasGlobalEffects = true;
+        visitDefault(syntax);
+    }
+
+    const SourceManager& sourceManager;
+    Element& element;
+    BufferID buffer;
+};
+
+void scan(const SourceManager& sourceManager, Element& element, const SyntaxNode& syntax) {
+    Token first = syntax.getFirstToken();
+    ElementScanner scanner(sourceManager, element, first.location().buffer());
+    syntax.visit(scanner);
+
+    hash_combine(element.hash, std::hash<std::string>()(syntax.toString()));
+}
+
+Element makeElement(const SyntaxTree& tree, const SyntaxNode& syntax, Token name) {
+    Element element;
+    element.name = name.valueText();
+    element.kind = syntax.kind;
+    element.syntax = &syntax;
+    element.tree = &tree;
+
+    auto& sm = tree.sourceManager();
+    scan(sm, element, syntax);
+
+    // Parser state that was in effect for the declaration affects
+    // how it gets elaborated, so it needs to be part of the hash too.
+    auto& nodeMap = tree.getMetadata().nodeMap;
+    if (auto it = nodeMap.find(&syntax); it != nodeMap.end()) {
+        auto& meta = it->second;
+        hash_combine(element.hash, meta.defaultNetType, meta.unconnectedDrive,
+                     meta.timeScale.has_value());
+        if (meta.timeScale) {
+            auto& ts = *meta.timeScale;
+            hash_combine(element.hash, ts.base.unit, ts.base.magnitude, ts.precision.unit,
+                         ts.precision.magnitude);
+        }
+    }
+
+    if (element.isSelfContained) {
+        Token first = syntax.getFirstToken();
+        Token last = syntax.getLastToken();
+        element.range = SourceRange(first.location(), last.location() + last.rawText().length());
+    }
+
+    return element;
+}
+
+} // namespace
+
+namespace slang {
+
+bool DependencyGraph::Element::isInstantiable() const {
+    switch (kind) {
+        case SyntaxKind::ModuleDeclaration:
+        case SyntaxKind::InterfaceDeclaration:
+        case SyntaxKind::ProgramDeclaration:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void DependencyGraph::addTree(const SyntaxTree& tree) {
+    auto elements = std::make_shared<std::vector<Element>>();
+
+    Element unit;
+    unit.kind = SyntaxKind::CompilationUnit;
+    unit.syntax = &tree.root();
+    unit.tree = &tree;
+
+    auto addMember = [&](const SyntaxNode& member) {
+        if (ModuleDeclarationSyntax::isKind(member.kind)) {
+            auto& decl = member.as<ModuleDeclarationSyntax>();
+            elements->emplace_back(makeElement(tree, decl, decl.header->name));
+        }
+        else if (member.kind == SyntaxKind::UdpDeclaration) {
+            auto& decl = member.as<UdpDeclarationSyntax>();
+            elements->emplace_back(makeElement(tree, decl, decl.name));
+        }
+        else {
+            scan(tree.sourceManager(), unit, member);
+        }
+    };
+
+    auto& root = tree.root();
+    if (root.kind == SyntaxKind::CompilationUnit) {
+        for (auto member : root.as<CompilationUnitSyntax>().members)
+            addMember(*member);
+    }
+    else {
+        addMember(root);
+    }
+
+    elements->emplace_back(std::move(unit));
+    elementsByTree[&tree] = std::move(elements);
+}
+
+void DependencyGraph::removeTree(const SyntaxTree& tree) {
+    elementsByTree.erase(&tree);
+}
+
+span<const DependencyGraph::Element> DependencyGraph::getElements(const SyntaxTree& tree) const {
+    auto it = elementsByTree.find(&tree);
+    if (it == elementsByTree.end())
+        return {};
+
+    return *it->second;
+}
+
+flat_hash_set<const DependencyGraph::Element*> DependencyGraph::getAffected(
+    span<const Element* const> changed) const {
+
+    // Index the elements by name so that we can find them from references.
+    flat_hash_map<string_view, std::vector<const Element*>> elementsByName;
+    for (auto& [tree, elements] : elementsByTree) {
+        for (auto& elem : *elements) {
+            if (!elem.isCompilationUnit())
+                elementsByName[elem.name].push_back(&elem);
+        }
+    }
+
+    // Finds every instantiable element beneath the given starting elements.
+    auto visitDown = [&](flat_hash_set<const Element*>& visited,
+                         SmallVector<const Element*>& queue) {
+        while (!queue.empty()) {
+            auto elem = queue.back();
+            queue.pop();
+
+            for (auto name : elem->references) {
+                auto it = elementsByName.find(name);
+                if (it == elementsByName.end())
+                    continue;
+
+                for (auto child : it->second) {
+                    if (child->isInstantiable() && visited.emplace(child).second)
+                        queue.append(child);
+                }
+            }
+        }
+    };
+
+    // Build the reverse edges, from the names of elements to their users. Elements
+    // that may contain hierarchical references are considered to use everything
+    // that they instantiate, directly or otherwise.
+    flat_hash_map<string_view, std::vector<const Element*>> usersByName;
+    for (auto elem : changed) {
+        if (!elem->isCompilationUnit())
+            usersByName.emplace(elem->name, std::vector<const Element*>());
+    }
+    for (auto& [name, list] : elementsByName)
+        usersByName.emplace(name, std::vector<const Element*>());
+
+    for (auto& [tree, elements] : elementsByTree) {
+        for (auto& elem : *elements) {
+            for (auto name : elem.references) {
+                if (auto it = usersByName.find(name); it != usersByName.end())
+                    it->second.push_back(&elem);
+            }
+
+            if (elem.hasHierarchicalRefs) {
+                flat_hash_set<const Element*> below;
+                SmallVectorSized<const Element*, 8> queue;
+                queue.append(&elem);
+                visitDown(below, queue);
+
+                for (auto child : below)
+                    usersByName[child->name].push_back(&elem);
+            }
+        }
+    }
+
+    // Finds every element that transitively depends on the starting elements.
+    auto visitUp = [&](flat_hash_set<const Element*>& visited,
+                       SmallVector<const Element*>& queue) {
+        auto add = [&](const Element* user) {
+            if (visited.emplace(user).second)
+                queue.append(user);
+        };
+
+        while (!queue.empty()) {
+            auto elem = queue.back();
+            queue.pop();
+
+            if (elem->isCompilationUnit()) {
+                // Everything in a compilation unit can see its declarations.
+                if (auto it = elementsByTree.find(elem->tree); it != elementsByTree.end()) {
+                    for (auto& user : *it->second)
+                        add(&user);
+                }
+            }
+            else if (auto it = usersByName.find(elem->name); it != usersByName.end()) {
+                for (auto user : it->second)
+                    add(user);
+            }
+        }
+    };
+
+    flat_hash_set<const Element*> affected;
+    SmallVectorSized<const Element*, 8> queue;
+    for (auto elem : changed) {
+        if (affected.emplace(elem).second)
+            queue.append(elem);
+    }
+    visitUp(affected, queue);
+
+    // Packages, interfaces and compilation unit declarations can feed constant values
+    // into parameters of instances below anything that uses them. Elements that are
+    // merely instantiating a changed module don't change what they pass to their
+    // other children, unless they can see into it via hierarchical references.
+    flat_hash_set<const Element*> tainted;
+    for (auto elem : changed) {
+        if (!elem->isInstantiable() || elem->kind == SyntaxKind::InterfaceDeclaration) {
+            if (tainted.emplace(elem).second)
+                queue.append(elem);
+        }
+    }
+    visitUp(tainted, queue);
+
+    for (auto elem : changed)
+        tainted.emplace(elem);
+
+    for (auto elem : affected) {
+        if (elem->hasHierarchicalRefs)
+            tainted.emplace(elem);
+    }
+
+    for (auto elem : tainted)
+        queue.append(elem);
+    visitDown(affected, queue);
+
+    bool isGlobal = false;
+    for (auto elem : affected) {
+        if (elem->hasGlobalEffects) {
+            isGlobal = true;
+            break;
+        }
+    }
+
+    // Only return elements that are actually part of this graph.
+    flat_hash_set<const Element*> results;
+    for (auto& [tree, elements] : elementsByTree) {
+        for (auto& elem : *elements) {
+            if (isGlobal || affected.find(&elem) != affected.end())
+                results.emplace(&elem);
+        }
+    }
+
+    return results;
+}
+
+} // namespace slang
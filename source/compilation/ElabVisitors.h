@@ -9,15 +9,21 @@
 #include "slang/diagnostics/CompilationDiags.h"
 #include "slang/diagnostics/DeclarationsDiags.h"
 #include "slang/symbols/ASTVisitor.h"
+#include "slang/syntax/AllSyntax.h"
 #include "slang/util/StackContainer.h"
 
 namespace slang {
 
 // This visitor is used to touch every node in the AST to ensure that all lazily
 // evaluated members have been realized and we have recorded every diagnostic.
+// Definitions and packages whose syntax is in the given set of reused elements
+// already have their diagnostics, so the visitor only walks through them to find
+// the instances beneath them.
 struct DiagnosticVisitor : public ASTVisitor<DiagnosticVisitor, false, false> {
-    DiagnosticVisitor(Compilation& compilation, const size_t& numErrors, uint32_t errorLimit) :
-        compilation(compilation), numErrors(numErrors), errorLimit(errorLimit) {}
+    DiagnosticVisitor(Compilation& compilation, const size_t& numErrors, uint32_t errorLimit,
+                      const flat_hash_set<const SyntaxNode*>* reusedElements = nullptr) :
+        compilation(compilation),
+        numErrors(numErrors), errorLimit(errorLimit), reusedElements(reusedElements) {}
 
     template<typename T>
     void handle(const T& symbol) {
@@ -29,6 +35,11 @@ struct DiagnosticVisitor : public ASTVisitor<DiagnosticVisitor, false, false> {
         if (numErrors > errorLimit || hierarchyProblem)
             return false;
 
+        if (inReusedElement) {
+            visitDefault(symbol);
+            return false;
+        }
+
         if constexpr (std::is_base_of_v<Symbol, T>) {
             auto declaredType = symbol.getDeclaredType();
             if (declaredType) {
@@ -71,12 +82,12 @@ struct DiagnosticVisitor : public ASTVisitor<DiagnosticVisitor, false, false> {
     }
 
     void handle(const InterfacePortSymbol& symbol) {
+        if (symbol.interfaceDef)
+            usedIfacePorts.emplace(symbol.interfaceDef);
+
         if (!handleDefault(symbol))
             return;
         symbol.getDeclaredRange();
-
-        if (symbol.interfaceDef)
-            usedIfacePorts.emplace(symbol.interfaceDef);
     }
 
     void handle(const PortSymbol& symbol) {
@@ -210,21 +221,27 @@ struct DiagnosticVisitor : public ASTVisitor<DiagnosticVisitor, false, false> {
         symbol.getDefaultOutputSkew();
     }
 
+    // Returns true if the visit skipped part of the design, either because the error
+    // limit was reached or because of a problem with the instance hierarchy.
+    bool stoppedEarly() const { return numErrors > errorLimit || hierarchyProblem; }
+
     void handle(const InstanceSymbol& symbol) {
         if (numErrors > errorLimit || hierarchyProblem)
             return;
 
         instanceCount[&symbol.getDefinition()]++;
 
-        for (auto attr : compilation.getAttributes(symbol))
-            attr->getValue();
-
-        symbol.forEachPortConnection([&](auto& conn) {
-            conn.getExpression();
-            conn.checkSimulatedNetTypes();
-            for (auto attr : compilation.getAttributes(conn))
+        if (!inReusedElement) {
+            for (auto attr : compilation.getAttributes(symbol))
                 attr->getValue();
-        });
+
+            symbol.forEachPortConnection([&](auto& conn) {
+                conn.getExpression();
+                conn.checkSimulatedNetTypes();
+                for (auto attr : compilation.getAttributes(conn))
+                    attr->getValue();
+            });
+        }
 
         // Detect infinite recursion, which happens if we see this exact
         // instance body somewhere higher up in the stack.
@@ -248,7 +265,17 @@ struct DiagnosticVisitor : public ASTVisitor<DiagnosticVisitor, false, false> {
             return;
         }
 
+        bool wasReused = std::exchange(inReusedElement,
+                                       isReused(symbol.getDefinition().syntax));
+        Compilation::DefinitionStatsScope statsScope(compilation, symbol.getDefinition());
         visit(symbol.body);
+        inReusedElement = wasReused;
+    }
+
+    void handle(const PackageSymbol& symbol) {
+        bool wasReused = std::exchange(inReusedElement, isReused(*symbol.getSyntax()));
+        handleDefault(symbol);
+        inReusedElement = wasReused;
     }
 
     void handle(const GenerateBlockSymbol& symbol) {
@@ -335,6 +362,10 @@ struct DiagnosticVisitor : public ASTVisitor<DiagnosticVisitor, false, false> {
         }
     }
 
+    bool isReused(const SyntaxNode& syntax) const {
+        return reusedElements && reusedElements->find(&syntax) != reusedElements->end();
+    }
+
     Compilation& compilation;
     const size_t& numErrors;
     flat_hash_map<const Definition*, size_t> instanceCount;
@@ -343,7 +374,9 @@ struct DiagnosticVisitor : public ASTVisitor<DiagnosticVisitor, false, false> {
     uint32_t errorLimit;
     SmallVectorSized<const GenericClassDefSymbol*, 8> genericClasses;
     SmallVectorSized<const SubroutineSymbol*, 4> dpiImports;
+    const flat_hash_set<const SyntaxNode*>* reusedElements;
     bool hierarchyProblem = false;
+    bool inReusedElement = false;
 };
 
 // This visitor is for finding all bind directives in the hierarchy.
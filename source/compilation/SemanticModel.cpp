@@ -6,9 +6,14 @@
 //------------------------------------------------------------------------------
 #include "slang/compilation/SemanticModel.h"
 
+#include <algorithm>
+
 #include "slang/compilation/Compilation.h"
 #include "slang/compilation/Definition.h"
+#include "slang/symbols/ASTVisitor.h"
 #include "slang/syntax/AllSyntax.h"
+#include "slang/text/Json.h"
+#include "slang/text/SourceManager.h"
 
 namespace slang {
 
@@ -121,4 +126,234 @@ const TypeAliasType* SemanticModel::getDeclaredSymbol(const TypedefDeclarationSy
     return result ? &result->as<TypeAliasType>() : nullptr;
 }
 
+struct SymbolIndexBuilder : public ASTVisitor<SymbolIndexBuilder, true, true> {
+    SemanticModel& model;
+
+    explicit SymbolIndexBuilder(SemanticModel& model) : model(model) {}
+
+    template<typename T>
+    void handle(const T& t) {
+        if constexpr (std::is_base_of_v<Symbol, T>) {
+            if (!t.name.empty() && t.location) {
+                model.addIndexEntry(SourceRange(t.location, t.location + t.name.length()), t);
+            }
+        }
+        else if constexpr (std::is_base_of_v<ValueExpressionBase, T>) {
+            model.addReference(t, t.sourceRange, t.symbol);
+        }
+        else if constexpr (std::is_same_v<CallExpression, T>) {
+            if (!t.isSystemCall()) {
+                // Only the name of the subroutine refers to it, not the arguments.
+                SourceRange range = t.sourceRange;
+                if (t.syntax && t.syntax->kind == SyntaxKind::InvocationExpression)
+                    range = t.syntax->template as<InvocationExpressionSyntax>()
+                                .left->getLastToken()
+                                .range();
+
+                model.addReference(t, range, *std::get<0>(t.subroutine));
+            }
+        }
+
+        visitDefault(t);
+    }
+};
+
+void SemanticModel::addIndexEntry(SourceRange range, const Symbol& symbol) {
+    // Map macro expanded ranges back to where the text was actually written.
+    if (auto sm = compilation.getSourceManager()) {
+        range = SourceRange(sm->getFullyOriginalLoc(range.start()),
+                            sm->getFullyOriginalLoc(range.end()));
+    }
+
+    if (range.start().buffer() != range.end().buffer() || range.end() < range.start())
+        return;
+
+    auto& index = locationIndex[range.start().buffer()];
+    if (!index.entries.empty() && index.entries.back().start > range.start().offset())
+        index.sorted = false;
+
+    index.entries.push_back({ range.start().offset(), range.end().offset(), &symbol });
+}
+
+void SemanticModel::addReference(const Expression& expr, SourceRange range,
+                                 const Symbol& symbol) {
+    referenceIndex[&symbol].push_back(&expr);
+    addIndexEntry(range, symbol);
+}
+
+void SemanticModel::addToIndex(const Symbol& symbol) {
+    if (!indexedSymbols.emplace(&symbol).second)
+        return;
+
+    SymbolIndexBuilder builder(*this);
+    symbol.visit(builder);
+}
+
+void SemanticModel::ensureIndex() {
+    if (!indexBuilt) {
+        indexBuilt = true;
+        addToIndex(compilation.getRoot());
+    }
+}
+
+const Symbol* SemanticModel::getSymbolAt(SourceLocation location) {
+    ensureIndex();
+
+    auto it = locationIndex.find(location.buffer());
+    if (it == locationIndex.end())
+        return nullptr;
+
+    auto& index = it->second;
+    auto& entries = index.entries;
+    sortIndex(index);
+
+    // Find the last entry that starts at or before the location; entries for
+    // identifiers don't overlap, so that's the only one that can contain it.
+    size_t offset = location.offset();
+    auto entryIt = std::upper_bound(entries.begin(), entries.end(), offset,
+                                    [](size_t o, const IndexEntry& e) { return o < e.start; });
+    if (entryIt == entries.begin())
+        return nullptr;
+
+    --entryIt;
+    if (offset >= entryIt->end)
+        return nullptr;
+
+    // Prefer the first entry added at this spot, which is the first instance elaborated.
+    size_t start = entryIt->start;
+    while (entryIt != entries.begin() && std::prev(entryIt)->start == start)
+        --entryIt;
+
+    return entryIt->symbol;
+}
+
+span<const Expression* const> SemanticModel::getReferences(const Symbol& symbol) {
+    ensureIndex();
+
+    auto it = referenceIndex.find(&symbol);
+    if (it == referenceIndex.end())
+        return {};
+
+    return it->second;
+}
+
+void SemanticModel::serializeIndex(JsonWriter& writer) {
+    ensureIndex();
+
+    // Everything is written in a fixed order, by file and offset for locations and by
+    // hierarchical path for symbols, so that the output doesn't change from run to run.
+    auto sm = compilation.getSourceManager();
+    auto bufferLess = [&](BufferID a, BufferID b) {
+        if (sm && a != b) {
+            auto nameA = sm->getRawFileName(a);
+            auto nameB = sm->getRawFileName(b);
+            if (nameA != nameB)
+                return nameA < nameB;
+        }
+        return a < b;
+    };
+
+    auto locationLess = [&](SourceLocation a, SourceLocation b) {
+        if (a.buffer() != b.buffer())
+            return bufferLess(a.buffer(), b.buffer());
+        return a.offset() < b.offset();
+    };
+
+    auto writeLocation = [&](SourceLocation loc) {
+        if (!sm)
+            return;
+
+        writer.writeProperty("file");
+        writer.writeValue(sm->getFileName(loc));
+        writer.writeProperty("line");
+        writer.writeValue(uint64_t(sm->getLineNumber(loc)));
+        writer.writeProperty("column");
+        writer.writeValue(uint64_t(sm->getColumnNumber(loc)));
+    };
+
+    auto getPath = [](const Symbol& symbol) {
+        std::string path;
+        symbol.getHierarchicalPath(path);
+        return path;
+    };
+
+    auto writeSymbol = [&](const Symbol& symbol, const std::string& path) {
+        writer.writeProperty("symbol");
+        writer.writeValue(path);
+        writer.writeProperty("kind");
+        writer.writeValue(toString(symbol.kind));
+    };
+
+    std::vector<BufferID> buffers;
+    for (auto& [buffer, _] : locationIndex)
+        buffers.push_back(buffer);
+    std::sort(buffers.begin(), buffers.end(), bufferLess);
+
+    writer.startObject();
+    writer.writeProperty("locations");
+    writer.startArray();
+    for (auto buffer : buffers) {
+        // Entries at the same offset stay in the order they were elaborated.
+        auto& index = locationIndex[buffer];
+        sortIndex(index);
+        for (auto& entry : index.entries) {
+            writer.startObject();
+            writeSymbol(*entry.symbol, getPath(*entry.symbol));
+            writeLocation(SourceLocation(buffer, entry.start));
+            writer.writeProperty("length");
+            writer.writeValue(uint64_t(entry.end - entry.start));
+            writer.endObject();
+        }
+    }
+    writer.endArray();
+
+    struct Reference {
+        std::string path;
+        const Symbol* symbol;
+        std::vector<const Expression*> uses;
+    };
+
+    std::vector<Reference> references;
+    for (auto& [symbol, exprs] : referenceIndex)
+        references.push_back({ getPath(*symbol), symbol, exprs });
+
+    // Different symbols can share a path (such as those in unnamed blocks),
+    // so break ties with their declaration locations.
+    std::sort(references.begin(), references.end(), [&](const Reference& a, const Reference& b) {
+        if (a.path != b.path)
+            return a.path < b.path;
+        return locationLess(a.symbol->location, b.symbol->location);
+    });
+
+    writer.writeProperty("references");
+    writer.startArray();
+    for (auto& ref : references) {
+        std::stable_sort(ref.uses.begin(), ref.uses.end(), [&](auto a, auto b) {
+            return locationLess(a->sourceRange.start(), b->sourceRange.start());
+        });
+
+        writer.startObject();
+        writeSymbol(*ref.symbol, ref.path);
+        writer.writeProperty("uses");
+        writer.startArray();
+        for (auto expr : ref.uses) {
+            writer.startObject();
+            writeLocation(expr->sourceRange.start());
+            writer.endObject();
+        }
+        writer.endArray();
+        writer.endObject();
+    }
+    writer.endArray();
+    writer.endObject();
+}
+
+void SemanticModel::sortIndex(BufferIndex& index) {
+    if (!index.sorted) {
+        std::stable_sort(index.entries.begin(), index.entries.end(),
+                         [](const IndexEntry& a, const IndexEntry& b) { return a.start < b.start; });
+        index.sorted = true;
+    }
+}
+
 } // namespace slang
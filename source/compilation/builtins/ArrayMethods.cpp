@@ -5,10 +5,12 @@
 // File is under the MIT license; see LICENSE for details
 //------------------------------------------------------------------------------
 #include "slang/binding/MiscExpressions.h"
+#include "slang/binding/OperatorExpressions.h"
 #include "slang/binding/SystemSubroutine.h"
 #include "slang/compilation/Compilation.h"
 #include "slang/diagnostics/ConstEvalDiags.h"
 #include "slang/diagnostics/SysFuncsDiags.h"
+#include "slang/symbols/ASTVisitor.h"
 #include "slang/symbols/VariableSymbols.h"
 #include "slang/util/Function.h"
 
@@ -157,30 +159,53 @@ public:
             auto guard = context.disableCaching();
             auto iterVal = context.createLocal(iterVar);
 
+            // Evaluate the key expression exactly once per element up front and then
+            // sort a permutation of element indices by those keys. The sort is stable
+            // so that elements with equal keys keep their original relative order,
+            // for both sort and rsort.
             auto sortTarget = [&, ie = iterExpr](auto& target) {
-                auto pred = [&, ie = ie](ConstantValue& a, ConstantValue& b) {
-                    *iterVal = a;
-                    ConstantValue cva = ie->eval(context);
+                std::vector<ConstantValue> keys;
+                keys.reserve(target.size());
+                for (auto& elem : target) {
+                    *iterVal = elem;
+                    keys.emplace_back(ie->eval(context));
+                    if (!keys.back())
+                        return false;
+                }
 
-                    *iterVal = b;
-                    ConstantValue cvb = ie->eval(context);
+                std::vector<uint32_t> order(target.size());
+                for (uint32_t i = 0; i < order.size(); i++)
+                    order[i] = i;
 
-                    return cva < cvb;
-                };
+                if (reversed) {
+                    std::stable_sort(order.begin(), order.end(),
+                                     [&](uint32_t a, uint32_t b) { return keys[b] < keys[a]; });
+                }
+                else {
+                    std::stable_sort(order.begin(), order.end(),
+                                     [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+                }
 
-                if (reversed)
-                    std::sort(target.rbegin(), target.rend(), pred);
-                else
-                    std::sort(target.begin(), target.end(), pred);
+                std::vector<ConstantValue> sorted;
+                sorted.reserve(order.size());
+                for (auto i : order)
+                    sorted.emplace_back(std::move(target[i]));
+
+                std::move(sorted.begin(), sorted.end(), target.begin());
+                return true;
             };
 
+            bool ok;
             if (target->isQueue()) {
-                sortTarget(*target->queue());
+                ok = sortTarget(*target->queue());
             }
             else {
                 auto& vec = std::get<ConstantValue::Elements>(target->getVariant());
-                sortTarget(vec);
+                ok = sortTarget(vec);
             }
+
+            if (!ok)
+                return nullptr;
         }
         else {
             auto sortTarget = [&](auto& target) {
@@ -242,6 +267,69 @@ public:
     }
 };
 
+// Looks for references to an iterator variable, along with calls and side effects,
+// whose results may change from one evaluation to the next.
+struct IteratorDependencyVisitor : public ASTVisitor<IteratorDependencyVisitor, false, true> {
+    const ValueSymbol& iterVar;
+    bool found = false;
+
+    IteratorDependencyVisitor(const ValueSymbol& iterVar) : iterVar(iterVar) {}
+
+    void handle(const ValueExpressionBase& expr) {
+        if (&expr.symbol == &iterVar)
+            found = true;
+    }
+
+    void handle(const CallExpression&) { found = true; }
+    void handle(const AssignmentExpression&) { found = true; }
+
+    void handle(const UnaryExpression& expr) {
+        switch (expr.op) {
+            case UnaryOperator::Preincrement:
+            case UnaryOperator::Predecrement:
+            case UnaryOperator::Postincrement:
+            case UnaryOperator::Postdecrement:
+                found = true;
+                break;
+            default:
+                visitDefault(expr);
+                break;
+        }
+    }
+};
+
+// If the given locator predicate is just an equality comparison between the
+// iterator and some other expression that doesn't depend on it, returns
+// that comparison.
+static const BinaryExpression* getInvariantEquality(const Expression& expr,
+                                                    const ValueSymbol& iterVar) {
+    if (expr.kind != ExpressionKind::BinaryOp)
+        return nullptr;
+
+    auto& binary = expr.as<BinaryExpression>();
+    if (binary.op != BinaryOperator::Equality && binary.op != BinaryOperator::CaseEquality &&
+        binary.op != BinaryOperator::WildcardEquality) {
+        return nullptr;
+    }
+
+    auto isIter = [&](const Expression& e) {
+        return e.kind == ExpressionKind::NamedValue &&
+               &e.as<NamedValueExpression>().symbol == &iterVar;
+    };
+
+    const Expression* other;
+    if (isIter(binary.left()))
+        other = &binary.right();
+    else if (isIter(binary.right()))
+        other = &binary.left();
+    else
+        return nullptr;
+
+    IteratorDependencyVisitor visitor(iterVar);
+    other->visit(visitor);
+    return visitor.found ? nullptr : &binary;
+}
+
 class ArrayLocatorMethod : public SystemSubroutine {
 public:
     enum Mode { All, First, Last } mode;
@@ -288,17 +376,44 @@ public:
         if (!arr)
             return nullptr;
 
+        SVQueue results;
+        if (arr.empty())
+            return results;
+
         auto [iterExpr, iterVar] = callInfo.getIteratorInfo();
         auto guard = context.disableCaching();
         auto iterVal = context.createLocal(iterVar);
 
-        SVQueue results;
+        // For the very common case of a predicate that just compares each element
+        // against a fixed value, evaluate that value once and compare the elements
+        // directly instead of copying each one into the iterator and evaluating
+        // the whole predicate.
+        ConstantValue key;
+        bool iterOnLeft = false;
+        auto equality = getInvariantEquality(*iterExpr, *iterVar);
+        if (equality) {
+            iterOnLeft = equality->left().kind == ExpressionKind::NamedValue &&
+                         &equality->left().as<NamedValueExpression>().symbol == iterVar;
+            key = (iterOnLeft ? equality->right() : equality->left()).eval(context);
+            if (!key)
+                return nullptr;
+        }
+
+        auto matches = [&, ie = iterExpr](const ConstantValue& elem) {
+            if (equality) {
+                auto cv = iterOnLeft ? Expression::evalBinaryOperator(equality->op, elem, key)
+                                     : Expression::evalBinaryOperator(equality->op, key, elem);
+                return cv.isTrue();
+            }
+
+            *iterVal = elem;
+            return ie->eval(context).isTrue();
+        };
+
         if (arr.isMap()) {
-            auto doFind = [&, ie = iterExpr](auto it, auto end) {
+            auto doFind = [&](auto it, auto end) {
                 for (; it != end; it++) {
-                    *iterVal = it->second;
-                    ConstantValue cv = ie->eval(context);
-                    if (cv.isTrue()) {
+                    if (matches(it->second)) {
                         if (isIndexed)
                             results.emplace_back(it->first);
                         else
@@ -317,11 +432,9 @@ public:
                 doFind(std::begin(cont), std::end(cont));
         }
         else {
-            auto doFind = [&, ie = iterExpr](auto begin, auto end) {
+            auto doFind = [&](auto begin, auto end) {
                 for (auto it = begin; it != end; it++) {
-                    *iterVal = *it;
-                    ConstantValue cv = ie->eval(context);
-                    if (cv.isTrue()) {
+                    if (matches(*it)) {
                         if (isIndexed) {
                             auto dist = std::distance(begin, it);
                             if (mode == Last)
@@ -400,30 +513,28 @@ public:
         if (iterExpr) {
             ASSERT(iterVar);
 
+            // Each key is evaluated once; only the position of the best element
+            // is tracked so that it gets copied out a single time at the end.
             auto it = begin(arr);
             auto guard = context.disableCaching();
             auto iterVal = context.createLocal(iterVar, *it);
-            ConstantValue elem = *it;
             ConstantValue val = iterExpr->eval(context);
+            if (!val)
+                return nullptr;
 
+            auto best = it;
             for (++it; it != end(arr); ++it) {
                 *iterVal = *it;
                 auto cv = iterExpr->eval(context);
+                if (!cv)
+                    return nullptr;
 
-                if (isMin) {
-                    if (cv < val) {
-                        val = cv;
-                        elem = *it;
-                    }
-                }
-                else {
-                    if (val < cv) {
-                        val = cv;
-                        elem = *it;
-                    }
+                if (isMin ? cv < val : val < cv) {
+                    val = std::move(cv);
+                    best = it;
                 }
             }
-            result.emplace_back(std::move(elem));
+            result.emplace_back(std::move(*best));
         }
         else {
             auto it = begin(arr);
@@ -496,7 +607,10 @@ public:
             for (auto it = begin(arr); it != end(arr); ++it, ++index) {
                 *iterVal = *it;
                 auto cv = iterExpr->eval(context);
-                if (seen.emplace(cv).second) {
+                if (!cv)
+                    return nullptr;
+
+                if (seen.emplace(std::move(cv)).second) {
                     if (isIndexed && !arr.isMap())
                         result.emplace_back(SVInt(32, index, true));
                     else if (isIndexed)
@@ -7,6 +7,7 @@
 #include "slang/binding/SystemSubroutine.h"
 #include "slang/compilation/Compilation.h"
 #include "slang/diagnostics/SysFuncsDiags.h"
+#include "slang/mir/Procedure.h"
 #include "slang/symbols/ASTVisitor.h"
 #include "slang/symbols/MemberSymbols.h"
 
@@ -392,6 +393,47 @@ private:
     bool isFuture;
 };
 
+class FOpenFunc : public NonConstantFunction {
+public:
+    explicit FOpenFunc(Compilation& c) :
+        NonConstantFunction("$fopen", c.getIntType(), 1,
+                            std::vector{ &c.getStringType(), &c.getStringType() }) {}
+
+    mir::MIRValue lower(mir::Procedure& proc, const Args& args) const final {
+        auto name = lowerString(proc, *args[0]);
+        auto mode = args.size() > 1 ? lowerString(proc, *args[1]) : proc.emitString("");
+        auto callArgs = { name, mode };
+        return proc.emitCall(mir::SysCallKind::fileOpen, proc.getCompilation().getIntType(),
+                             callArgs);
+    }
+
+private:
+    static mir::MIRValue lowerString(mir::Procedure& proc, const Expression& arg) {
+        // File names and modes are almost always constant, so fold them
+        // directly into string constants when possible.
+        EvalContext context(proc.getCompilation());
+        ConstantValue cv = arg.eval(context);
+        if (cv)
+            cv = cv.convertToStr();
+
+        if (cv.isString())
+            return proc.emitString(std::string(cv.str()));
+
+        return proc.emitExpr(arg);
+    }
+};
+
+class FCloseFunc : public NonConstantFunction {
+public:
+    explicit FCloseFunc(Compilation& c) :
+        NonConstantFunction("$fclose", c.getVoidType(), 1, { &c.getIntType() }) {}
+
+    mir::MIRValue lower(mir::Procedure& proc, const Args& args) const final {
+        proc.emitCall(mir::SysCallKind::fileClose, proc.emitExpr(*args[0]));
+        return {};
+    }
+};
+
 void registerNonConstFuncs(Compilation& c) {
 #define REGISTER(...) c.addSystemSubroutine(std::make_unique<NonConstantFunction>(__VA_ARGS__))
 
@@ -406,8 +448,8 @@ void registerNonConstFuncs(Compilation& c) {
     REGISTER("$urandom", uintType, 0, intArg);
     REGISTER("$urandom_range", uintType, 1, std::vector<const Type*>{ &uintType, &uintType });
 
-    REGISTER("$fopen", intType, 1, std::vector{ &c.getStringType(), &c.getStringType() });
-    REGISTER("$fclose", c.getVoidType(), 1, intArg);
+    c.addSystemSubroutine(std::make_unique<FOpenFunc>(c));
+    c.addSystemSubroutine(std::make_unique<FCloseFunc>(c));
     REGISTER("$fgetc", intType, 1, intArg);
     REGISTER("$ungetc", intType, 2, std::vector{ &intType, &intType });
     REGISTER("$ftell", intType, 1, intArg);
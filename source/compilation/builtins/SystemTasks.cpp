@@ -61,8 +61,9 @@ public:
         return comp.getVoidType();
     }
 
-    void lower(mir::Procedure& proc, const Args& args) const final {
+    mir::MIRValue lower(mir::Procedure& proc, const Args& args) const final {
         FmtHelpers::lowerFormatArgs(proc, args, defaultIntFmt, /* newline */ true);
+        return {};
     }
 };
 
@@ -175,7 +176,11 @@ public:
 
 class FileDisplayTask : public SystemTaskBase {
 public:
-    using SystemTaskBase::SystemTaskBase;
+    LiteralBase defaultIntFmt;
+    bool newline;
+
+    FileDisplayTask(const std::string& name, LiteralBase defaultIntFmt, bool newline) :
+        SystemTaskBase(name), defaultIntFmt(defaultIntFmt), newline(newline) {}
 
     bool allowEmptyArgument(size_t index) const final { return index != 0; }
 
@@ -193,6 +198,12 @@ public:
 
         return comp.getVoidType();
     }
+
+    mir::MIRValue lower(mir::Procedure& proc, const Args& args) const final {
+        auto fd = proc.emitExpr(*args[0]);
+        FmtHelpers::lowerFormatArgs(proc, args.subspan(1), defaultIntFmt, newline, fd);
+        return {};
+    }
 };
 
 class FileMonitorTask : public FileDisplayTask {
@@ -713,24 +724,27 @@ void registerSystemTasks(Compilation& c) {
     REGISTER(DisplayTask, "$info", LiteralBase::Decimal);
 
 #undef REGISTER
-#define REGISTER(type, name) c.addSystemSubroutine(std::make_unique<type>(name))
-    REGISTER(FileDisplayTask, "$fdisplay");
-    REGISTER(FileDisplayTask, "$fdisplayb");
-    REGISTER(FileDisplayTask, "$fdisplayo");
-    REGISTER(FileDisplayTask, "$fdisplayh");
-    REGISTER(FileDisplayTask, "$fwrite");
-    REGISTER(FileDisplayTask, "$fwriteb");
-    REGISTER(FileDisplayTask, "$fwriteo");
-    REGISTER(FileDisplayTask, "$fwriteh");
-    REGISTER(FileMonitorTask, "$fstrobe");
-    REGISTER(FileMonitorTask, "$fstrobeb");
-    REGISTER(FileMonitorTask, "$fstrobeo");
-    REGISTER(FileMonitorTask, "$fstrobeh");
-    REGISTER(FileMonitorTask, "$fmonitor");
-    REGISTER(FileMonitorTask, "$fmonitorb");
-    REGISTER(FileMonitorTask, "$fmonitoro");
-    REGISTER(FileMonitorTask, "$fmonitorh");
+#define REGISTER(type, name, base, newline) \
+    c.addSystemSubroutine(std::make_unique<type>(name, base, newline))
+    REGISTER(FileDisplayTask, "$fdisplay", LiteralBase::Decimal, true);
+    REGISTER(FileDisplayTask, "$fdisplayb", LiteralBase::Binary, true);
+    REGISTER(FileDisplayTask, "$fdisplayo", LiteralBase::Octal, true);
+    REGISTER(FileDisplayTask, "$fdisplayh", LiteralBase::Hex, true);
+    REGISTER(FileDisplayTask, "$fwrite", LiteralBase::Decimal, false);
+    REGISTER(FileDisplayTask, "$fwriteb", LiteralBase::Binary, false);
+    REGISTER(FileDisplayTask, "$fwriteo", LiteralBase::Octal, false);
+    REGISTER(FileDisplayTask, "$fwriteh", LiteralBase::Hex, false);
+    REGISTER(FileMonitorTask, "$fstrobe", LiteralBase::Decimal, true);
+    REGISTER(FileMonitorTask, "$fstrobeb", LiteralBase::Binary, true);
+    REGISTER(FileMonitorTask, "$fstrobeo", LiteralBase::Octal, true);
+    REGISTER(FileMonitorTask, "$fstrobeh", LiteralBase::Hex, true);
+    REGISTER(FileMonitorTask, "$fmonitor", LiteralBase::Decimal, true);
+    REGISTER(FileMonitorTask, "$fmonitorb", LiteralBase::Binary, true);
+    REGISTER(FileMonitorTask, "$fmonitoro", LiteralBase::Octal, true);
+    REGISTER(FileMonitorTask, "$fmonitorh", LiteralBase::Hex, true);
 
+#undef REGISTER
+#define REGISTER(type, name) c.addSystemSubroutine(std::make_unique<type>(name))
     REGISTER(StringOutputTask, "$swrite");
     REGISTER(StringOutputTask, "$swriteb");
     REGISTER(StringOutputTask, "$swriteo");
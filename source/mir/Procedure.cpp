@@ -145,10 +145,8 @@ public:
     MIRValue visit(const MemberAccessExpression&) { return {}; }
 
     MIRValue visit(const CallExpression& expr) {
-        if (expr.isSystemCall()) {
-            std::get<1>(expr.subroutine).subroutine->lower(proc, expr.arguments());
-            return {};
-        }
+        if (expr.isSystemCall())
+            return std::get<1>(expr.subroutine).subroutine->lower(proc, expr.arguments());
         return {};
     }
 
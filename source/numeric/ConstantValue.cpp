@@ -111,7 +111,7 @@ size_t ConstantValue::hash() const {
                     hash_combine(h, element.hash());
             }
             else if constexpr (std::is_same_v<T, std::string>)
-                hash_combine(h, std::hash<std::string>()(arg));
+                hash_combine(h, xxhash(arg.data(), arg.size()));
             else if constexpr (std::is_same_v<T, Map>) {
                 for (auto& [key, val] : *arg) {
                     hash_combine(h, key.hash());
@@ -600,6 +600,26 @@ bool operator<(const ConstantValue& lhs, const ConstantValue& rhs) {
         lhs.value);
 }
 
+bool AssociativeKeyLess::operator()(const ConstantValue& lhs, const ConstantValue& rhs) const {
+    if (lhs.isInteger() && rhs.isInteger()) {
+        auto& l = lhs.integer();
+        auto& r = rhs.integer();
+        if (l.isSingleWord() && r.isSingleWord() && l.getBitWidth() == r.getBitWidth() &&
+            l.isSigned() == r.isSigned()) {
+            uint64_t a = *l.getRawPtr();
+            uint64_t b = *r.getRawPtr();
+            if (l.isSigned()) {
+                // Flipping the sign bit maps two's complement ordering onto unsigned ordering.
+                uint64_t signBit = uint64_t(1) << (l.getBitWidth() - 1);
+                a ^= signBit;
+                b ^= signBit;
+            }
+            return a < b;
+        }
+    }
+    return lhs < rhs;
+}
+
 const ConstantValue& CVIterator::operator*() const {
     return std::visit(
         [](auto&& arg) -> const ConstantValue& {
@@ -615,7 +615,17 @@ SVInt SVInt::replicate(const SVInt& times) const {
 }
 
 size_t SVInt::hash() const {
-    return xxhash(getRawData(), getNumWords() * WORD_SIZE);
+    // exactlyEqual zero extends values of different widths before comparing them,
+    // so leave off any high words that are zero to make sure such values hash
+    // the same. Values with unknown bits only compare equal to other values with
+    // unknown bits, which are always hashed in full.
+    uint32_t words = getNumWords();
+    if (!unknownFlag) {
+        const uint64_t* data = getRawData();
+        while (words > 1 && data[words - 1] == 0)
+            words--;
+    }
+    return xxhash(getRawData(), words * WORD_SIZE);
 }
 
 std::ostream& operator<<(std::ostream& os, const SVInt& rhs) {
@@ -1646,6 +1656,41 @@ SVInt SVInt::reverse() const {
     return result;
 }
 
+SVInt SVInt::reverseBlocks(bitwidth_t blockSize, bitwidth_t firstBlockSize) const {
+    ASSERT(blockSize && firstBlockSize);
+    if (firstBlockSize >= bitWidth)
+        return *this;
+
+    SVInt result = isSingleWord() ? SVInt(bitWidth, 0, signFlag)
+                                  : SVInt::allocZeroed(bitWidth, signFlag, unknownFlag);
+
+    uint32_t words = getNumWords(bitWidth, false);
+    auto reverseInto = [&](uint64_t* dst, const uint64_t* src) {
+        // Reversing bytes across a whole number of words is just a matter
+        // of reversing the word order and swapping the bytes within each word.
+        if (blockSize == 8 && firstBlockSize == 8 && bitWidth % BITS_PER_WORD == 0) {
+            for (uint32_t i = 0; i < words; i++)
+                dst[i] = reverseBytes64(src[words - i - 1]);
+            return;
+        }
+
+        bitwidth_t offset = 0;
+        bitwidth_t size = firstBlockSize;
+        while (offset < bitWidth) {
+            size = std::min(size, bitWidth - offset);
+            bitcpy(dst, bitWidth - offset - size, src, size, offset);
+            offset += size;
+            size = blockSize;
+        }
+    };
+
+    reverseInto(result.getRawData(), getRawData());
+    if (unknownFlag)
+        reverseInto(result.getRawData() + words, getRawData() + words);
+
+    return result;
+}
+
 SVInt SVInt::conditional(const SVInt& condition, const SVInt& lhs, const SVInt& rhs) {
     bool bothSigned = lhs.signFlag && rhs.signFlag;
     if (lhs.bitWidth != rhs.bitWidth) {
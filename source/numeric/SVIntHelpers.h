@@ -759,4 +759,11 @@ static uint64_t reverseBits64(uint64_t x) {
     return (uint64_t(reverseBits32(uint32_t(x))) << 32) | reverseBits32(uint32_t(x >> 32));
 }
 
+// Reverses the byte ordering of the number.
+static uint64_t reverseBytes64(uint64_t x) {
+    x = ((x & 0xff00ff00ff00ff00ull) >> 8) | ((x & 0x00ff00ff00ff00ffull) << 8);
+    x = ((x & 0xffff0000ffff0000ull) >> 16) | ((x & 0x0000ffff0000ffffull) << 16);
+    return (x >> 32) | (x << 32);
+}
+
 } // namespace slang
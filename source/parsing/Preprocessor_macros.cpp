@@ -16,6 +16,99 @@ namespace slang {
 
 using LF = LexerFacts;
 
+namespace {
+
+// Makes a deep copy of a syntax node, including its tokens and everything they point to,
+// in a different allocator. Text is copied as well, since tokens produced by macro
+// expansion can have text that lives in the preprocessor's allocator.
+struct DeepCopier {
+    BumpAllocator& alloc;
+
+    explicit DeepCopier(BumpAllocator& alloc) : alloc(alloc) {}
+
+    template<typename T>
+    SyntaxNode* visit(const T& node) {
+        T* copied = node.clone(alloc);
+        if constexpr (std::is_same_v<T, SyntaxListBase>) {
+            SmallVectorSized<TokenOrSyntax, 8> children;
+            for (size_t i = 0; i < node.getChildCount(); i++) {
+                if (auto child = node.childNode(i))
+                    children.append(child->visit(*this));
+                else
+                    children.append(copy(node.childToken(i)));
+            }
+            copied->resetAll(alloc, children);
+        }
+        else {
+            for (size_t i = 0; i < node.getChildCount(); i++) {
+                if (auto child = node.childNode(i))
+                    copied->setChild(i, child->visit(*this));
+                else if (auto token = node.childToken(i))
+                    copied->setChild(i, copy(token));
+            }
+        }
+        return copied;
+    }
+
+    SyntaxNode* visitInvalid(const SyntaxNode&) { THROW_UNREACHABLE; }
+
+    Token copy(Token token) {
+        if (!token)
+            return token;
+
+        SmallVectorSized<Trivia, 8> trivia;
+        for (auto& t : token.trivia())
+            trivia.append(copy(t));
+
+        auto triviaSpan = trivia.copy(alloc);
+        auto rawText = copy(token.rawText());
+        auto location = token.location();
+        if (token.isMissing())
+            return token.clone(alloc, triviaSpan, rawText, location);
+
+        switch (token.kind) {
+            case TokenKind::StringLiteral:
+                return Token(alloc, token.kind, triviaSpan, rawText, location,
+                             copy(token.valueText()));
+            case TokenKind::IntegerLiteral:
+                return Token(alloc, token.kind, triviaSpan, rawText, location, token.intValue());
+            default:
+                return token.clone(alloc, triviaSpan, rawText, location);
+        }
+    }
+
+    Trivia copy(const Trivia& trivia) {
+        switch (trivia.kind) {
+            case TriviaKind::Directive:
+            case TriviaKind::SkippedSyntax:
+                return Trivia(trivia.kind, trivia.syntax()->visit(*this));
+            case TriviaKind::SkippedTokens: {
+                SmallVectorSized<Token, 8> tokens;
+                for (auto token : trivia.getSkippedTokens())
+                    tokens.append(copy(token));
+                return Trivia(trivia.kind, tokens.copy(alloc));
+            }
+            default: {
+                Trivia result(trivia.kind, copy(trivia.getRawText()));
+                if (auto loc = trivia.getExplicitLocation())
+                    result = result.withLocation(alloc, *loc);
+                return result;
+            }
+        }
+    }
+
+    string_view copy(string_view text) {
+        if (text.empty())
+            return text;
+
+        char* mem = (char*)alloc.allocate(text.size(), alignof(char));
+        memcpy(mem, text.data(), text.size());
+        return string_view(mem, text.size());
+    }
+};
+
+} // namespace
+
 Preprocessor::MacroDef Preprocessor::findMacro(Token directive) {
     string_view name = directive.valueText().substr(1);
     if (!name.empty() && name[0] == '\\')
@@ -27,6 +120,36 @@ Preprocessor::MacroDef Preprocessor::findMacro(Token directive) {
     return it->second;
 }
 
+bool Preprocessor::releaseTokens() {
+    if (currentToken || currentMacroToken || !expandedTokens.empty() || inMacroBody)
+        return false;
+
+    BumpAllocator fresh;
+    DeepCopier copier(fresh);
+
+    // Macro names point into their definitions, so the map gets rebuilt
+    // with keys from the copies. Intrinsic macros have static names.
+    std::unordered_map<string_view, MacroDef> newMacros;
+    for (auto& [name, def] : macros) {
+        MacroDef newDef = def;
+        string_view newName = name;
+        if (def.syntax) {
+            newDef.syntax = &def.syntax->visit(copier)->as<DefineDirectiveSyntax>();
+            if (!def.builtIn)
+                newName = newDef.syntax->name.valueText();
+        }
+        newMacros.emplace(newName, newDef);
+    }
+
+    // The scratch buffer is only used while handling a directive,
+    // but it still refers to the last tokens it held.
+    scratchTokenBuffer.clear();
+    lastConsumed = copier.copy(lastConsumed);
+    macros = std::move(newMacros);
+    alloc = std::move(fresh);
+    return true;
+}
+
 void Preprocessor::createBuiltInMacro(string_view name, int value, string_view valueStr) {
 #define NL SourceLocation::NoLocation
 
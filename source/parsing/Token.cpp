@@ -63,6 +63,26 @@ static constexpr size_t getExtraSize(TokenKind kind) {
     return (size + align - 1) & ~(align - 1);
 }
 
+// Helpers for moving tokens and trivia between buffers in place.
+static bool relocateLocation(SourceLocation& location, const SourceBuffer& from,
+                             const SourceBuffer& to, ptrdiff_t shift) {
+    if (location.buffer() == from.id) {
+        location = SourceLocation(to.id, size_t(ptrdiff_t(location.offset()) + shift));
+        return true;
+    }
+    return location.buffer() == to.id;
+}
+
+static const char* relocateText(const char* ptr, size_t len, const SourceBuffer& from,
+                                const SourceBuffer& to, ptrdiff_t shift) {
+    // Text that doesn't point into the source buffer is either empty or
+    // owned by something else, and can be used as is.
+    auto begin = from.data.data();
+    if (ptr < begin || ptr + len > begin + from.data.size())
+        return ptr;
+    return to.data.data() + (ptr - begin) + shift;
+}
+
 void NumericTokenFlags::set(LiteralBase base_, bool isSigned_) {
     raw |= uint8_t(base_);
     raw |= uint8_t(isSigned_) << 2;
@@ -150,6 +170,26 @@ span<Token const> Trivia::getSkippedTokens() const {
     return { tokens.ptr, tokens.len };
 }
 
+bool Trivia::relocateInPlace(const SourceBuffer& from, const SourceBuffer& to, ptrdiff_t shift) {
+    switch (kind) {
+        case TriviaKind::Directive:
+        case TriviaKind::SkippedSyntax:
+        case TriviaKind::SkippedTokens:
+            return true;
+        default:
+            break;
+    }
+
+    if (hasFullLocation) {
+        auto& text = fullLocation->text;
+        text = string_view(relocateText(text.data(), text.size(), from, to, shift), text.size());
+        return relocateLocation(fullLocation->location, from, to, shift);
+    }
+
+    rawText.ptr = relocateText(rawText.ptr, rawText.len, from, to, shift);
+    return true;
+}
+
 Token::Token() :
     kind(TokenKind::Unknown), missing(false), triviaCountSmall(0), reserved(0), numFlags() {
 }
@@ -314,6 +354,24 @@ SyntaxKind Token::directiveKind() const {
     return info->directiveKind();
 }
 
+bool Token::relocateInPlace(const SourceBuffer& from, const SourceBuffer& to, ptrdiff_t shift) {
+    if (!info)
+        return true;
+
+    // The trivia memory is owned by whoever owns the token, same as the info block.
+    bool result = true;
+    for (auto& trivia : this->trivia())
+        result &= const_cast<Trivia&>(trivia).relocateInPlace(from, to, shift);
+
+    info->rawTextPtr = relocateText(info->rawTextPtr, rawLen, from, to, shift);
+    if (kind == TokenKind::StringLiteral || kind == TokenKind::IncludeFileName) {
+        auto& text = info->stringText();
+        text = string_view(relocateText(text.data(), text.size(), from, to, shift), text.size());
+    }
+
+    return relocateLocation(info->location, from, to, shift) && result;
+}
+
 Token Token::withTrivia(BumpAllocator& alloc, span<Trivia const> trivia) const {
     return clone(alloc, trivia, rawText(), location());
 }
@@ -4,7 +4,20 @@
 //
 // File is under the MIT license; see LICENSE for details
 //------------------------------------------------------------------------------
+#include <chrono>
+#include <cmath>
 #include <fmt/format.h>
+#include <memory>
+#include <vector>
+
+#if defined(_MSC_VER)
+#    include <fcntl.h>
+#    include <io.h>
+#    include <sys/stat.h>
+#else
+#    include <fcntl.h>
+#    include <unistd.h>
+#endif
 
 #include "slang/runtime/Runtime.h"
 #include "slang/text/SFormat.h"
@@ -12,43 +25,372 @@
 
 using namespace slang;
 
-// The global output buffer, printed to by exported I/O routines.
-// Whenever flush() is called the outputHandler will be invoked with
-// the current contents of the buffer.
-fmt::memory_buffer outputBuffer;
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Buffered output is handed off whenever this much text has accumulated,
+// or when a line is finished and this much time has passed since the last
+// hand off, whichever comes first. Output to an interactive terminal is
+// instead handed off at the end of every line.
+constexpr size_t FlushThreshold = 64 * 1024;
+constexpr auto FlushInterval = std::chrono::milliseconds(100);
 
-function_ref<void(std::string_view)> outputHandler = [](std::string_view str) {
+// File descriptors returned by $fopen have the MSB set; the low bits index
+// into the table of open files. Entries 0-2 are reserved for stdin, stdout
+// and stderr. Multichannel descriptors instead have one bit per open file,
+// where bit 0 is always stdout.
+constexpr uint32_t FdFlag = 0x80000000u;
+constexpr uint32_t StdoutIndex = 1;
+constexpr uint32_t StderrIndex = 2;
+constexpr uint32_t MaxChannels = 31;
+
+void writeToFd(int fd, std::string_view str) {
+    while (!str.empty()) {
+#if defined(_MSC_VER)
+        int count = ::_write(fd, str.data(), unsigned(str.size()));
+#else
+        auto count = ::write(fd, str.data(), str.size());
+#endif
+        if (count <= 0)
+            return;
+        str.remove_prefix(size_t(count));
+    }
+}
+
+bool isTerminal(int fd) {
+#if defined(_MSC_VER)
+    return ::_isatty(fd) != 0;
+#else
+    return ::isatty(fd) != 0;
+#endif
+}
+
+// Goes through stdio, like the rest of the program's output, so that simulation
+// output stays in order with anything else printed to stdout.
+void writeToStdout(std::string_view str) {
     OS::print("{}", str);
+}
+
+// Whenever buffered stdout text is emitted the outputHandler will be invoked
+// with the current contents of the buffer.
+std::function<void(std::string_view)> outputHandler = writeToStdout;
+
+class OutputStream {
+public:
+    // An fd of -1 means the text goes to the output handler.
+    explicit OutputStream(int fd) :
+        fd(fd), lineBuffered(isTerminal(fd < 0 ? 1 : fd)) {}
+    ~OutputStream() { close(); }
+
+    fmt::memory_buffer buffer;
+
+    void endLine(bool newline) {
+        if (newline)
+            buffer.push_back('\n');
+
+        if (lineBuffered || buffer.size() >= FlushThreshold ||
+            Clock::now() - lastEmit >= FlushInterval) {
+            emit();
+        }
+    }
+
+    void emit() {
+        if (buffer.size()) {
+            std::string_view str(buffer.data(), buffer.size());
+            if (fd < 0) {
+                outputHandler(str);
+            }
+            else {
+                // Don't let our raw write jump ahead of anything still sitting
+                // in stdio's buffer for the same descriptor.
+                if (fd == 2)
+                    fflush(stderr);
+                writeToFd(fd, str);
+            }
+            buffer.clear();
+        }
+        lastEmit = Clock::now();
+    }
+
+    void close() {
+        emit();
+        if (fd > 2) {
+#if defined(_MSC_VER)
+            ::_close(fd);
+#else
+            ::close(fd);
+#endif
+        }
+        fd = -1;
+    }
+
+private:
+    int fd;
+    bool lineBuffered;
+    Clock::time_point lastEmit = Clock::now();
 };
 
-EXPORT void flush(bool newline) {
-    if (newline)
-        outputBuffer.push_back('\n');
+// All open output streams. Entries are never removed, just reset, so that
+// descriptor values remain stable; closed slots get reused by later opens.
+struct StreamTable {
+    std::vector<std::unique_ptr<OutputStream>> fds;
+    std::vector<std::unique_ptr<OutputStream>> channels;
 
-    outputHandler(std::string_view(outputBuffer.data(), outputBuffer.size()));
-    outputBuffer.clear();
+    StreamTable() {
+        fds.emplace_back(nullptr);
+        fds.emplace_back(std::make_unique<OutputStream>(-1));
+        fds.emplace_back(std::make_unique<OutputStream>(2));
+        channels.resize(MaxChannels);
+    }
+
+    // Make sure nothing buffered gets lost when the program exits, which is
+    // how ahead-of-time compiled simulations end.
+    ~StreamTable() { flushAll(); }
+
+    OutputStream& out() { return *fds[StdoutIndex]; }
+
+    void flushAll() {
+        for (auto& stream : fds) {
+            if (stream)
+                stream->emit();
+        }
+        for (auto& stream : channels) {
+            if (stream)
+                stream->emit();
+        }
+    }
+
+    // Descriptors come from generated code as arbitrary integer values; anything
+    // with unknown bits doesn't refer to any stream.
+    template<typename TFunc>
+    void forEach(const SVInt* value, TFunc&& func) {
+        if (value->hasUnknown())
+            return;
+
+        uint32_t descriptor = uint32_t(*value->getRawPtr());
+        if (descriptor & FdFlag) {
+            uint32_t index = descriptor & ~FdFlag;
+            if (index < fds.size() && fds[index])
+                func(*fds[index]);
+            return;
+        }
+
+        if (descriptor & 1)
+            func(out());
+
+        for (uint32_t i = 1; i < MaxChannels; i++) {
+            if ((descriptor & (1u << i)) && channels[i])
+                func(*channels[i]);
+        }
+    }
+};
+
+StreamTable streams;
+
+int openFile(std::string_view name, std::string_view mode) {
+    int flags;
+    bool plus = mode.find('+') != std::string_view::npos;
+    switch (mode.empty() ? 'w' : mode[0]) {
+        case 'r':
+            flags = plus ? O_RDWR : O_RDONLY;
+            break;
+        case 'a':
+            flags = (plus ? O_RDWR : O_WRONLY) | O_CREAT | O_APPEND;
+            break;
+        case 'w':
+            flags = (plus ? O_RDWR : O_WRONLY) | O_CREAT | O_TRUNC;
+            break;
+        default:
+            return -1;
+    }
+
+    std::string path(name);
+#if defined(_MSC_VER)
+    return ::_open(path.c_str(), flags | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    return ::open(path.c_str(), flags, 0666);
+#endif
 }
 
-EXPORT void printStr(const char* str, size_t len) {
-    outputBuffer.append(str, str + len);
+// Formats an integer that fits in a single word and has no unknown bits
+// without going through the general SVInt formatting routines. Returns
+// false if the value isn't eligible for the fast path.
+bool formatSmallInt(fmt::memory_buffer& out, const SVInt& value, LiteralBase base, uint32_t width,
+                    bool hasWidth) {
+    bitwidth_t bits = value.getBitWidth();
+    if (bits > 64 || value.hasUnknown())
+        return false;
+
+    if (base != LiteralBase::Decimal && base != LiteralBase::Hex)
+        return false;
+
+    // Values passed in from generated code may have garbage (or sign extension)
+    // in the unused upper bits, so normalize them here.
+    uint64_t raw = *value.getRawPtr();
+    if (bits < 64)
+        raw &= (1ull << bits) - 1;
+
+    char digits[24];
+    char* end = digits + sizeof(digits);
+    char* cur = end;
+
+    if (base == LiteralBase::Hex) {
+        do {
+            *--cur = "0123456789abcdef"[raw & 0xf];
+            raw >>= 4;
+        } while (raw);
+
+        if (!hasWidth)
+            width = (bits + 3) / 4;
+    }
+    else {
+        bool negative = false;
+        if (value.isSigned() && (raw >> (bits - 1)) & 1) {
+            negative = true;
+            raw = (~raw + 1) & (bits < 64 ? (1ull << bits) - 1 : ~0ull);
+        }
+
+        do {
+            *--cur = char('0' + raw % 10);
+            raw /= 10;
+        } while (raw);
+
+        if (negative)
+            *--cur = '-';
+
+        if (!hasWidth) {
+            // Matches the default width computed by SFormat::formatInt.
+            static const double log2_10 = log2(10.0);
+            width = uint32_t(ceil(bits / log2_10));
+            if (value.isSigned())
+                width++;
+        }
+    }
+
+    size_t len = size_t(end - cur);
+    if (len < width) {
+        char pad = base == LiteralBase::Decimal ? ' ' : '0';
+        for (size_t i = len; i < width; i++)
+            out.push_back(pad);
+    }
+
+    out.append(cur, end);
+    return true;
 }
 
-EXPORT void printInt(const SVInt* value, LiteralBase base, uint32_t width, bool hasWidth) {
+void formatInt(fmt::memory_buffer& out, const SVInt* value, LiteralBase base, uint32_t width,
+               bool hasWidth) {
+    if (formatSmallInt(out, *value, base, width, hasWidth))
+        return;
+
     SFormat::FormatOptions options;
     if (hasWidth)
         options.width = width;
 
-    static std::string str;
+    std::string str;
     SFormat::formatInt(str, *value, base, options);
+    out.append(str.data(), str.data() + str.size());
+}
+
+} // namespace
+
+EXPORT void flush(bool newline) {
+    streams.out().endLine(newline);
+}
+
+EXPORT void printStr(const char* str, size_t len) {
+    streams.out().buffer.append(str, str + len);
+}
+
+EXPORT void printInt(const SVInt* value, LiteralBase base, uint32_t width, bool hasWidth) {
+    formatInt(streams.out().buffer, value, base, width, hasWidth);
+}
+
+EXPORT uint32_t fileOpen(const char* name, size_t nameLen, const char* mode, size_t modeLen) {
+    std::string_view modeStr(mode, modeLen);
+    int fd = openFile(std::string_view(name, nameLen), modeStr);
+    if (fd < 0)
+        return 0;
+
+    // Without a mode we hand out a multichannel descriptor.
+    if (modeStr.empty()) {
+        for (uint32_t i = 1; i < MaxChannels; i++) {
+            if (!streams.channels[i]) {
+                streams.channels[i] = std::make_unique<OutputStream>(fd);
+                return 1u << i;
+            }
+        }
+    }
+    else {
+        for (uint32_t i = StderrIndex + 1; i < streams.fds.size(); i++) {
+            if (!streams.fds[i]) {
+                streams.fds[i] = std::make_unique<OutputStream>(fd);
+                return FdFlag | i;
+            }
+        }
+
+        if (streams.fds.size() < FdFlag) {
+            streams.fds.emplace_back(std::make_unique<OutputStream>(fd));
+            return FdFlag | uint32_t(streams.fds.size() - 1);
+        }
+    }
+
+    OutputStream(fd).close();
+    return 0;
+}
+
+EXPORT void fileClose(const SVInt* value) {
+    if (value->hasUnknown())
+        return;
+
+    auto closeSlot = [](std::unique_ptr<OutputStream>& slot) {
+        if (slot) {
+            slot->close();
+            slot.reset();
+        }
+    };
+
+    uint32_t descriptor = uint32_t(*value->getRawPtr());
+    if (descriptor & FdFlag) {
+        uint32_t index = descriptor & ~FdFlag;
+        if (index > StderrIndex && index < streams.fds.size())
+            closeSlot(streams.fds[index]);
+        return;
+    }
 
-    outputBuffer.append(str.data(), str.data() + str.size());
-    str.clear();
+    for (uint32_t i = 1; i < MaxChannels; i++) {
+        if (descriptor & (1u << i))
+            closeSlot(streams.channels[i]);
+    }
+}
+
+EXPORT void fileFlush(const SVInt* descriptor, bool newline) {
+    streams.forEach(descriptor, [newline](OutputStream& stream) { stream.endLine(newline); });
+}
+
+EXPORT void filePrintStr(const SVInt* descriptor, const char* str, size_t len) {
+    streams.forEach(descriptor,
+                    [str, len](OutputStream& stream) { stream.buffer.append(str, str + len); });
+}
+
+EXPORT void filePrintInt(const SVInt* descriptor, const SVInt* value, LiteralBase base,
+                         uint32_t width, bool hasWidth) {
+    streams.forEach(descriptor, [&](OutputStream& stream) {
+        formatInt(stream.buffer, value, base, width, hasWidth);
+    });
 }
 
 namespace slang::runtime {
 
-void setOutputHandler(function_ref<void(std::string_view)> handler) {
-    outputHandler = handler;
+void setOutputHandler(std::function<void(std::string_view)> handler) {
+    // Anything already buffered belongs to the previous handler.
+    streams.out().emit();
+    outputHandler = std::move(handler);
+}
+
+void flushOutput() {
+    streams.flushAll();
 }
 
 void getIOExports(ExportList& results) {
@@ -57,8 +399,13 @@ void getIOExports(ExportList& results) {
     ADD(flush);
     ADD(printStr);
     ADD(printInt);
+    ADD(fileOpen);
+    ADD(fileClose);
+    ADD(fileFlush);
+    ADD(filePrintStr);
+    ADD(filePrintInt);
 
 #undef ADD
 }
 
-} // namespace slang::runtime
\ No newline at end of file
+} // namespace slang::runtime
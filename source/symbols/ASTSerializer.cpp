@@ -11,7 +11,35 @@
 
 namespace slang {
 
+namespace {
+
+class JsonASTWriter : public ASTWriter {
+public:
+    explicit JsonASTWriter(JsonWriter& writer) : writer(writer) {}
+
+    void startObject() final { writer.startObject(); }
+    void endObject() final { writer.endObject(); }
+    void startArray() final { writer.startArray(); }
+    void endArray() final { writer.endArray(); }
+    void writeProperty(string_view name) final { writer.writeProperty(name); }
+    void writeValue(string_view value) final { writer.writeValue(value); }
+    void writeValue(int64_t value) final { writer.writeValue(value); }
+    void writeValue(uint64_t value) final { writer.writeValue(value); }
+    void writeValue(double value) final { writer.writeValue(value); }
+    void writeValue(bool value) final { writer.writeValue(value); }
+
+private:
+    JsonWriter& writer;
+};
+
+} // namespace
+
 ASTSerializer::ASTSerializer(Compilation& compilation, JsonWriter& writer) :
+    compilation(compilation), jsonWriter(std::make_unique<JsonASTWriter>(writer)),
+    writer(*jsonWriter) {
+}
+
+ASTSerializer::ASTSerializer(Compilation& compilation, ASTWriter& writer) :
     compilation(compilation), writer(writer) {
 }
 
@@ -129,7 +157,7 @@ void ASTSerializer::writeLink(string_view name, const Symbol& value) {
     else
         str += std::string(value.name);
 
-    writer.writeValue(str);
+    writer.writeLink(value, str);
 }
 
 void ASTSerializer::startArray() {
@@ -217,7 +245,7 @@ void ASTSerializer::visit(const T& elem, bool inMembersArray) {
                 return;
         }
 
-        writer.startObject();
+        writer.startSymbol(elem);
         write("name", elem.name);
         write("kind", toString(elem.kind));
 
@@ -255,7 +283,7 @@ void ASTSerializer::visit(const T& elem, bool inMembersArray) {
             elem.serializeTo(*this);
         }
 
-        writer.endObject();
+        writer.endSymbol(elem);
     }
 }
 
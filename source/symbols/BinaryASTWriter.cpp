@@ -0,0 +1,201 @@
+//------------------------------------------------------------------------------
+// BinaryASTWriter.cpp
+// Support for writing the AST in a compact binary format
+//
+// File is under the MIT license; see LICENSE for details
+//------------------------------------------------------------------------------
+#include "slang/symbols/BinaryASTWriter.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "slang/symbols/Symbol.h"
+
+namespace slang {
+
+using namespace BinaryAST;
+
+void BinaryASTWriter::startObject() {
+    startComposite(Tag::Object);
+}
+
+void BinaryASTWriter::endObject() {
+    endComposite();
+}
+
+void BinaryASTWriter::startArray() {
+    startComposite(Tag::Array);
+    append<uint32_t>(0);
+}
+
+void BinaryASTWriter::endArray() {
+    // Fill in the element count, which comes right after the size.
+    auto& top = stack.back();
+    uint32_t count = littleEndian(top.count);
+    memcpy(body.data() + top.sizeOffset + sizeof(uint64_t), &count, sizeof(uint32_t));
+    endComposite();
+}
+
+void BinaryASTWriter::writeProperty(string_view name) {
+    append(getStringId(name));
+}
+
+void BinaryASTWriter::writeValue(string_view value) {
+    writeTag(Tag::String);
+    append(getStringId(value));
+}
+
+void BinaryASTWriter::writeValue(int64_t value) {
+    writeTag(Tag::Int);
+    append(value);
+}
+
+void BinaryASTWriter::writeValue(uint64_t value) {
+    writeTag(Tag::UInt);
+    append(value);
+}
+
+void BinaryASTWriter::writeValue(double value) {
+    writeTag(Tag::Double);
+    append(value);
+}
+
+void BinaryASTWriter::writeValue(bool value) {
+    writeTag(value ? Tag::True : Tag::False);
+}
+
+void BinaryASTWriter::startSymbol(const Symbol& symbol) {
+    uint32_t id = getSymbolId(symbol);
+    symbolOffsets[id] = sizeof(Header) + body.size();
+
+    startComposite(Tag::Symbol);
+    append(id);
+
+    if (symbol.kind == SymbolKind::Instance) {
+        std::string path;
+        symbol.getHierarchicalPath(path);
+        scopes.push_back({ getStringId(path), id });
+    }
+}
+
+void BinaryASTWriter::endSymbol(const Symbol&) {
+    endComposite();
+}
+
+void BinaryASTWriter::writeLink(const Symbol& symbol, string_view text) {
+    writeTag(Tag::Link);
+    append(getSymbolId(symbol));
+    append(getStringId(text));
+}
+
+void BinaryASTWriter::finish(function_ref<void(string_view)> output) {
+    ASSERT(stack.empty());
+
+    // Everything is converted to file byte order as it's written out.
+    auto writeInt = [&output](auto value) {
+        value = littleEndian(value);
+        output(string_view(reinterpret_cast<const char*>(&value), sizeof(value)));
+    };
+    auto writeTable = [&output](std::vector<uint64_t> table) {
+        for (auto& value : table)
+            value = littleEndian(value);
+        output(string_view(reinterpret_cast<const char*>(table.data()),
+                           table.size() * sizeof(uint64_t)));
+    };
+
+    // String table: count, then offsets into the string data, then the data.
+    std::vector<uint64_t> stringOffsets;
+    stringOffsets.reserve(strings.size() + 1);
+    uint64_t stringDataSize = 0;
+    for (auto& str : strings) {
+        stringOffsets.push_back(stringDataSize);
+        stringDataSize += str.size();
+    }
+    stringOffsets.push_back(stringDataSize);
+
+    // Sort the scope index by path so that readers can binary search it.
+    std::sort(scopes.begin(), scopes.end(), [this](const ScopeEntry& a, const ScopeEntry& b) {
+        return strings[a.pathId] < strings[b.pathId];
+    });
+
+    Header header;
+    memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.numRoots = numRoots;
+    header.bodyOffset = sizeof(Header);
+    header.stringTableOffset = header.bodyOffset + body.size();
+    header.symbolTableOffset = header.stringTableOffset + sizeof(uint32_t) +
+                               stringOffsets.size() * sizeof(uint64_t) + stringDataSize;
+    header.scopeIndexOffset = header.symbolTableOffset + sizeof(uint32_t) +
+                              symbolOffsets.size() * sizeof(uint64_t);
+
+    header = littleEndian(header);
+    output(string_view(reinterpret_cast<const char*>(&header), sizeof(header)));
+    output(string_view(body.data(), body.size()));
+
+    writeInt(uint32_t(strings.size()));
+    writeTable(std::move(stringOffsets));
+    for (auto& str : strings)
+        output(str);
+
+    writeInt(uint32_t(symbolOffsets.size()));
+    writeTable(symbolOffsets);
+
+    writeInt(uint32_t(scopes.size()));
+    for (auto& entry : scopes) {
+        writeInt(entry.pathId);
+        writeInt(entry.symbolId);
+    }
+}
+
+void BinaryASTWriter::startValue() {
+    if (stack.empty())
+        numRoots++;
+    else if (stack.back().isArray)
+        stack.back().count++;
+}
+
+void BinaryASTWriter::startComposite(Tag tag) {
+    writeTag(tag);
+    stack.push_back({ body.size(), 0, tag == Tag::Array });
+    append<uint64_t>(0);
+}
+
+void BinaryASTWriter::endComposite() {
+    ASSERT(!stack.empty());
+    size_t sizeOffset = stack.back().sizeOffset;
+    uint64_t size = littleEndian(uint64_t(body.size() - sizeOffset - sizeof(uint64_t)));
+    memcpy(body.data() + sizeOffset, &size, sizeof(uint64_t));
+    stack.pop_back();
+}
+
+void BinaryASTWriter::writeTag(Tag tag) {
+    startValue();
+    body.push_back(char(tag));
+}
+
+uint32_t BinaryASTWriter::getStringId(string_view str) {
+    if (auto it = stringIds.find(str); it != stringIds.end())
+        return it->second;
+
+    uint32_t id = uint32_t(strings.size());
+    auto& stored = strings.emplace_back(str);
+    stringIds.emplace(string_view(stored), id);
+    return id;
+}
+
+uint32_t BinaryASTWriter::getSymbolId(const Symbol& symbol) {
+    auto [it, inserted] = symbolIds.emplace(&symbol, uint32_t(symbolOffsets.size()));
+    if (inserted)
+        symbolOffsets.push_back(0);
+    return it->second;
+}
+
+template<typename T>
+void BinaryASTWriter::append(T value) {
+    value = littleEndian(value);
+    auto bytes = reinterpret_cast<const char*>(&value);
+    body.insert(body.end(), bytes, bytes + sizeof(T));
+}
+
+} // namespace slang
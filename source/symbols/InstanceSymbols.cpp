@@ -574,6 +574,8 @@ InstanceBodySymbol& InstanceBodySymbol::fromDefinition(Compilation& comp,
                                                        SourceLocation instanceLoc,
                                                        ParameterBuilder& paramBuilder,
                                                        bool isUninstantiated) {
+    Compilation::DefinitionStatsScope statsScope(comp, definition);
+
     auto& declSyntax = definition.syntax;
     auto result = comp.emplace<InstanceBodySymbol>(comp, definition, paramBuilder.getOverrides(),
                                                    isUninstantiated);
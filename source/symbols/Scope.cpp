@@ -48,8 +48,10 @@ namespace slang {
 
 static size_t countMembers(const SyntaxNode& syntax);
 
+const SymbolMap Scope::emptyNameMap;
+
 Scope::Scope(Compilation& compilation_, const Symbol* thisSym_) :
-    compilation(compilation_), thisSym(thisSym_), nameMap(compilation.allocSymbolMap()) {
+    compilation(compilation_), thisSym(thisSym_) {
 }
 
 Scope::iterator& Scope::iterator::operator++() {
@@ -518,6 +520,9 @@ void Scope::addMembers(const SyntaxNode& syntax) {
 const Symbol* Scope::find(string_view name) const {
     // Just do a simple lookup and return the result if we have one.
     ensureElaborated();
+    if (!nameMap)
+        return nullptr;
+
     auto it = nameMap->find(name);
     if (it == nameMap->end())
         return nullptr;
@@ -554,6 +559,90 @@ span<const WildcardImportSymbol* const> Scope::getWildcardImports() const {
     return compilation.queryImports(importDataIndex);
 }
 
+bool Scope::findWildcardImports(string_view name, LookupLocation location,
+                                SmallVector<WildcardImportMatch>& results) const {
+    if (importDataIndex == ImportDataIndex::Invalid)
+        return false;
+
+    // Imports are stored in declaration order, so find how many of them are visible.
+    auto imports = compilation.queryImports(importDataIndex);
+    auto visibleEnd = std::partition_point(imports.begin(), imports.end(), [&](auto import) {
+        return !(location < LookupLocation::after(*import));
+    });
+
+    uint32_t count = uint32_t(visibleEnd - imports.begin());
+    if (!count)
+        return false;
+
+    // Take what we can from the cache. Searching a package can elaborate other parts of
+    // the design, which can add to the cache and invalidate references into it, so only
+    // copies of the cached data are held while searching.
+    uint32_t numSearched = 0;
+    uint32_t firstMissing = UINT32_MAX;
+    auto& cache = compilation.getImportData(importDataIndex).lookupCache;
+    if (auto it = cache.find(name); it != cache.end()) {
+        numSearched = std::min(it->second.numSearched, count);
+        firstMissing = it->second.firstMissing;
+        for (auto [index, symbol] : it->second.found) {
+            if (index < count)
+                results.append({ symbol, imports[index] });
+        }
+    }
+
+    bool anyMissing = firstMissing < count;
+    if (numSearched == count)
+        return anyMissing;
+
+    // Search the rest of the visible imports. Packages that export imported symbols
+    // can gain new exports while they are being elaborated, so results from them
+    // (and anything after them) are not cached.
+    uint32_t startIndex = numSearched;
+    SmallVectorSized<std::pair<uint32_t, const Symbol*>, 4> newlyFound;
+    bool caching = true;
+    for (uint32_t i = startIndex; i < count; i++) {
+        auto import = compilation.queryImports(importDataIndex)[i];
+        auto package = import->getPackage();
+        if (!package) {
+            anyMissing = true;
+            if (caching && firstMissing == UINT32_MAX)
+                firstMissing = i;
+        }
+        else {
+            caching &= !package->hasExportAll && package->exportDecls.empty();
+            if (auto imported = package->findForImport(name)) {
+                results.append({ imported, import });
+                if (caching)
+                    newlyFound.append({ i, imported });
+            }
+        }
+
+        if (caching)
+            numSearched = i + 1;
+    }
+
+    if (numSearched == startIndex)
+        return anyMissing;
+
+    auto& data = compilation.getImportData(importDataIndex);
+    auto it = data.lookupCache.find(name);
+    if (it == data.lookupCache.end()) {
+        // The name might not outlive the lookup, so the cache keeps its own copy.
+        auto mem = (char*)compilation.allocate(name.size(), 1);
+        memcpy(mem, name.data(), name.size());
+        it = data.lookupCache.emplace(string_view(mem, name.size()), ImportCacheEntry{}).first;
+    }
+
+    // Only extend the entry if nothing else already did so while we were searching.
+    auto& entry = it->second;
+    if (entry.numSearched == startIndex) {
+        entry.found.insert(entry.found.end(), newlyFound.begin(), newlyFound.end());
+        entry.numSearched = numSearched;
+        entry.firstMissing = firstMissing;
+    }
+
+    return anyMissing;
+}
+
 Scope::DeferredMemberData& Scope::getOrAddDeferredData() const {
     return compilation.getOrAddDeferredData(deferredMemberIndex);
 }
@@ -602,6 +691,9 @@ void Scope::insertMember(const Symbol* member, const Symbol* at, bool isElaborat
     // Add to the name map if the symbol has a name and can be looked up
     // by name in the default namespace.
     if (!member->name.empty() && canLookupByName(member->kind)) {
+        if (!nameMap)
+            nameMap = compilation.allocSymbolMap();
+
         auto pair = nameMap->emplace(member->name, member);
         if (!pair.second)
             handleNameConflict(*member, pair.first->second, isElaborating);
@@ -772,6 +864,15 @@ void Scope::checkImportConflict(const Symbol& member, const Symbol& existing) co
 
 void Scope::elaborate() const {
     ASSERT(deferredMemberIndex != DeferredMemberIndex::Invalid);
+
+    // When collecting statistics, work done here counts toward the
+    // definition of the instance that contains this scope.
+    optional<Compilation::DefinitionStatsScope> statsScope;
+    if (compilation.getOptions().collectStats) {
+        if (auto def = thisSym->getDeclaringDefinition())
+            statsScope.emplace(compilation, *def);
+    }
+
     auto deferredData = compilation.getOrAddDeferredData(deferredMemberIndex);
     deferredMemberIndex = DeferredMemberIndex::Invalid;
 
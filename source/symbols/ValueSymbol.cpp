@@ -191,6 +191,120 @@ bool ValueSymbol::Driver::overlaps(const Driver& other) const {
     return true;
 }
 
+// Drivers are indexed by the range they cover in the outermost dimension of the
+// value, using an AVL tree ordered by the lower bound of that range and augmented
+// with the maximum upper bound of each subtree. Drivers of the whole value cover
+// every possible index. Nodes live in the compilation's arena.
+struct ValueSymbol::DriverIndex {
+    struct Node {
+        const Driver* driver;
+        Node* left = nullptr;
+        Node* right = nullptr;
+        int32_t lower;
+        int32_t upper;
+        int32_t maxUpper;
+        uint32_t order;
+        int height = 1;
+
+        Node(const Driver& driver, int32_t lower, int32_t upper, uint32_t order) :
+            driver(&driver), lower(lower), upper(upper), maxUpper(upper), order(order) {}
+    };
+
+    Node* root = nullptr;
+    const Driver* last = nullptr;
+    uint32_t count = 0;
+
+    void add(Compilation& comp, const Driver& driver) {
+        last = &driver;
+        uint32_t order = count++;
+        if (driver.hasError)
+            return;
+
+        auto [lower, upper] = getBounds(driver);
+        root = insert(root, comp.emplace<Node>(driver, lower, upper, order));
+    }
+
+    template<typename TFunc>
+    void query(int32_t lower, int32_t upper, TFunc&& func) const {
+        query(root, lower, upper, func);
+    }
+
+    static std::pair<int32_t, int32_t> getBounds(const Driver& driver) {
+        auto prefix = driver.getPrefix();
+        if (prefix.empty())
+            return { INT32_MIN, INT32_MAX };
+        return { prefix[0].lower(), prefix[0].upper() };
+    }
+
+private:
+    static int height(const Node* node) { return node ? node->height : 0; }
+
+    static void update(Node* node) {
+        node->height = 1 + std::max(height(node->left), height(node->right));
+        node->maxUpper = node->upper;
+        if (node->left)
+            node->maxUpper = std::max(node->maxUpper, node->left->maxUpper);
+        if (node->right)
+            node->maxUpper = std::max(node->maxUpper, node->right->maxUpper);
+    }
+
+    static Node* rotateLeft(Node* node) {
+        Node* result = node->right;
+        node->right = result->left;
+        result->left = node;
+        update(node);
+        update(result);
+        return result;
+    }
+
+    static Node* rotateRight(Node* node) {
+        Node* result = node->left;
+        node->left = result->right;
+        result->right = node;
+        update(node);
+        update(result);
+        return result;
+    }
+
+    static Node* insert(Node* node, Node* newNode) {
+        if (!node)
+            return newNode;
+
+        // New nodes always have the highest order, so ties go to the right.
+        if (newNode->lower < node->lower)
+            node->left = insert(node->left, newNode);
+        else
+            node->right = insert(node->right, newNode);
+
+        update(node);
+        int balance = height(node->left) - height(node->right);
+        if (balance > 1) {
+            if (height(node->left->left) < height(node->left->right))
+                node->left = rotateLeft(node->left);
+            return rotateRight(node);
+        }
+        if (balance < -1) {
+            if (height(node->right->right) < height(node->right->left))
+                node->right = rotateRight(node->right);
+            return rotateLeft(node);
+        }
+        return node;
+    }
+
+    template<typename TFunc>
+    static void query(const Node* node, int32_t lower, int32_t upper, TFunc& func) {
+        while (node && node->maxUpper >= lower) {
+            query(node->left, lower, upper, func);
+            if (node->lower > upper)
+                return;
+
+            if (node->upper >= lower)
+                func(*node);
+            node = node->right;
+        }
+    }
+};
+
 static bool handleOverlap(const Scope& scope, string_view name, const ValueSymbol::Driver& curr,
                           const ValueSymbol::Driver& driver, bool isNet, bool isUWire,
                           bool isSingleDriverUDNT, const NetType* netType) {
@@ -392,10 +506,17 @@ void ValueSymbol::addDriverImpl(const Scope& scope, const Driver& driver) const
                               isUWire || isSingleDriverUDNT ||
                               kind == SymbolKind::LocalAssertionVar;
 
-    // Walk the list of drivers to the end and add this one there.
-    // Along the way, check that the driver is valid given the ones that already exist.
-    auto curr = firstDriver;
-    while (true) {
+    if (!driverIndex) {
+        driverIndex = comp.emplace<DriverIndex>();
+        driverIndex->add(comp, *firstDriver);
+    }
+
+    // Find the existing drivers that could overlap this one, in whatever order the
+    // index returns them, and keep the ones that actually conflict with it. Then add
+    // this one to the end of the list.
+    SmallVectorSized<const DriverIndex::Node*, 8> conflicts;
+    auto findConflicts = [&](const DriverIndex::Node& node) {
+        auto curr = node.driver;
         // Determine whether we should check this pair of drivers for overlap.
         // - If this is for a mix of input/output and inout ports, always check.
         // - Don't check for "Other" drivers (procedural force / release, etc)
@@ -431,20 +552,53 @@ void ValueSymbol::addDriverImpl(const Scope& scope, const Driver& driver) const
             }
         }
 
-        if (shouldCheck && curr->overlaps(driver)) {
-            if (!handleOverlap(scope, name, *curr, driver, isNet, isUWire, isSingleDriverUDNT,
-                               netType)) {
-                return;
-            }
-        }
+        if (shouldCheck && curr->overlaps(driver))
+            conflicts.append(&node);
+    };
+
+    if (!driver.hasError) {
+        auto [lower, upper] = DriverIndex::getBounds(driver);
+        driverIndex->query(lower, upper, findConflicts);
+    }
 
-        if (!curr->next) {
-            curr->next = &driver;
+    // Conflicts are reported in the order the drivers were added. There are rarely
+    // more than a few of them, so only they get sorted and not every candidate.
+    std::sort(conflicts.begin(), conflicts.end(),
+              [](auto a, auto b) { return a->order < b->order; });
+
+    for (auto node : conflicts) {
+        if (!handleOverlap(scope, name, *node->driver, driver, isNet, isUWire,
+                           isSingleDriverUDNT, netType)) {
             return;
         }
+    }
 
-        curr = curr->next;
+    driverIndex->last->next = &driver;
+    driverIndex->add(comp, driver);
+}
+
+void ValueSymbol::getOverlappingDrivers(ConstantRange range,
+                                        SmallVector<const Driver*>& results) const {
+    if (!firstDriver)
+        return;
+
+    int32_t lower = range.lower();
+    int32_t upper = range.upper();
+    if (!driverIndex) {
+        if (!firstDriver->hasError) {
+            auto [driverLower, driverUpper] = DriverIndex::getBounds(*firstDriver);
+            if (driverLower <= upper && driverUpper >= lower)
+                results.append(firstDriver);
+        }
+        return;
     }
+
+    SmallVectorSized<const DriverIndex::Node*, 8> nodes;
+    driverIndex->query(lower, upper, [&](const DriverIndex::Node& node) { nodes.append(&node); });
+
+    std::sort(nodes.begin(), nodes.end(), [](auto a, auto b) { return a->order < b->order; });
+    for (auto node : nodes)
+        results.append(node->driver);
 }
 
 } // namespace slang
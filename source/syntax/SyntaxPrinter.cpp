@@ -114,9 +114,28 @@ std::string SyntaxPrinter::printFile(const SyntaxTree& tree) {
         .str();
 }
 
+void SyntaxPrinter::flush() {
+    if (!output || buffer.empty())
+        return;
+
+    // Remember the last character so that newline squashing keeps
+    // working across chunk boundaries.
+    lastFlushed = buffer.back();
+    output(buffer);
+    buffer.clear();
+}
+
+bool SyntaxPrinter::endsWithNewline() const {
+    if (buffer.empty())
+        return lastFlushed == '\n';
+    return buffer.back() == '\n';
+}
+
 void SyntaxPrinter::append(string_view text) {
     if (!squashNewlines) {
         buffer.append(text);
+        if (output && buffer.size() >= outputChunkSize)
+            flush();
         return;
     }
 
@@ -143,7 +162,7 @@ void SyntaxPrinter::append(string_view text) {
         text = text.substr(i);
     }
 
-    if (buffer.empty() || buffer.back() != '\n') {
+    if (!endsWithNewline()) {
         if (carriage)
             buffer.push_back('\r');
         if (newline)
@@ -151,6 +170,8 @@ void SyntaxPrinter::append(string_view text) {
     }
 
     buffer.append(text);
+    if (output && buffer.size() >= outputChunkSize)
+        flush();
 }
 
 } // namespace slang
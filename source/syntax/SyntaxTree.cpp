@@ -6,10 +6,442 @@
 //------------------------------------------------------------------------------
 #include "slang/syntax/SyntaxTree.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "slang/parsing/Parser.h"
 #include "slang/parsing/Preprocessor.h"
+#include "slang/syntax/AllSyntax.h"
+#include "slang/syntax/SyntaxTreeCache.h"
 #include "slang/text/SourceManager.h"
 
+namespace {
+
+using namespace slang;
+
+// Mirrors the parser's tracking of locally declared modules so that we can
+// tell which instantiations refer to global modules.
+class InstanceTracker {
+public:
+    // Type names of the instantiations of global modules within the visited nodes;
+    // their text makes up the names reported in the parser's metadata.
+    std::vector<Token> globalInstances;
+
+    // Called before visiting the children of the given node; returns true
+    // if the node is a module, in which case @a exit must be called after.
+    bool enter(const SyntaxNode& node) {
+        if (ModuleDeclarationSyntax::isKind(node.kind)) {
+            if (!localModules.empty())
+                localModules.back().emplace(node.as<ModuleDeclarationSyntax>().header->name.valueText());
+            localModules.emplace_back();
+            return true;
+        }
+        return false;
+    }
+
+    void exit() { localModules.pop_back(); }
+
+    // Records the given instantiation if it refers to a global module.
+    void add(const HierarchyInstantiationSyntax& node) {
+        string_view name = node.type.valueText();
+        if (!name.empty() && node.type.kind == TokenKind::Identifier && !isLocalModule(name))
+            globalInstances.push_back(node.type);
+    }
+
+private:
+    bool isLocalModule(string_view name) const {
+        for (auto& set : localModules) {
+            if (set.find(name) != set.end())
+                return true;
+        }
+        return false;
+    }
+
+    std::vector<flat_hash_set<string_view>> localModules;
+};
+
+// Checks whether a directive can be moved between buffers. State directives (like
+// `timescale) are only allowed after the reparsed region, since they would have
+// affected the way the region got parsed.
+bool canRelocate(SyntaxKind directive, bool allowStateDirectives) {
+    switch (directive) {
+        // These either pull in other buffers or change state
+        // in the source manager, so they can never be moved.
+        case SyntaxKind::IncludeDirective:
+        case SyntaxKind::LineDirective:
+        case SyntaxKind::PragmaDirective:
+        case SyntaxKind::MacroUsage:
+            return false;
+        // These have no effect on how a region of text without
+        // directives and macro usages gets parsed.
+        case SyntaxKind::DefineDirective:
+        case SyntaxKind::UndefDirective:
+        case SyntaxKind::UndefineAllDirective:
+        case SyntaxKind::IfDefDirective:
+        case SyntaxKind::IfNDefDirective:
+        case SyntaxKind::ElsIfDirective:
+        case SyntaxKind::ElseDirective:
+        case SyntaxKind::EndIfDirective:
+        case SyntaxKind::CellDefineDirective:
+        case SyntaxKind::EndCellDefineDirective:
+            return true;
+        default:
+            return allowStateDirectives;
+    }
+}
+
+// Copies syntax nodes into a new allocator, moving all of their source locations
+// from one buffer into another at a fixed offset. This is how incremental reparsing
+// carries unchanged members of the old tree (and the newly parsed region, which is
+// parsed from its own buffer) over into the buffer holding the edited text.
+class NodeRelocator : public SyntaxNodeReader {
+public:
+    // Set if anything was encountered that can't be moved between buffers,
+    // such as tokens from macro expansions or include files.
+    bool failed = false;
+
+    // Copies of each of the tracked nodes, keyed by the original node.
+    flat_hash_map<const SyntaxNode*, SyntaxNode*> nodeMap;
+
+    // Tracks global modules instantiated within the copied nodes.
+    InstanceTracker instances;
+
+    NodeRelocator(BumpAllocator& alloc, SourceBuffer from, SourceBuffer to, ptrdiff_t shift,
+                  bool allowStateDirectives, const flat_hash_set<const SyntaxNode*>& tracked) :
+        alloc(alloc),
+        factory(alloc), from(from), to(to), shift(shift),
+        allowStateDirectives(allowStateDirectives), tracked(tracked) {}
+
+    SyntaxNode& relocate(const SyntaxNode& node) {
+        bool isModule = instances.enter(node);
+
+        stack.push_back({ &node, 0 });
+        SyntaxNode* result = factory.deserialize(node.kind, *this);
+        ASSERT(result);
+
+        popFinishedLists();
+        stack.pop_back();
+
+        if (isModule)
+            instances.exit();
+        else if (node.kind == SyntaxKind::HierarchyInstantiation)
+            instances.add(result->as<HierarchyInstantiationSyntax>());
+
+        if (tracked.find(&node) != tracked.end())
+            nodeMap[&node] = result;
+
+        return *result;
+    }
+
+    Token relocate(Token token) {
+        if (!token)
+            return token;
+
+        SmallVectorSized<Trivia, 8> trivia;
+        for (auto& t : token.trivia())
+            trivia.append(relocate(t));
+
+        auto triviaSpan = trivia.copy(alloc);
+        auto rawText = relocate(token.rawText());
+        auto location = relocate(token.location());
+
+        if (token.isMissing())
+            return token.clone(alloc, triviaSpan, rawText, location);
+
+        // Most token values are stored inline, but a few point at memory
+        // owned by the old tree that needs to be copied.
+        switch (token.kind) {
+            case TokenKind::StringLiteral: {
+                auto value = token.valueText();
+                char* mem = (char*)alloc.allocate(value.size(), alignof(char));
+                memcpy(mem, value.data(), value.size());
+                return Token(alloc, token.kind, triviaSpan, rawText, location,
+                             string_view(mem, value.size()));
+            }
+            case TokenKind::IntegerLiteral:
+                return Token(alloc, token.kind, triviaSpan, rawText, location, token.intValue());
+            default:
+                return token.clone(alloc, triviaSpan, rawText, location);
+        }
+    }
+
+    Token readToken() final {
+        popFinishedLists();
+        auto& frame = stack.back();
+        return relocate(frame.node->childToken(frame.index++));
+    }
+
+protected:
+    SyntaxNode* readNode(bool (*isKind)(SyntaxKind), bool) final {
+        popFinishedLists();
+        auto& frame = stack.back();
+        auto child = frame.node->childNode(frame.index++);
+        if (!child)
+            return nullptr;
+
+        ASSERT(isKind(child->kind));
+        (void)isKind;
+        return &relocate(*child);
+    }
+
+    size_t readListSize(SyntaxKind listKind) final {
+        popFinishedLists();
+        auto& frame = stack.back();
+        auto child = frame.node->childNode(frame.index++);
+        ASSERT(child && child->kind == listKind);
+        (void)listKind;
+
+        stack.push_back({ child, 0 });
+        return child->getChildCount();
+    }
+
+private:
+    struct Frame {
+        const SyntaxNode* node;
+        size_t index;
+    };
+
+    // Lists don't get told when they've been fully read, so their frames
+    // are removed lazily once all of their children have been consumed.
+    void popFinishedLists() {
+        while (stack.size() > 1) {
+            auto& frame = stack.back();
+            if (!SyntaxListBase::isKind(frame.node->kind) ||
+                frame.index < frame.node->getChildCount()) {
+                break;
+            }
+            stack.pop_back();
+        }
+    }
+
+    Trivia relocate(const Trivia& trivia) {
+        switch (trivia.kind) {
+            case TriviaKind::Directive:
+                if (!canRelocate(trivia.syntax()->kind, allowStateDirectives))
+                    failed = true;
+                return Trivia(trivia.kind, &relocate(*trivia.syntax()));
+            case TriviaKind::SkippedSyntax:
+                return Trivia(trivia.kind, &relocate(*trivia.syntax()));
+            case TriviaKind::SkippedTokens: {
+                SmallVectorSized<Token, 8> tokens;
+                for (auto token : trivia.getSkippedTokens())
+                    tokens.append(relocate(token));
+                return Trivia(trivia.kind, tokens.copy(alloc));
+            }
+            default: {
+                Trivia result(trivia.kind, relocate(trivia.getRawText()));
+                if (auto loc = trivia.getExplicitLocation())
+                    result = result.withLocation(alloc, relocate(*loc));
+                return result;
+            }
+        }
+    }
+
+    SourceLocation relocate(SourceLocation location) {
+        if (location.buffer() != from.id) {
+            failed = true;
+            return location;
+        }
+        return SourceLocation(to.id, size_t(ptrdiff_t(location.offset()) + shift));
+    }
+
+    string_view relocate(string_view text) {
+        // Text that doesn't point into the source buffer is either empty or
+        // static, and can be used as is.
+        auto begin = from.data.data();
+        if (text.data() < begin || text.data() + text.size() > begin + from.data.size())
+            return text;
+
+        return string_view(to.data.data() + (text.data() - begin) + shift, text.size());
+    }
+
+    BumpAllocator& alloc;
+    SyntaxFactory factory;
+    SourceBuffer from;
+    SourceBuffer to;
+    ptrdiff_t shift;
+    bool allowStateDirectives;
+    const flat_hash_set<const SyntaxNode*>& tracked;
+    std::vector<Frame> stack;
+};
+
+// Collects all of the tokens in some syntax, including the ones in trivia, so that they
+// can be moved in place later on. Each token is only listed once, since moving a token
+// within its own buffer isn't something that can safely be done twice.
+class TokenCollector {
+public:
+    std::vector<Token> tokens;
+    InstanceTracker instances;
+    bool movable = true;
+    bool hasStateDirectives = false;
+
+    explicit TokenCollector(BufferID buffer) : buffer(buffer) {}
+
+    void visit(const SyntaxNode& node) {
+        bool isModule = instances.enter(node);
+
+        size_t count = node.getChildCount();
+        for (size_t i = 0; i < count; i++) {
+            if (auto child = node.childNode(i))
+                visit(*child);
+            else
+                visit(node.childToken(i));
+        }
+
+        if (isModule)
+            instances.exit();
+        else if (node.kind == SyntaxKind::HierarchyInstantiation)
+            instances.add(node.as<HierarchyInstantiationSyntax>());
+    }
+
+    void visit(Token token) {
+        if (!token || wasSeen(token))
+            return;
+
+        for (auto& trivia : token.trivia()) {
+            switch (trivia.kind) {
+                case TriviaKind::Directive:
+                    if (!canRelocate(trivia.syntax()->kind, true))
+                        movable = false;
+                    if (!canRelocate(trivia.syntax()->kind, false))
+                        hasStateDirectives = true;
+                    visit(*trivia.syntax());
+                    break;
+                case TriviaKind::SkippedSyntax:
+                    visit(*trivia.syntax());
+                    break;
+                case TriviaKind::SkippedTokens:
+                    for (auto skipped : trivia.getSkippedTokens())
+                        visit(skipped);
+                    break;
+                default:
+                    if (auto loc = trivia.getExplicitLocation(); loc && loc->buffer() != buffer)
+                        movable = false;
+                    break;
+            }
+        }
+
+        if (token.location().buffer() != buffer)
+            movable = false;
+        add(token);
+    }
+
+private:
+    // Tokens normally show up in the order of their locations, so one that was already
+    // seen can only be among those at the same location as the last one. If they ever
+    // come out of order, every token gets looked up in a set from then on instead.
+    bool wasSeen(Token token) {
+        auto loc = token.location();
+        if (ordered && loc.buffer() == buffer) {
+            if (tokens.empty() || loc.offset() > lastOffset)
+                return false;
+
+            if (loc.offset() == lastOffset) {
+                for (auto it = tokens.rbegin();
+                     it != tokens.rend() && it->location().offset() == lastOffset; ++it) {
+                    if (*it == token)
+                        return true;
+                }
+                return false;
+            }
+        }
+
+        switchToSet();
+        return seen.find(token) != seen.end();
+    }
+
+    void add(Token token) {
+        auto loc = token.location();
+        if (ordered && (loc.buffer() != buffer || loc.offset() < lastOffset))
+            switchToSet();
+
+        if (!ordered)
+            seen.emplace(token);
+
+        lastOffset = loc.offset();
+        tokens.push_back(token);
+    }
+
+    void switchToSet() {
+        if (ordered) {
+            ordered = false;
+            seen.insert(tokens.begin(), tokens.end());
+        }
+    }
+
+    // Tokens compare equal when they share the same data, which
+    // is also what gets modified when they're moved.
+    struct TokenHash {
+        size_t operator()(Token token) const {
+            return std::hash<SourceLocation>()(token.location());
+        }
+    };
+
+    BufferID buffer;
+    bool ordered = true;
+    size_t lastOffset = 0;
+    flat_hash_set<Token, TokenHash> seen;
+};
+
+// Returns a copy of the given diagnostic with all of its locations moved
+// into the given buffer at the given offset.
+Diagnostic relocateDiagnostic(const Diagnostic& diag, BufferID buffer, ptrdiff_t shift) {
+    auto relocate = [&](SourceLocation loc) {
+        return SourceLocation(buffer, size_t(ptrdiff_t(loc.offset()) + shift));
+    };
+
+    Diagnostic result = diag;
+    result.location = relocate(diag.location);
+    for (auto& range : result.ranges)
+        range = SourceRange(relocate(range.start()), relocate(range.end()));
+    for (auto& note : result.notes)
+        note = relocateDiagnostic(note, buffer, shift);
+    return result;
+}
+
+// Checks whether the given diagnostic and all of its notes are located in the given buffer.
+bool isInBuffer(const Diagnostic& diag, BufferID buffer) {
+    if (diag.location.buffer() != buffer)
+        return false;
+
+    for (auto& range : diag.ranges) {
+        if (range.start().buffer() != buffer || range.end().buffer() != buffer)
+            return false;
+    }
+
+    for (auto& note : diag.notes) {
+        if (!isInBuffer(note, buffer))
+            return false;
+    }
+    return true;
+}
+
+void addAllNodes(flat_hash_set<const SyntaxNode*>& set, const SyntaxNode& node) {
+    set.emplace(&node);
+    for (size_t i = 0; i < node.getChildCount(); i++) {
+        if (auto child = node.childNode(i))
+            addAllNodes(set, *child);
+    }
+}
+
+void addTrackedNodes(flat_hash_set<const SyntaxNode*>& set, const Parser::Metadata& meta) {
+    for (auto& [node, _] : meta.nodeMap)
+        set.emplace(node);
+
+    auto addAll = [&](auto& list) {
+        for (auto node : list)
+            set.emplace(node);
+    };
+
+    addAll(meta.classPackageNames);
+    addAll(meta.packageImports);
+    addAll(meta.defparams);
+    addAll(meta.classDecls);
+    addAll(meta.bindDirectives);
+}
+
+} // namespace
+
 namespace slang {
 
 SyntaxTree::SyntaxTree(SyntaxNode* root, SourceManager& sourceManager, BumpAllocator&& alloc,
@@ -73,11 +505,489 @@ SyntaxTree::SyntaxTree(SyntaxNode* root, SourceManager& sourceManager, BumpAlloc
     rootNode(root),
     sourceMan(sourceManager), metadata(std::move(metadata)), alloc(std::move(alloc)),
     diagnosticsBuffer(std::move(diagnostics)), options_(std::move(options)), eof(eof) {
+    compactedSize = this->alloc.getBytesAllocated();
+}
+
+std::shared_ptr<SyntaxTree> SyntaxTree::reparse(const SyntaxTree& tree, SourceRange range,
+                                                string_view text) {
+    return reparseImpl(tree, nullptr, range, text);
+}
+
+std::shared_ptr<SyntaxTree> SyntaxTree::reparse(std::shared_ptr<SyntaxTree>&& tree,
+                                                SourceRange range, string_view text) {
+    std::shared_ptr<SyntaxTree> old = std::move(tree);
+    ASSERT(old);
+
+    // The old tree's memory can only be taken over if nothing else can see it. Once the
+    // replaced members have left behind as much unused memory as the rest of the tree
+    // needs, copy everything into a fresh tree instead so that it gets reclaimed.
+    bool owned = old.use_count() == 1 && !old->parentTree &&
+                 old->alloc.getBytesAllocated() < 2 * old->compactedSize;
+
+    return reparseImpl(*old, owned ? old.get() : nullptr, range, text);
+}
+
+std::shared_ptr<SyntaxTree> SyntaxTree::reparseImpl(const SyntaxTree& tree, SyntaxTree* owned,
+                                                    SourceRange range, string_view text) {
+    SourceManager& sourceManager = tree.sourceMan;
+    bool isCompilationUnit = tree.root().kind == SyntaxKind::CompilationUnit;
+
+    BufferID buffer = tree.eof.location().buffer();
+    if (range.start().buffer() != buffer || range.end().buffer() != buffer ||
+        range.start().offset() > range.end().offset()) {
+        throw std::invalid_argument("Edit range must be within the syntax tree's source buffer");
+    }
+
+    string_view oldText = sourceManager.getSourceText(buffer);
+    if (!oldText.empty() && oldText.back() == '\0')
+        oldText.remove_suffix(1);
+
+    size_t editStart = range.start().offset();
+    size_t editEnd = range.end().offset();
+    if (editEnd > oldText.size())
+        throw std::invalid_argument("Edit range must be within the syntax tree's source buffer");
+
+    // The edited text normally goes into its own buffer, which takes on the name of the
+    // old one. It's only created once it's needed, since the old tree's buffer might get
+    // edited in place instead, in which case this refers to that buffer.
+    SourceBuffer newBuffer;
+    OwnedBuffer newBufferOwner;
+    auto assignNewText = [&] {
+        std::string newText;
+        newText.reserve(oldText.size() - (editEnd - editStart) + text.size());
+        newText.append(oldText.substr(0, editStart));
+        newText.append(text);
+        newText.append(oldText.substr(editEnd));
+
+        newBuffer = sourceManager.assignText(newText);
+        newBufferOwner = OwnedBuffer(sourceManager, newBuffer.id);
+        sourceManager.addLineDirective(SourceLocation(newBuffer.id, 0), 2,
+                                       sourceManager.getFileName(SourceLocation(buffer, 0)), 0);
+    };
+
+    auto fullParse = [&] {
+        if (!newBuffer)
+            assignNewText();
+
+        auto result = create(sourceManager, span(&newBuffer, 1), tree.options_,
+                             !isCompilationUnit);
+        result->isLibrary = tree.isLibrary;
+        result->textBuffer = std::move(newBufferOwner);
+        result->reparseStats.emplace();
+        result->reparseStats->fullParse = true;
+        return result;
+    };
+
+    if (!isCompilationUnit)
+        return fullParse();
+
+    // Each top-level member owns the text from the end of the previous member
+    // (which includes its leading trivia) up to the end of its last token.
+    // The EndOfFile token is treated as one final member.
+    auto& root = tree.root().as<CompilationUnitSyntax>();
+    auto& members = root.members;
+    size_t numMembers = members.size();
+
+    SmallVectorSized<size_t, 16> ends(numMembers + 1);
+    for (auto member : members) {
+        Token last = member->getLastToken();
+        if (last.location().buffer() != buffer)
+            return fullParse();
+        ends.append(last.location().offset() + last.rawText().size());
+    }
+    ends.append(oldText.size());
+
+    auto memberStart = [&](size_t index) { return index ? ends[index - 1] : 0; };
+
+    // Find the members touched by the edit. The member before them is included
+    // too, since it might want to absorb whatever tokens now follow it.
+    size_t first = size_t(std::lower_bound(ends.begin(), ends.end(), editStart) - ends.begin());
+    size_t last = size_t(std::upper_bound(ends.begin(), ends.end(), editEnd) - ends.begin());
+    last = std::min(last, numMembers);
+    if (first)
+        first--;
+
+    ptrdiff_t delta = ptrdiff_t(text.size()) - ptrdiff_t(editEnd - editStart);
+    const Bag& options = tree.options_;
+
+    // The region gets reparsed from a scratch buffer, which is handed down from the old
+    // tree when it's being taken over. Both the buffer and the allocator for the region
+    // are recycled each time the region has to grow.
+    OwnedBuffer scratch = owned ? std::move(owned->scratchBuffer) : OwnedBuffer();
+    BumpAllocator regionAlloc;
+    std::string regionText;
+    while (true) {
+        size_t regionStart = memberStart(first);
+        size_t oldRegionEnd = ends[last];
+        bool reachesEnd = last == numMembers;
+
+        regionText.clear();
+        regionText.append(oldText.substr(regionStart, editStart - regionStart));
+        regionText.append(text);
+        regionText.append(oldText.substr(editEnd, oldRegionEnd - editEnd));
+
+        // Any directives or macros in the region could change how the rest
+        // of the file gets preprocessed, so give up and parse everything.
+        string_view oldRegion = oldText.substr(regionStart, oldRegionEnd - regionStart);
+        if (oldRegion.find('`') != string_view::npos ||
+            regionText.find('`') != std::string::npos) {
+            return fullParse();
+        }
+
+        SourceBuffer regionBuffer;
+        if (scratch.id) {
+            size_t scratchSize = sourceManager.getSourceText(scratch.id).size();
+            regionBuffer = sourceManager.replaceText(scratch.id, 0,
+                                                     scratchSize ? scratchSize - 1 : 0,
+                                                     regionText);
+        }
+
+        if (!regionBuffer) {
+            regionBuffer = sourceManager.assignText(regionText);
+            scratch = OwnedBuffer(sourceManager, regionBuffer.id);
+        }
+
+        regionAlloc.reset();
+        Diagnostics regionDiags;
+        Preprocessor preprocessor(sourceManager, regionAlloc, regionDiags, options);
+        preprocessor.pushSource(regionBuffer);
+
+        Parser parser(preprocessor, options);
+        auto& regionRoot = parser.parseCompilationUnit();
+
+        // If the parser ran off the end of the region, the last member wants to consume
+        // some of the text that follows, so grow the region and try again.
+        if (!reachesEnd) {
+            bool clean = regionRoot.endOfFile.trivia().empty();
+            for (auto& diag : regionDiags) {
+                if (diag.location.buffer() == regionBuffer.id &&
+                    diag.location.offset() >= regionText.size()) {
+                    clean = false;
+                }
+            }
+
+            if (!clean) {
+                last = std::min(numMembers, last + (last - first + 1));
+                continue;
+            }
+        }
+
+        auto regionMeta = parser.getMetadata();
+        flat_hash_set<const SyntaxNode*> regionTracked;
+        addTrackedNodes(regionTracked, regionMeta);
+
+        // Diagnostics from the old tree are kept for the reused members. Anything
+        // between the start of the region and the first reused token after it
+        // belonged to the replaced members.
+        size_t suffixStart = SIZE_MAX;
+        if (!reachesEnd) {
+            Token next = last + 1 < numMembers ? members[last + 1]->getFirstToken()
+                                               : root.endOfFile;
+            suffixStart = next.location().offset();
+        }
+
+        SmallVectorSized<const Diagnostic*, 8> prefixDiags;
+        SmallVectorSized<const Diagnostic*, 8> suffixDiags;
+        for (auto& diag : tree.diagnosticsBuffer) {
+            if (!isInBuffer(diag, buffer))
+                return fullParse();
+
+            size_t offset = diag.location.offset();
+            if (offset < regionStart)
+                prefixDiags.append(&diag);
+            else if (offset >= suffixStart)
+                suffixDiags.append(&diag);
+        }
+
+        for (auto& diag : regionDiags) {
+            if (!isInBuffer(diag, regionBuffer.id))
+                return fullParse();
+        }
+
+        // Nothing else refers to the old tree when it's being taken over, so the reused
+        // members can be moved into the new buffer as they are. That needs the list of
+        // their tokens, which is built the first time around. Members before the region
+        // can't contain directives that would have affected the way the region was parsed.
+        bool reuseBuffer = false;
+        if (owned) {
+            auto& entries = owned->memberTokens;
+            if (entries.empty()) {
+                entries.reserve(numMembers + 1);
+                for (auto member : members)
+                    entries.emplace_back(collectTokens(*member, buffer));
+                entries.emplace_back(collectTokens(root.endOfFile, buffer));
+            }
+
+            for (size_t i = 0; i < first; i++) {
+                if (!entries[i].movable || entries[i].hasStateDirectives)
+                    return fullParse();
+            }
+
+            for (size_t i = last + 1; i <= numMembers && !reachesEnd; i++) {
+                if (!entries[i].movable)
+                    return fullParse();
+            }
+
+            // A buffer that was created for the old tree can simply be edited, which leaves
+            // everything before the edit where it is unless the buffer had to grow.
+            reuseBuffer = owned->textBuffer.id == buffer;
+        }
+
+        SourceBuffer oldBuffer{ oldText, buffer };
+        if (reuseBuffer) {
+            newBuffer = sourceManager.replaceText(buffer, editStart, editEnd - editStart, text);
+            newBufferOwner = std::move(owned->textBuffer);
+        }
+        else {
+            assignNewText();
+        }
+
+        Diagnostics diagnostics;
+        for (auto diag : prefixDiags)
+            diagnostics.append(relocateDiagnostic(*diag, newBuffer.id, 0));
+        for (auto& diag : regionDiags)
+            diagnostics.append(relocateDiagnostic(diag, newBuffer.id, ptrdiff_t(regionStart)));
+        for (auto diag : suffixDiags)
+            diagnostics.append(relocateDiagnostic(*diag, newBuffer.id, delta));
+
+        BumpAllocator alloc;
+        Parser::Metadata meta = owned ? std::move(owned->metadata) : Parser::Metadata();
+        SmallVectorSized<MemberSyntax*, 16> newMembers;
+        Token eof;
+
+        if (owned) {
+            auto& entries = owned->memberTokens;
+            auto moveTokens = [&](size_t begin, size_t end, ptrdiff_t shift) {
+                for (size_t i = begin; i < end; i++) {
+                    for (auto& token : entries[i].tokens) {
+                        bool moved = token.relocateInPlace(oldBuffer, newBuffer, shift);
+                        ASSERT(moved);
+                        (void)moved;
+                    }
+                }
+            };
+
+            if (newBuffer.id != buffer || newBuffer.data.data() != oldText.data())
+                moveTokens(0, first, 0);
+            if (!reachesEnd)
+                moveTokens(last + 1, numMembers + 1, delta);
+
+            alloc = std::move(owned->alloc);
+            NodeRelocator middle(alloc, regionBuffer, newBuffer, ptrdiff_t(regionStart), true,
+                                 regionTracked);
+
+            for (size_t i = 0; i < first; i++)
+                newMembers.append(members[i]);
+            for (auto member : regionRoot.members)
+                newMembers.append(&middle.relocate(*member).as<MemberSyntax>());
+            for (size_t i = last + 1; i < numMembers; i++)
+                newMembers.append(members[i]);
+
+            eof = reachesEnd ? middle.relocate(regionRoot.endOfFile) : root.endOfFile;
+            if (middle.failed)
+                return fullParse();
+
+            // Swap the entries of the replaced members for those of the region.
+            std::vector<MemberTokens> regionEntries;
+            for (size_t i = first; i < first + regionRoot.members.size(); i++)
+                regionEntries.emplace_back(collectTokens(*newMembers[i], newBuffer.id));
+            if (reachesEnd)
+                regionEntries.emplace_back(collectTokens(eof, newBuffer.id));
+
+            entries.erase(entries.begin() + ptrdiff_t(first),
+                          entries.begin() + ptrdiff_t(last + 1));
+            entries.insert(entries.begin() + ptrdiff_t(first),
+                           std::make_move_iterator(regionEntries.begin()),
+                           std::make_move_iterator(regionEntries.end()));
+
+            // The old metadata was taken over above; drop anything that belonged to the
+            // replaced members and splice in the region's metadata in their place.
+            flat_hash_set<const SyntaxNode*> replaced;
+            for (size_t i = first; i <= last && i < numMembers; i++)
+                addAllNodes(replaced, *members[i]);
+
+            for (auto node : replaced)
+                meta.nodeMap.erase(node);
+
+            for (auto& [node, info] : regionMeta.nodeMap) {
+                if (auto it = middle.nodeMap.find(node); it != middle.nodeMap.end())
+                    meta.nodeMap[it->second] = info;
+            }
+
+            // The names of instantiated modules point into the buffer,
+            // so they're gathered again now that everything has moved.
+            meta.globalInstances.clear();
+            for (auto& entry : entries) {
+                for (auto token : entry.instances)
+                    meta.globalInstances.emplace(token.valueText());
+            }
+
+            auto splice = [&](auto& list, auto& regionList) {
+                using T = std::remove_pointer_t<typename std::decay_t<decltype(list)>::value_type>;
+                SmallVectorSized<T*, 8> result;
+                bool spliced = false;
+                auto addRegion = [&] {
+                    for (auto node : regionList) {
+                        if (auto it = middle.nodeMap.find(node); it != middle.nodeMap.end())
+                            result.append(&it->second->template as<std::remove_const_t<T>>());
+                    }
+                    spliced = true;
+                };
+
+                for (auto node : list) {
+                    if (replaced.find(node) != replaced.end())
+                        continue;
+
+                    if (!spliced && node->getFirstToken().location().offset() >= regionStart)
+                        addRegion();
+                    result.append(node);
+                }
+
+                if (!spliced)
+                    addRegion();
+
+                list.clear();
+                list.appendRange(result);
+            };
+
+            splice(meta.classPackageNames, regionMeta.classPackageNames);
+            splice(meta.packageImports, regionMeta.packageImports);
+            splice(meta.defparams, regionMeta.defparams);
+            splice(meta.classDecls, regionMeta.classDecls);
+            splice(meta.bindDirectives, regionMeta.bindDirectives);
+        }
+        else {
+            flat_hash_set<const SyntaxNode*> oldTracked;
+            addTrackedNodes(oldTracked, tree.metadata);
+
+            // Copy everything into the new buffer. Members before the region can't contain
+            // directives that would have affected the way the region was parsed.
+            NodeRelocator before(alloc, oldBuffer, newBuffer, 0, false, oldTracked);
+            NodeRelocator middle(alloc, regionBuffer, newBuffer, ptrdiff_t(regionStart), true,
+                                 regionTracked);
+            NodeRelocator after(alloc, oldBuffer, newBuffer, delta, true, oldTracked);
+
+            for (size_t i = 0; i < first; i++)
+                newMembers.append(&before.relocate(*members[i]).as<MemberSyntax>());
+            for (auto member : regionRoot.members)
+                newMembers.append(&middle.relocate(*member).as<MemberSyntax>());
+            for (size_t i = last + 1; i < numMembers; i++)
+                newMembers.append(&after.relocate(*members[i]).as<MemberSyntax>());
+
+            eof = reachesEnd ? middle.relocate(regionRoot.endOfFile)
+                             : after.relocate(root.endOfFile);
+
+            if (before.failed || middle.failed || after.failed)
+                return fullParse();
+
+            // Rebuild the metadata, keeping everything in document order.
+            auto& oldMeta = tree.metadata;
+            for (auto& [node, info] : oldMeta.nodeMap) {
+                if (auto it = before.nodeMap.find(node); it != before.nodeMap.end())
+                    meta.nodeMap[it->second] = info;
+                else if (auto it2 = after.nodeMap.find(node); it2 != after.nodeMap.end())
+                    meta.nodeMap[it2->second] = info;
+            }
+
+            for (auto& [node, info] : regionMeta.nodeMap) {
+                if (auto it = middle.nodeMap.find(node); it != middle.nodeMap.end())
+                    meta.nodeMap[it->second] = info;
+            }
+
+            for (auto relocator : { &before, &middle, &after }) {
+                for (auto token : relocator->instances.globalInstances)
+                    meta.globalInstances.emplace(token.valueText());
+            }
+
+            auto remap = [&](auto& dest, auto& oldList, auto& regionList) {
+                using T = std::remove_pointer_t<typename std::decay_t<decltype(dest)>::value_type>;
+                auto append = [&](NodeRelocator& relocator, auto& list) {
+                    for (auto node : list) {
+                        if (auto it = relocator.nodeMap.find(node); it != relocator.nodeMap.end())
+                            dest.append(&it->second->template as<std::remove_const_t<T>>());
+                    }
+                };
+
+                append(before, oldList);
+                append(middle, regionList);
+                append(after, oldList);
+            };
+
+            remap(meta.classPackageNames, oldMeta.classPackageNames, regionMeta.classPackageNames);
+            remap(meta.packageImports, oldMeta.packageImports, regionMeta.packageImports);
+            remap(meta.defparams, oldMeta.defparams, regionMeta.defparams);
+            remap(meta.classDecls, oldMeta.classDecls, regionMeta.classDecls);
+            remap(meta.bindDirectives, oldMeta.bindDirectives, regionMeta.bindDirectives);
+        }
+
+        size_t membersParsed = regionRoot.members.size();
+        size_t membersReused = newMembers.size() - membersParsed;
+
+        auto newRoot = alloc.emplace<CompilationUnitSyntax>(newMembers.copy(alloc), eof);
+        auto result = std::shared_ptr<SyntaxTree>(
+            new SyntaxTree(newRoot, sourceManager, std::move(alloc), std::move(diagnostics),
+                           std::move(meta), options, eof));
+        result->isLibrary = tree.isLibrary;
+        result->reparseStats.emplace();
+        result->reparseStats->membersParsed = membersParsed;
+        result->reparseStats->membersReused = membersReused;
+        result->reparseStats->reusedInPlace = owned != nullptr;
+        result->reparseStats->bufferReused = reuseBuffer;
+        result->textBuffer = std::move(newBufferOwner);
+        result->scratchBuffer = std::move(scratch);
+
+        // Memory left behind by the replaced members still counts against the old size.
+        if (owned) {
+            result->compactedSize = owned->compactedSize;
+            result->memberTokens = std::move(owned->memberTokens);
+        }
+        return result;
+    }
+}
+
+SyntaxTree::MemberTokens SyntaxTree::collectTokens(const SyntaxNode& member, BufferID buffer) {
+    TokenCollector collector(buffer);
+    collector.visit(member);
+    return { std::move(collector.tokens), std::move(collector.instances.globalInstances),
+             collector.movable, collector.hasStateDirectives };
+}
+
+SyntaxTree::MemberTokens SyntaxTree::collectTokens(Token eof, BufferID buffer) {
+    TokenCollector collector(buffer);
+    collector.visit(eof);
+    return { std::move(collector.tokens), std::move(collector.instances.globalInstances),
+             collector.movable, collector.hasStateDirectives };
+}
+
+SyntaxTree::OwnedBuffer::OwnedBuffer(OwnedBuffer&& other) noexcept :
+    sourceManager(other.sourceManager), id(std::exchange(other.id, BufferID())) {
+}
+
+SyntaxTree::OwnedBuffer& SyntaxTree::OwnedBuffer::operator=(OwnedBuffer&& other) noexcept {
+    if (this != &other) {
+        if (id)
+            sourceManager->releaseBuffer(id);
+        sourceManager = other.sourceManager;
+        id = std::exchange(other.id, BufferID());
+    }
+    return *this;
+}
+
+SyntaxTree::OwnedBuffer::~OwnedBuffer() {
+    if (id)
+        sourceManager->releaseBuffer(id);
 }
 
 std::shared_ptr<SyntaxTree> SyntaxTree::create(SourceManager& sourceManager,
                                                span<const SourceBuffer> sources, const Bag& options,
                                                bool guess) {
+    // Guessing is only done for snippets of text, which aren't worth caching.
+    SyntaxTreeCache* cache = guess ? nullptr : options.getOrDefault<SyntaxCacheOptions>().cache;
+    if (cache) {
+        if (auto tree = cache->load(sourceManager, sources, options))
+            return tree;
+    }
+
     BumpAllocator alloc;
     Diagnostics diagnostics;
     Preprocessor preprocessor(sourceManager, alloc, diagnostics, options);
@@ -96,9 +1006,14 @@ std::shared_ptr<SyntaxTree> SyntaxTree::create(SourceManager& sourceManager,
             return create(sourceManager, sources, options, false);
     }
 
-    return std::shared_ptr<SyntaxTree>(new SyntaxTree(root, sourceManager, std::move(alloc),
-                                                      std::move(diagnostics), parser.getMetadata(),
-                                                      options, parser.getEOFToken()));
+    auto tree = std::shared_ptr<SyntaxTree>(new SyntaxTree(
+        root, sourceManager, std::move(alloc), std::move(diagnostics), parser.getMetadata(),
+        options, parser.getEOFToken()));
+
+    if (cache)
+        cache->store(*tree, sources);
+
+    return tree;
 }
 
 } // namespace slang
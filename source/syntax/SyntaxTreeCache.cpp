@@ -0,0 +1,896 @@
+//------------------------------------------------------------------------------
+// SyntaxTreeCache.cpp
+// On-disk cache of parsed syntax trees
+//
+// File is under the MIT license; see LICENSE for details
+//------------------------------------------------------------------------------
+#include "slang/syntax/SyntaxTreeCache.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fmt/format.h>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+#include "slang/parsing/LexerFacts.h"
+#include "slang/parsing/Preprocessor.h"
+#include "slang/syntax/AllSyntax.h"
+#include "slang/syntax/SyntaxTree.h"
+#include "slang/text/SourceManager.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using namespace slang;
+
+// Each cache file is laid out as:
+// - The magic bytes and format version.
+// - The buffer table, which describes every source buffer referenced by a location
+//   in the tree so that equivalent buffers can be recreated in the loading process's
+//   SourceManager. Locations in the rest of the file refer to buffers by their index
+//   in this table.
+// - The root node, followed by the EOF token and the parser metadata.
+//
+// Nearly all integers are written as variable length (LEB128) values, since
+// the vast majority of them (kinds, offsets, lengths) are small.
+constexpr char Magic[8] = { 'S', 'L', 'A', 'N', 'G', 'S', 'Y', 'N' };
+constexpr uint32_t Version = 1;
+
+// Indices 0 and 1 in serialized locations are reserved for
+// the invalid buffer and the "no location" buffer, respectively.
+constexpr uint32_t FirstBufferIndex = 2;
+const uint32_t NoLocationBufferId = SourceLocation::NoLocation.buffer().getId();
+
+enum class BufferKind : uint8_t { Source, Include, Text, Expansion };
+
+// Token values that don't fit in the token kind are stored in these flags.
+enum TokenFlags : uint8_t { Missing = 1 };
+
+enum IntegerFlags : uint8_t { Signed = 1, Unknown = 2 };
+
+class CacheWriter {
+public:
+    CacheWriter(const SourceManager& sourceManager, span<const SourceBuffer> sources) :
+        sourceManager(sourceManager), sources(sources) {}
+
+    // Serializes the given tree, returning false if it can't be cached.
+    bool write(const SyntaxTree& tree, std::vector<char>& result) {
+        writeNode(&tree.root());
+        writeToken(tree.getEOFToken());
+        writeMetadata(tree.getMetadata());
+
+        // Now that we know which buffers the tree refers to,
+        // write out the table describing them ahead of the body.
+        std::vector<char> body = std::move(out);
+        out.clear();
+
+        out.insert(out.end(), std::begin(Magic), std::end(Magic));
+        writeRaw(Version);
+        writeBuffers();
+
+        if (!cacheable)
+            return false;
+
+        out.insert(out.end(), body.begin(), body.end());
+        result = std::move(out);
+        return true;
+    }
+
+private:
+    void writeNode(const SyntaxNode* node) {
+        if (!node) {
+            writeVarInt(0);
+            return;
+        }
+
+        nodeIds.emplace(node, nextNodeId++);
+        writeVarInt(uint64_t(node->kind) + 1);
+
+        switch (node->kind) {
+            case SyntaxKind::LineDirective:
+                // This alters the source manager in ways that can't be
+                // recovered just from the buffer table.
+                cacheable = false;
+                break;
+            case SyntaxKind::PragmaDirective:
+                if (node->as<PragmaDirectiveSyntax>().name.valueText() == "diagnostic")
+                    cacheable = false;
+                break;
+            case SyntaxKind::IncludeDirective: {
+                auto& include = node->as<IncludeDirectiveSyntax>();
+                includes.emplace(include.directive.location(), &include);
+                break;
+            }
+            default:
+                break;
+        }
+
+        if (SyntaxListBase::isKind(node->kind)) {
+            auto& list = static_cast<const SyntaxListBase&>(*node);
+            size_t count = list.getChildCount();
+            writeVarInt(count);
+            for (size_t i = 0; i < count; i++)
+                writeChild(list.getChild(i));
+        }
+        else {
+            size_t count = node->getChildCount();
+            for (size_t i = 0; i < count; i++) {
+                GetChildVisitor visitor;
+                writeChild(node->visit(visitor, i));
+            }
+        }
+    }
+
+    void writeChild(ConstTokenOrSyntax child) {
+        if (child.isToken())
+            writeToken(child.token());
+        else
+            writeNode(child.node());
+    }
+
+    void writeToken(Token token) {
+        if (!token) {
+            writeVarInt(0);
+            return;
+        }
+
+        writeVarInt(uint64_t(token.kind) + 1);
+        out.push_back(char(token.isMissing() ? TokenFlags::Missing : 0));
+        writeLocation(token.location());
+
+        auto trivia = token.trivia();
+        writeVarInt(trivia.size());
+        for (auto& t : trivia)
+            writeTrivia(t);
+
+        if (LexerFacts::getTokenKindText(token.kind).empty())
+            writeString(token.rawText());
+
+        // Missing tokens always have default values.
+        if (token.isMissing())
+            return;
+
+        switch (token.kind) {
+            case TokenKind::StringLiteral:
+                writeString(token.valueText());
+                break;
+            case TokenKind::Directive:
+            case TokenKind::MacroUsage:
+                writeVarInt(uint64_t(token.directiveKind()));
+                break;
+            case TokenKind::UnbasedUnsizedLiteral:
+                out.push_back(char(token.bitValue().value));
+                break;
+            case TokenKind::IntegerLiteral: {
+                SVInt value = token.intValue();
+                writeVarInt(value.getBitWidth());
+                out.push_back(char((value.isSigned() ? IntegerFlags::Signed : 0) |
+                                   (value.hasUnknown() ? IntegerFlags::Unknown : 0)));
+
+                auto data = reinterpret_cast<const char*>(value.getRawPtr());
+                out.insert(out.end(), data, data + value.getNumWords() * sizeof(uint64_t));
+                break;
+            }
+            case TokenKind::RealLiteral:
+            case TokenKind::TimeLiteral:
+                writeRaw(token.realValue());
+                out.push_back(char(token.numericFlags().raw));
+                break;
+            case TokenKind::IntegerBase:
+                out.push_back(char(token.numericFlags().raw));
+                break;
+            default:
+                break;
+        }
+    }
+
+    void writeTrivia(const Trivia& trivia) {
+        out.push_back(char(trivia.kind));
+        switch (trivia.kind) {
+            case TriviaKind::Directive:
+            case TriviaKind::SkippedSyntax:
+                writeNode(trivia.syntax());
+                break;
+            case TriviaKind::SkippedTokens: {
+                auto tokens = trivia.getSkippedTokens();
+                writeVarInt(tokens.size());
+                for (auto token : tokens)
+                    writeToken(token);
+                break;
+            }
+            default: {
+                writeString(trivia.getRawText());
+
+                auto loc = trivia.getExplicitLocation();
+                out.push_back(char(loc.has_value()));
+                if (loc)
+                    writeLocation(*loc);
+                break;
+            }
+        }
+    }
+
+    void writeMetadata(const Parser::Metadata& metadata) {
+        // Metadata can refer to nodes that the parser created but didn't
+        // end up putting in the tree; those are simply dropped.
+        SmallVectorSized<std::pair<uint32_t, const Parser::Metadata::Node*>, 8> entries;
+        for (auto& [node, meta] : metadata.nodeMap) {
+            if (auto it = nodeIds.find(node); it != nodeIds.end())
+                entries.emplace(it->second, &meta);
+        }
+
+        writeVarInt(entries.size());
+        for (auto [id, meta] : entries) {
+            writeVarInt(id);
+            writeVarInt(uint64_t(meta->defaultNetType));
+            writeVarInt(uint64_t(meta->unconnectedDrive));
+            out.push_back(char(meta->timeScale.has_value()));
+            if (meta->timeScale) {
+                out.push_back(char(meta->timeScale->base.unit));
+                out.push_back(char(meta->timeScale->base.magnitude));
+                out.push_back(char(meta->timeScale->precision.unit));
+                out.push_back(char(meta->timeScale->precision.magnitude));
+            }
+        }
+
+        writeVarInt(metadata.globalInstances.size());
+        for (auto name : metadata.globalInstances)
+            writeString(name);
+
+        writeNodeRefs(metadata.classPackageNames);
+        writeNodeRefs(metadata.packageImports);
+        writeNodeRefs(metadata.defparams);
+        writeNodeRefs(metadata.classDecls);
+        writeNodeRefs(metadata.bindDirectives);
+    }
+
+    template<typename T>
+    void writeNodeRefs(const T& nodes) {
+        SmallVectorSized<uint32_t, 8> ids;
+        for (auto node : nodes) {
+            if (auto it = nodeIds.find(node); it != nodeIds.end())
+                ids.append(it->second);
+        }
+
+        writeVarInt(ids.size());
+        for (auto id : ids)
+            writeVarInt(id);
+    }
+
+    void writeBuffers() {
+        // Pull in all of the buffers that the referenced buffers depend on.
+        // The list grows as we go, so this can't use iterators.
+        for (size_t i = 0; i < buffers.size(); i++) {
+            BufferID buffer = buffers[i];
+            SourceLocation loc(buffer, 0);
+            if (sourceManager.isMacroLoc(loc)) {
+                addDependency(sourceManager.getOriginalLoc(loc));
+
+                auto range = sourceManager.getExpansionRange(loc);
+                addDependency(range.start());
+                addDependency(range.end());
+            }
+            else {
+                addDependency(sourceManager.getIncludedFrom(buffer));
+            }
+        }
+
+        // Write them in the order they were created, which guarantees that each
+        // buffer comes after all of the buffers it depends on.
+        SmallVectorSized<std::pair<BufferID, uint32_t>, 16> sorted;
+        for (size_t i = 0; i < buffers.size(); i++)
+            sorted.emplace(buffers[i], uint32_t(i));
+        std::sort(sorted.begin(), sorted.end());
+
+        writeVarInt(sorted.size());
+        for (auto [buffer, index] : sorted) {
+            writeVarInt(index);
+            writeBuffer(buffer);
+        }
+    }
+
+    void writeBuffer(BufferID buffer) {
+        SourceLocation loc(buffer, 0);
+        if (sourceManager.isMacroLoc(loc)) {
+            bool isMacroArg = sourceManager.isMacroArgLoc(loc);
+            auto range = sourceManager.getExpansionRange(loc);
+
+            out.push_back(char(BufferKind::Expansion));
+            writeLocation(sourceManager.getOriginalLoc(loc));
+            writeLocation(range.start());
+            writeLocation(range.end());
+            out.push_back(char(isMacroArg));
+            writeString(isMacroArg ? ""sv : sourceManager.getMacroName(loc));
+            return;
+        }
+
+        for (size_t i = 0; i < sources.size(); i++) {
+            if (sources[i].id == buffer) {
+                out.push_back(char(BufferKind::Source));
+                writeVarInt(i);
+                return;
+            }
+        }
+
+        string_view text = sourceManager.getSourceText(buffer);
+        if (auto includedFrom = sourceManager.getIncludedFrom(buffer)) {
+            // Includes are reloaded by searching for the file in the same way
+            // the preprocessor did, so we need the name as it was written. We
+            // also need the includer to be a real file for that to work.
+            auto it = includes.find(includedFrom);
+            if (it == includes.end() || !sourceManager.isFileLoc(includedFrom)) {
+                cacheable = false;
+                return;
+            }
+
+            string_view name = it->second->fileName.valueText();
+            if (name.length() < 3) {
+                cacheable = false;
+                return;
+            }
+
+            out.push_back(char(BufferKind::Include));
+            writeLocation(includedFrom);
+            writeString(name.substr(1, name.length() - 2));
+            out.push_back(char(name[0] == '<'));
+            writeRaw(uint64_t(xxhash(text.data(), text.size())));
+            return;
+        }
+
+        // Otherwise this is text the preprocessor created itself,
+        // such as for predefined macros.
+        out.push_back(char(BufferKind::Text));
+        writeString(sourceManager.getFileName(loc));
+        writeString(text);
+    }
+
+    void writeLocation(SourceLocation loc) {
+        uint32_t id = loc.buffer().getId();
+        if (id == 0)
+            writeVarInt(0);
+        else if (id == NoLocationBufferId)
+            writeVarInt(1);
+        else
+            writeVarInt(getBufferIndex(loc.buffer()) + FirstBufferIndex);
+
+        writeVarInt(loc.offset());
+    }
+
+    void addDependency(SourceLocation loc) {
+        uint32_t id = loc.buffer().getId();
+        if (id != 0 && id != NoLocationBufferId)
+            getBufferIndex(loc.buffer());
+    }
+
+    uint32_t getBufferIndex(BufferID buffer) {
+        auto [it, inserted] = bufferIndices.emplace(buffer, uint32_t(buffers.size()));
+        if (inserted)
+            buffers.push_back(buffer);
+        return it->second;
+    }
+
+    void writeString(string_view str) {
+        writeVarInt(str.size());
+        out.insert(out.end(), str.begin(), str.end());
+    }
+
+    void writeVarInt(uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(char((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(char(value));
+    }
+
+    template<typename T>
+    void writeRaw(T value) {
+        auto bytes = reinterpret_cast<const char*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    struct GetChildVisitor {
+        template<typename T>
+        ConstTokenOrSyntax visit(const T& node, size_t index) {
+            return node.getChild(index);
+        }
+
+        ConstTokenOrSyntax visitInvalid(const SyntaxNode&, size_t) { return nullptr; }
+    };
+
+    const SourceManager& sourceManager;
+    span<const SourceBuffer> sources;
+    std::vector<char> out;
+    bool cacheable = true;
+
+    uint32_t nextNodeId = 0;
+    flat_hash_map<const SyntaxNode*, uint32_t> nodeIds;
+
+    std::vector<BufferID> buffers;
+    flat_hash_map<BufferID, uint32_t> bufferIndices;
+    flat_hash_map<SourceLocation, const IncludeDirectiveSyntax*> includes;
+};
+
+class CacheReader : public SyntaxNodeReader {
+public:
+    CacheReader(SourceManager& sourceManager, BumpAllocator& alloc, span<const char> data,
+                span<const SourceBuffer> sources) :
+        sourceManager(sourceManager),
+        alloc(alloc), factory(alloc), data(data), sources(sources) {}
+
+    // Reads the buffer table and recreates each buffer in the source manager.
+    // Returns false if any included files have changed since the tree was cached.
+    bool readBuffers() {
+        check(size_t(data.size()) >= sizeof(Magic) + sizeof(Version));
+        check(memcmp(data.data(), Magic, sizeof(Magic)) == 0);
+        pos = sizeof(Magic);
+        check(readRaw<uint32_t>() == Version);
+
+        struct Entry {
+            uint32_t index;
+            BufferKind kind;
+            size_t offset;
+        };
+
+        size_t count = readVarInt();
+        check(count <= data.size());
+        buffers.resize(count);
+
+        // Included files are checked first, since a changed file is the most
+        // likely reason for the entry to be stale and we don't want to have
+        // created anything else in the source manager if that happens.
+        SmallVectorSized<Entry, 16> deferred;
+        for (size_t i = 0; i < count; i++) {
+            uint32_t index = readBufferIndex();
+            auto kind = BufferKind(readRaw<uint8_t>());
+            switch (kind) {
+                case BufferKind::Source: {
+                    size_t source = readVarInt();
+                    check(source < sources.size());
+                    buffers[index] = sources[source].id;
+                    break;
+                }
+                case BufferKind::Include: {
+                    SourceLocation includedFrom = readLocation();
+                    std::string name(readString());
+                    bool isSystem = readRaw<uint8_t>() != 0;
+                    auto hash = readRaw<uint64_t>();
+
+                    auto buffer = sourceManager.readHeader(name, includedFrom, isSystem);
+                    if (!buffer || xxhash(buffer.data.data(), buffer.data.size()) != hash)
+                        return false;
+
+                    buffers[index] = buffer.id;
+                    break;
+                }
+                case BufferKind::Text:
+                    deferred.append({ index, kind, pos });
+                    readString();
+                    readString();
+                    break;
+                case BufferKind::Expansion:
+                    deferred.append({ index, kind, pos });
+                    readLocation(/* resolve */ false);
+                    readLocation(false);
+                    readLocation(false);
+                    readRaw<uint8_t>();
+                    readString();
+                    break;
+                default:
+                    check(false);
+            }
+        }
+
+        size_t end = pos;
+        for (auto& entry : deferred) {
+            pos = entry.offset;
+            if (entry.kind == BufferKind::Text) {
+                string_view name = readString();
+                string_view text = readString();
+
+                auto buffer = sourceManager.assignText(text);
+                if (!name.empty())
+                    sourceManager.addLineDirective(SourceLocation(buffer.id, 0), 2, name, 0);
+                buffers[entry.index] = buffer.id;
+            }
+            else {
+                SourceLocation originalLoc = readLocation();
+                SourceLocation start = readLocation();
+                SourceLocation end = readLocation();
+                bool isMacroArg = readRaw<uint8_t>() != 0;
+                string_view macroName = readString();
+
+                SourceRange range(start, end);
+                SourceLocation loc =
+                    isMacroArg ? sourceManager.createExpansionLoc(originalLoc, range, true)
+                               : sourceManager.createExpansionLoc(originalLoc, range, macroName);
+                buffers[entry.index] = loc.buffer();
+            }
+        }
+
+        pos = end;
+        return true;
+    }
+
+    SyntaxNode& readRoot() { return *readNode(&SyntaxNode::isKind, false); }
+
+    Token readToken() final {
+        size_t tag = readVarInt();
+        if (!tag)
+            return Token();
+
+        auto kind = TokenKind(tag - 1);
+        auto flags = readRaw<uint8_t>();
+        SourceLocation location = readLocation();
+
+        size_t triviaCount = readVarInt();
+        check(triviaCount <= data.size());
+        SmallVectorSized<Trivia, 8> trivia(triviaCount);
+        for (size_t i = 0; i < triviaCount; i++)
+            trivia.append(readTrivia());
+        auto triviaSpan = trivia.copy(alloc);
+
+        string_view rawText = LexerFacts::getTokenKindText(kind);
+        if (rawText.empty())
+            rawText = readString();
+
+        if (flags & TokenFlags::Missing) {
+            return Token::createMissing(alloc, kind, location)
+                .clone(alloc, triviaSpan, rawText, location);
+        }
+
+        switch (kind) {
+            case TokenKind::StringLiteral:
+                return Token(alloc, kind, triviaSpan, rawText, location, readString());
+            case TokenKind::IncludeFileName:
+                return Token(alloc, kind, triviaSpan, rawText, location, rawText);
+            case TokenKind::Directive:
+            case TokenKind::MacroUsage:
+                return Token(alloc, kind, triviaSpan, rawText, location,
+                             SyntaxKind(readVarInt()));
+            case TokenKind::UnbasedUnsizedLiteral:
+                return Token(alloc, kind, triviaSpan, rawText, location,
+                             logic_t(readRaw<uint8_t>()));
+            case TokenKind::IntegerLiteral: {
+                auto bits = bitwidth_t(readVarInt());
+                auto intFlags = readRaw<uint8_t>();
+                check(bits > 0 && bits <= SVInt::MAX_BITS);
+
+                bool isSigned = (intFlags & IntegerFlags::Signed) != 0;
+                bool hasUnknown = (intFlags & IntegerFlags::Unknown) != 0;
+                uint32_t numWords = (bits + SVInt::BITS_PER_WORD - 1) / SVInt::BITS_PER_WORD;
+                if (hasUnknown)
+                    numWords *= 2;
+
+                SmallVectorSized<uint64_t, 2> words;
+                for (uint32_t i = 0; i < numWords; i++)
+                    words.append(readRaw<uint64_t>());
+
+                SVIntStorage storage(bits, isSigned, hasUnknown);
+                if (numWords == 1)
+                    storage.val = words[0];
+                else
+                    storage.pVal = words.data();
+
+                return Token(alloc, kind, triviaSpan, rawText, location, SVInt(storage));
+            }
+            case TokenKind::RealLiteral:
+            case TokenKind::TimeLiteral: {
+                auto value = readRaw<double>();
+                NumericTokenFlags numFlags{ readRaw<uint8_t>() };
+
+                optional<TimeUnit> unit;
+                if (kind == TokenKind::TimeLiteral)
+                    unit = numFlags.unit();
+
+                return Token(alloc, kind, triviaSpan, rawText, location, value,
+                             numFlags.outOfRange(), unit);
+            }
+            case TokenKind::IntegerBase: {
+                NumericTokenFlags numFlags{ readRaw<uint8_t>() };
+                return Token(alloc, kind, triviaSpan, rawText, location, numFlags.base(),
+                             numFlags.isSigned());
+            }
+            default:
+                return Token(alloc, kind, triviaSpan, rawText, location);
+        }
+    }
+
+    void readMetadata(Parser::Metadata& metadata) {
+        size_t count = readVarInt();
+        for (size_t i = 0; i < count; i++) {
+            const SyntaxNode* node = getNode(readVarInt());
+
+            Parser::Metadata::Node meta;
+            meta.defaultNetType = TokenKind(readVarInt());
+            meta.unconnectedDrive = TokenKind(readVarInt());
+            if (readRaw<uint8_t>()) {
+                TimeScale ts;
+                ts.base.unit = TimeUnit(readRaw<uint8_t>());
+                ts.base.magnitude = TimeScaleMagnitude(readRaw<uint8_t>());
+                ts.precision.unit = TimeUnit(readRaw<uint8_t>());
+                ts.precision.magnitude = TimeScaleMagnitude(readRaw<uint8_t>());
+                meta.timeScale = ts;
+            }
+            metadata.nodeMap.emplace(node, meta);
+        }
+
+        count = readVarInt();
+        for (size_t i = 0; i < count; i++)
+            metadata.globalInstances.emplace(readString());
+
+        readNodeRefs(metadata.classPackageNames);
+        readNodeRefs(metadata.packageImports);
+        readNodeRefs(metadata.defparams);
+        readNodeRefs(metadata.classDecls);
+        readNodeRefs(metadata.bindDirectives);
+        check(pos == data.size());
+    }
+
+protected:
+    SyntaxNode* readNode(bool (*isKind)(SyntaxKind), bool optional) final {
+        size_t tag = readVarInt();
+        if (!tag) {
+            check(optional);
+            return nullptr;
+        }
+
+        auto kind = SyntaxKind(tag - 1);
+        check(isKind(kind));
+
+        // Guard against malformed input blowing the stack.
+        check(++depth < MaxDepth);
+
+        size_t id = nodes.size();
+        nodes.push_back(nullptr);
+
+        SyntaxNode* node = factory.deserialize(kind, *this);
+        check(node != nullptr);
+
+        nodes[id] = node;
+        depth--;
+        return node;
+    }
+
+    size_t readListSize(SyntaxKind listKind) final {
+        check(readVarInt() == size_t(listKind) + 1);
+        nodes.push_back(nullptr);
+
+        size_t count = readVarInt();
+        check(count <= data.size());
+        return count;
+    }
+
+private:
+    Trivia readTrivia() {
+        auto kind = TriviaKind(readRaw<uint8_t>());
+        switch (kind) {
+            case TriviaKind::Directive:
+            case TriviaKind::SkippedSyntax:
+                return Trivia(kind, readNode(&SyntaxNode::isKind, false));
+            case TriviaKind::SkippedTokens: {
+                size_t count = readVarInt();
+                check(count > 0 && count <= data.size());
+                SmallVectorSized<Token, 8> tokens(count);
+                for (size_t i = 0; i < count; i++)
+                    tokens.append(readToken());
+                return Trivia(kind, tokens.copy(alloc));
+            }
+            default: {
+                Trivia trivia(kind, readString());
+                if (readRaw<uint8_t>())
+                    trivia = trivia.withLocation(alloc, readLocation());
+                return trivia;
+            }
+        }
+    }
+
+    template<typename T>
+    void readNodeRefs(T& list) {
+        using NodeType = std::remove_const_t<std::remove_pointer_t<typename T::value_type>>;
+
+        size_t count = readVarInt();
+        for (size_t i = 0; i < count; i++) {
+            auto node = getNode(readVarInt());
+            check(NodeType::isKind(node->kind));
+            list.append(&node->template as<NodeType>());
+        }
+    }
+
+    const SyntaxNode* getNode(size_t id) {
+        check(id < nodes.size() && nodes[id]);
+        return nodes[id];
+    }
+
+    SourceLocation readLocation(bool resolve = true) {
+        uint32_t index = readBufferIndex(FirstBufferIndex);
+        size_t offset = readVarInt();
+        if (!resolve)
+            return SourceLocation();
+
+        if (index == 0)
+            return SourceLocation(BufferID(), offset);
+        if (index == 1)
+            return SourceLocation(BufferID(NoLocationBufferId, ""sv), offset);
+
+        BufferID buffer = buffers[index - FirstBufferIndex];
+        check(buffer.valid());
+        return SourceLocation(buffer, offset);
+    }
+
+    uint32_t readBufferIndex(uint32_t bias = 0) {
+        size_t index = readVarInt();
+        check(index < buffers.size() + bias);
+        return uint32_t(index);
+    }
+
+    string_view readString() {
+        size_t len = readVarInt();
+        check(len <= data.size() - pos);
+
+        string_view result(data.data() + pos, len);
+        pos += len;
+        return result;
+    }
+
+    size_t readVarInt() {
+        uint64_t result = 0;
+        for (uint32_t shift = 0; shift < 64; shift += 7) {
+            auto byte = readRaw<uint8_t>();
+            result |= uint64_t(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+                return size_t(result);
+        }
+
+        check(false);
+        return 0;
+    }
+
+    template<typename T>
+    T readRaw() {
+        check(sizeof(T) <= data.size() - pos);
+
+        T result;
+        memcpy(&result, data.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return result;
+    }
+
+    void check(bool condition) const {
+        if (!condition)
+            throw std::runtime_error("Malformed syntax tree cache entry");
+    }
+
+    static constexpr uint32_t MaxDepth = 16384;
+
+    SourceManager& sourceManager;
+    BumpAllocator& alloc;
+    SyntaxFactory factory;
+    span<const char> data;
+    span<const SourceBuffer> sources;
+    size_t pos = 0;
+    uint32_t depth = 0;
+
+    std::vector<BufferID> buffers;
+    std::vector<SyntaxNode*> nodes;
+};
+
+} // namespace
+
+namespace slang {
+
+SyntaxTreeCache::SyntaxTreeCache(std::string directory) : directory(std::move(directory)) {
+    // If this fails we'll just end up missing in the cache every time.
+    std::error_code ec;
+    fs::create_directories(this->directory, ec);
+}
+
+std::shared_ptr<SyntaxTree> SyntaxTreeCache::load(SourceManager& sourceManager,
+                                                  span<const SourceBuffer> sources,
+                                                  const Bag& options) {
+    std::string path = getPath(sources, options);
+
+    std::error_code ec;
+    auto size = fs::file_size(path, ec);
+    if (ec) {
+        numMisses++;
+        return nullptr;
+    }
+
+    // The file contents are loaded directly into the tree's allocator,
+    // since strings in the tree will point into it.
+    BumpAllocator alloc;
+    char* data = reinterpret_cast<char*>(alloc.allocate(size, 1));
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.read(data, std::streamsize(size))) {
+        numMisses++;
+        return nullptr;
+    }
+
+    try {
+        CacheReader reader(sourceManager, alloc, span<const char>(data, size), sources);
+        if (!reader.readBuffers()) {
+            numMisses++;
+            return nullptr;
+        }
+
+        SyntaxNode& root = reader.readRoot();
+        Token eof = reader.readToken();
+
+        Parser::Metadata metadata;
+        reader.readMetadata(metadata);
+
+        numHits++;
+        return std::shared_ptr<SyntaxTree>(new SyntaxTree(&root, sourceManager, std::move(alloc),
+                                                          Diagnostics(), std::move(metadata),
+                                                          options, eof));
+    }
+    catch (const std::runtime_error&) {
+        // A corrupted entry is no different from a missing one; it will
+        // be overwritten once the tree has been parsed again.
+        numMisses++;
+        return nullptr;
+    }
+}
+
+void SyntaxTreeCache::store(const SyntaxTree& tree, span<const SourceBuffer> sources) {
+    if (!tree.diagnostics().empty())
+        return;
+
+    std::vector<char> data;
+    CacheWriter writer(tree.sourceManager(), sources);
+    if (!writer.write(tree, data))
+        return;
+
+    // Write to a temporary file and then rename it into place, so that other
+    // processes sharing the cache directory never observe a partially written tree.
+    std::string path = getPath(sources, tree.options());
+    std::string tmpPath = fmt::format("{}.{:08x}.tmp", path, std::random_device()());
+
+    bool ok;
+    {
+        std::ofstream file(tmpPath, std::ios::binary);
+        file.write(data.data(), std::streamsize(data.size()));
+        file.close();
+        ok = !file.fail();
+    }
+
+    std::error_code ec;
+    if (ok)
+        fs::rename(tmpPath, path, ec);
+    if (!ok || ec)
+        fs::remove(tmpPath, ec);
+}
+
+std::string SyntaxTreeCache::getPath(span<const SourceBuffer> sources, const Bag& options) const {
+    size_t key = Version;
+    for (auto& source : sources)
+        hash_combine(key, xxhash(source.data.data(), source.data.size()));
+
+    // Any option that affects how the source is turned into a tree needs to be part
+    // of the key. The predefined macros are the only preprocessor state that carries
+    // into a new tree; everything else starts from scratch for each one.
+    auto lo = options.getOrDefault<LexerOptions>();
+    auto po = options.getOrDefault<ParserOptions>();
+    auto ppo = options.getOrDefault<PreprocessorOptions>();
+    auto hashString = [&](const std::string& str) {
+        hash_combine(key, xxhash(str.data(), str.size()));
+    };
+
+    hash_combine(key, lo.maxErrors, po.maxRecursionDepth, ppo.maxIncludeDepth);
+    hashString(ppo.predefineSource);
+
+    hash_combine(key, ppo.predefines.size());
+    for (auto& define : ppo.predefines)
+        hashString(define);
+
+    hash_combine(key, ppo.undefines.size());
+    for (auto& undef : ppo.undefines)
+        hashString(undef);
+
+    return fmt::format("{}/{:016x}.syntax", directory, key);
+}
+
+} // namespace slang
@@ -0,0 +1,236 @@
+//------------------------------------------------------------------------------
+// BinaryAST.cpp
+// Binary AST export format and reader
+//
+// File is under the MIT license; see LICENSE for details
+//------------------------------------------------------------------------------
+#include "slang/text/BinaryAST.h"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace slang {
+
+using namespace BinaryAST;
+
+BinaryASTReader::BinaryASTReader(span<const char> data) : data(data) {
+    check(size_t(data.size()) >= sizeof(Header));
+    memcpy(&header, data.data(), sizeof(Header));
+    header = littleEndian(header);
+
+    if (memcmp(header.magic, Magic, sizeof(Magic)) != 0)
+        throw std::runtime_error("Not a binary AST file");
+
+    if (header.version != Version)
+        throw std::runtime_error("Unsupported binary AST file version");
+
+    numStrings = read<uint32_t>(header.stringTableOffset);
+    numSymbols = read<uint32_t>(header.symbolTableOffset);
+    numScopes = read<uint32_t>(header.scopeIndexOffset);
+
+    // Make sure the fixed size parts of each table are in bounds so that
+    // lookups only need to validate what they point at.
+    check(header.stringTableOffset + 4 + (uint64_t(numStrings) + 1) * 8 <= data.size());
+    check(header.symbolTableOffset + 4 + uint64_t(numSymbols) * 8 <= data.size());
+    check(header.scopeIndexOffset + 4 + uint64_t(numScopes) * 8 <= data.size());
+}
+
+BinaryASTValue BinaryASTReader::getRoot(uint32_t index) const {
+    check(index < header.numRoots);
+
+    BinaryASTValue value(*this, header.bodyOffset);
+    for (uint32_t i = 0; i < index; i++)
+        value.offset = value.getEnd();
+    return value;
+}
+
+string_view BinaryASTReader::getString(uint32_t id) const {
+    check(id < numStrings);
+
+    size_t offsets = header.stringTableOffset + 4;
+    size_t blob = offsets + (size_t(numStrings) + 1) * 8;
+    auto begin = read<uint64_t>(offsets + size_t(id) * 8);
+    auto end = read<uint64_t>(offsets + size_t(id + 1) * 8);
+    check(begin <= end && blob + end <= data.size());
+
+    return string_view(data.data() + blob + begin, end - begin);
+}
+
+optional<BinaryASTValue> BinaryASTReader::findSymbol(uint32_t id) const {
+    check(id < numSymbols);
+
+    auto offset = read<uint64_t>(header.symbolTableOffset + 4 + size_t(id) * 8);
+    if (!offset)
+        return std::nullopt;
+
+    BinaryASTValue value(*this, offset);
+    check(value.getTag() == Tag::Symbol);
+    return value;
+}
+
+string_view BinaryASTReader::getScopePath(uint32_t index) const {
+    check(index < numScopes);
+    return getString(read<uint32_t>(header.scopeIndexOffset + 4 + size_t(index) * 8));
+}
+
+optional<BinaryASTValue> BinaryASTReader::findScope(string_view path) const {
+    // The index is sorted by path, so we can binary search it.
+    uint32_t low = 0;
+    uint32_t high = numScopes;
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        int cmp = getScopePath(mid).compare(path);
+        if (cmp == 0) {
+            auto id = read<uint32_t>(header.scopeIndexOffset + 4 + size_t(mid) * 8 + 4);
+            return findSymbol(id);
+        }
+
+        if (cmp < 0)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return std::nullopt;
+}
+
+template<typename T>
+T BinaryASTReader::read(size_t offset) const {
+    check(offset + sizeof(T) <= data.size() && offset + sizeof(T) > offset);
+
+    T result;
+    memcpy(&result, data.data() + offset, sizeof(T));
+    return littleEndian(result);
+}
+
+void BinaryASTReader::check(bool condition) const {
+    if (!condition)
+        throw std::runtime_error("Malformed binary AST file");
+}
+
+Tag BinaryASTValue::getTag() const {
+    return Tag(reader->read<uint8_t>(offset));
+}
+
+bool BinaryASTValue::isObject() const {
+    auto tag = getTag();
+    return tag == Tag::Object || tag == Tag::Symbol;
+}
+
+string_view BinaryASTValue::getString() const {
+    expect(Tag::String);
+    return reader->getString(reader->read<uint32_t>(getPayload()));
+}
+
+int64_t BinaryASTValue::getInt() const {
+    expect(Tag::Int);
+    return reader->read<int64_t>(getPayload());
+}
+
+uint64_t BinaryASTValue::getUInt() const {
+    expect(Tag::UInt);
+    return reader->read<uint64_t>(getPayload());
+}
+
+double BinaryASTValue::getDouble() const {
+    expect(Tag::Double);
+    return reader->read<double>(getPayload());
+}
+
+bool BinaryASTValue::getBool() const {
+    auto tag = getTag();
+    reader->check(tag == Tag::True || tag == Tag::False);
+    return tag == Tag::True;
+}
+
+uint32_t BinaryASTValue::getSymbolId() const {
+    auto tag = getTag();
+    if (tag == Tag::Symbol)
+        return reader->read<uint32_t>(getPayload() + 8);
+
+    expect(Tag::Link);
+    return reader->read<uint32_t>(getPayload());
+}
+
+string_view BinaryASTValue::getLinkText() const {
+    expect(Tag::Link);
+    return reader->getString(reader->read<uint32_t>(getPayload() + 4));
+}
+
+optional<BinaryASTValue> BinaryASTValue::find(string_view name) const {
+    size_t end = getEnd();
+    size_t cur = getFirstProperty();
+    while (cur < end) {
+        BinaryASTValue value(*reader, cur + 4);
+        if (reader->getString(reader->read<uint32_t>(cur)) == name)
+            return value;
+        cur = value.getEnd();
+    }
+    return std::nullopt;
+}
+
+void BinaryASTValue::forEachProperty(
+    function_ref<void(string_view, BinaryASTValue)> callback) const {
+    size_t end = getEnd();
+    size_t cur = getFirstProperty();
+    while (cur < end) {
+        BinaryASTValue value(*reader, cur + 4);
+        callback(reader->getString(reader->read<uint32_t>(cur)), value);
+        cur = value.getEnd();
+    }
+}
+
+uint32_t BinaryASTValue::size() const {
+    expect(Tag::Array);
+    return reader->read<uint32_t>(getPayload() + 8);
+}
+
+void BinaryASTValue::forEachElement(function_ref<void(BinaryASTValue)> callback) const {
+    uint32_t count = size();
+    BinaryASTValue value(*reader, getPayload() + 12);
+    for (uint32_t i = 0; i < count; i++) {
+        callback(value);
+        value.offset = value.getEnd();
+    }
+}
+
+size_t BinaryASTValue::getEnd() const {
+    size_t payload = getPayload();
+    switch (getTag()) {
+        case Tag::Object:
+        case Tag::Symbol:
+        case Tag::Array: {
+            auto size = reader->read<uint64_t>(payload);
+            reader->check(size <= reader->data.size() - payload - 8);
+            return payload + 8 + size;
+        }
+        case Tag::String:
+            return payload + 4;
+        case Tag::Int:
+        case Tag::UInt:
+        case Tag::Double:
+        case Tag::Link:
+            return payload + 8;
+        case Tag::True:
+        case Tag::False:
+            return payload;
+    }
+
+    reader->check(false);
+    return payload;
+}
+
+size_t BinaryASTValue::getFirstProperty() const {
+    auto tag = getTag();
+    if (tag == Tag::Symbol)
+        return getPayload() + 12;
+
+    expect(Tag::Object);
+    return getPayload() + 8;
+}
+
+void BinaryASTValue::expect(Tag tag) const {
+    reader->check(getTag() == tag);
+}
+
+} // namespace slang
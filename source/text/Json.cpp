@@ -5,6 +5,9 @@
 // File is under the MIT license; see LICENSE for details
 //------------------------------------------------------------------------------
 #include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
 
 #include "slang/text/Json.h"
 
@@ -20,83 +23,112 @@ JsonWriter::JsonWriter() : buffer(std::make_unique<FormatBuffer>()) {
 
 JsonWriter::~JsonWriter() = default;
 
+void JsonWriter::flush() {
+    if (output && !buffer->empty()) {
+        output(string_view(buffer->data(), buffer->size()));
+        buffer->clear();
+    }
+}
+
 string_view JsonWriter::view() const {
-    return string_view(buffer->data(), findLastComma());
+    return string_view(buffer->data(), buffer->size());
 }
 
 void JsonWriter::startObject() {
+    startValue();
     buffer->append("{");
-    if (pretty) {
-        currentIndent += indentSize;
-        buffer->format("\n{:{}}", "", currentIndent);
-    }
+    currentIndent += indentSize;
+    depth++;
+    needComma = false;
 }
 
 void JsonWriter::endObject() {
-    buffer->resize(findLastComma());
-    if (pretty) {
-        currentIndent -= indentSize;
-        buffer->format("\n{:{}}}}", "", currentIndent);
-        endValue();
-    }
-    else {
-        buffer->append("},");
-    }
+    currentIndent -= indentSize;
+    depth--;
+    writeNewline();
+    buffer->append("}");
+    endValue();
 }
 
 void JsonWriter::startArray() {
+    startValue();
     buffer->append("[");
-    if (pretty) {
-        currentIndent += indentSize;
-        buffer->format("\n{:{}}", "", currentIndent);
-    }
+    currentIndent += indentSize;
+    depth++;
+    needComma = false;
 }
 
 void JsonWriter::endArray() {
-    buffer->resize(findLastComma());
-    if (pretty) {
-        currentIndent -= indentSize;
-        buffer->format("\n{:{}}]", "", currentIndent);
-        endValue();
-    }
-    else {
-        buffer->append("],");
-    }
+    currentIndent -= indentSize;
+    depth--;
+    writeNewline();
+    buffer->append("]");
+    endValue();
 }
 
 void JsonWriter::writeProperty(string_view name) {
+    startValue();
     writeQuoted(name);
-    buffer->append(":");
-    if (pretty)
-        buffer->append(" ");
+    buffer->append(pretty ? ": " : ":");
+    afterProperty = true;
 }
 
 void JsonWriter::writeValue(string_view value) {
+    startValue();
     writeQuoted(value);
     endValue();
 }
 
 void JsonWriter::writeValue(int64_t value) {
-    buffer->format("{}", value);
+    startValue();
+    fmt::format_int str(value);
+    buffer->append(string_view(str.data(), str.size()));
     endValue();
 }
 
 void JsonWriter::writeValue(uint64_t value) {
-    buffer->format("{}", value);
+    startValue();
+    fmt::format_int str(value);
+    buffer->append(string_view(str.data(), str.size()));
     endValue();
 }
 
 void JsonWriter::writeValue(double value) {
+    startValue();
     buffer->format("{}", value);
     endValue();
 }
 
 void JsonWriter::writeValue(bool value) {
+    startValue();
     buffer->append(value ? "true" : "false");
     endValue();
 }
 
+void JsonWriter::writeNull() {
+    startValue();
+    buffer->append("null");
+    endValue();
+}
+
 void JsonWriter::writeQuoted(string_view str) {
+    // Most strings (names, kinds, etc) don't need any escaping,
+    // so check for that first and copy them directly.
+    bool needsEscape = false;
+    for (char c : str) {
+        if (c == '"' || c == '\\' || (unsigned char)c <= 0x1f) {
+            needsEscape = true;
+            break;
+        }
+    }
+
+    if (!needsEscape) {
+        buffer->append("\"");
+        buffer->append(str);
+        buffer->append("\"");
+        return;
+    }
+
     SmallVectorSized<char, 32> vec(str.size() + 2);
     vec.append('"');
     for (char c : str) {
@@ -154,23 +186,355 @@ void JsonWriter::writeQuoted(string_view str) {
     buffer->append(toStringView(vec));
 }
 
+void JsonWriter::startValue() {
+    // A value that follows a property name goes right after it.
+    if (afterProperty) {
+        afterProperty = false;
+        return;
+    }
+
+    // Values are only ever split at this point, so that the handed
+    // off text never has to be revisited.
+    if (output && buffer->size() >= outputChunkSize)
+        flush();
+
+    if (needComma)
+        buffer->append(",");
+
+    if (depth > 0 || needComma)
+        writeNewline();
+}
+
 void JsonWriter::endValue() {
-    buffer->append(",");
+    needComma = true;
+}
+
+void JsonWriter::writeNewline() {
     if (pretty)
         buffer->format("\n{:{}}", "", currentIndent);
 }
+} // namespace slang
+
+namespace {
 
-size_t JsonWriter::findLastComma() const {
-    size_t size = buffer->size();
-    if (pretty) {
-        while (size && (buffer->data()[size - 1] == ' ' || buffer->data()[size - 1] == '\n'))
-            size--;
+using namespace slang;
+
+class JsonParser {
+public:
+    explicit JsonParser(string_view text) : text(text) {}
+
+    JsonValue parseDocument() {
+        JsonValue result = parseValue(0);
+        skipWhitespace();
+        if (pos != text.size())
+            error("unexpected trailing characters");
+        return result;
+    }
+
+private:
+    // Guards against running out of stack on deeply nested input.
+    static constexpr int MaxDepth = 256;
+
+    string_view text;
+    size_t pos = 0;
+
+    [[noreturn]] void error(string_view msg) const {
+        throw std::runtime_error(fmt::format("Invalid JSON at offset {}: {}", pos, msg));
+    }
+
+    void skipWhitespace() {
+        while (pos < text.size() &&
+               (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r')) {
+            pos++;
+        }
+    }
+
+    char peek() const { return pos < text.size() ? text[pos] : '\0'; }
+
+    void expect(char c) {
+        if (peek() != c)
+            error(fmt::format("expected '{}'", c));
+        pos++;
+    }
+
+    void expectKeyword(string_view keyword) {
+        if (text.substr(pos, keyword.size()) != keyword)
+            error("invalid literal");
+        pos += keyword.size();
+    }
+
+    JsonValue parseValue(int depth) {
+        if (depth > MaxDepth)
+            error("nesting is too deep");
+
+        skipWhitespace();
+        switch (peek()) {
+            case '{':
+                return parseObject(depth);
+            case '[':
+                return parseArray(depth);
+            case '"':
+                return JsonValue(parseString());
+            case 't':
+                expectKeyword("true");
+                return JsonValue(true);
+            case 'f':
+                expectKeyword("false");
+                return JsonValue(false);
+            case 'n':
+                expectKeyword("null");
+                return JsonValue();
+            default:
+                return JsonValue(parseNumber());
+        }
     }
 
-    if (size && buffer->data()[size - 1] == ',')
-        size--;
+    JsonValue parseObject(int depth) {
+        expect('{');
+        JsonValue::Object object;
 
-    return size;
+        skipWhitespace();
+        if (peek() == '}') {
+            pos++;
+            return JsonValue(std::move(object));
+        }
+
+        while (true) {
+            skipWhitespace();
+            std::string name = parseString();
+            skipWhitespace();
+            expect(':');
+            object.emplace_back(std::move(name), parseValue(depth + 1));
+
+            skipWhitespace();
+            if (peek() == '}') {
+                pos++;
+                return JsonValue(std::move(object));
+            }
+            expect(',');
+        }
+    }
+
+    JsonValue parseArray(int depth) {
+        expect('[');
+        JsonValue::Array array;
+
+        skipWhitespace();
+        if (peek() == ']') {
+            pos++;
+            return JsonValue(std::move(array));
+        }
+
+        while (true) {
+            array.emplace_back(parseValue(depth + 1));
+
+            skipWhitespace();
+            if (peek() == ']') {
+                pos++;
+                return JsonValue(std::move(array));
+            }
+            expect(',');
+        }
+    }
+
+    uint32_t parseHex4() {
+        if (text.size() - pos < 4)
+            error("truncated unicode escape");
+
+        uint32_t result = 0;
+        for (int i = 0; i < 4; i++) {
+            char c = text[pos++];
+            result <<= 4;
+            if (c >= '0' && c <= '9')
+                result |= uint32_t(c - '0');
+            else if (c >= 'a' && c <= 'f')
+                result |= uint32_t(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F')
+                result |= uint32_t(c - 'A' + 10);
+            else
+                error("invalid unicode escape");
+        }
+        return result;
+    }
+
+    static void appendUtf8(std::string& str, uint32_t cp) {
+        if (cp < 0x80) {
+            str.push_back(char(cp));
+        }
+        else if (cp < 0x800) {
+            str.push_back(char(0xC0 | (cp >> 6)));
+            str.push_back(char(0x80 | (cp & 0x3F)));
+        }
+        else if (cp < 0x10000) {
+            str.push_back(char(0xE0 | (cp >> 12)));
+            str.push_back(char(0x80 | ((cp >> 6) & 0x3F)));
+            str.push_back(char(0x80 | (cp & 0x3F)));
+        }
+        else {
+            str.push_back(char(0xF0 | (cp >> 18)));
+            str.push_back(char(0x80 | ((cp >> 12) & 0x3F)));
+            str.push_back(char(0x80 | ((cp >> 6) & 0x3F)));
+            str.push_back(char(0x80 | (cp & 0x3F)));
+        }
+    }
+
+    std::string parseString() {
+        expect('"');
+
+        std::string result;
+        while (true) {
+            if (pos >= text.size())
+                error("unterminated string");
+
+            char c = text[pos++];
+            if (c == '"')
+                return result;
+
+            if ((unsigned char)c <= 0x1f)
+                error("control character in string");
+
+            if (c != '\\') {
+                result.push_back(c);
+                continue;
+            }
+
+            if (pos >= text.size())
+                error("unterminated string");
+
+            switch (text[pos++]) {
+                case '"':
+                    result.push_back('"');
+                    break;
+                case '\\':
+                    result.push_back('\\');
+                    break;
+                case '/':
+                    result.push_back('/');
+                    break;
+                case 'b':
+                    result.push_back('\b');
+                    break;
+                case 'f':
+                    result.push_back('\f');
+                    break;
+                case 'n':
+                    result.push_back('\n');
+                    break;
+                case 'r':
+                    result.push_back('\r');
+                    break;
+                case 't':
+                    result.push_back('\t');
+                    break;
+                case 'u': {
+                    uint32_t cp = parseHex4();
+                    if (cp >= 0xD800 && cp <= 0xDBFF && text.substr(pos, 2) == "\\u") {
+                        // Combine a surrogate pair into a single code point.
+                        size_t savedPos = pos;
+                        pos += 2;
+                        uint32_t low = parseHex4();
+                        if (low >= 0xDC00 && low <= 0xDFFF)
+                            cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                        else
+                            pos = savedPos;
+                    }
+                    appendUtf8(result, cp);
+                    break;
+                }
+                default:
+                    pos--;
+                    error("invalid escape sequence");
+            }
+        }
+    }
+
+    double parseNumber() {
+        size_t start = pos;
+        if (peek() == '-')
+            pos++;
+
+        auto digits = [&] {
+            size_t first = pos;
+            while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9')
+                pos++;
+            return pos != first;
+        };
+
+        if (!digits())
+            error("expected a value");
+
+        if (peek() == '.') {
+            pos++;
+            if (!digits())
+                error("invalid number");
+        }
+
+        if (peek() == 'e' || peek() == 'E') {
+            pos++;
+            if (peek() == '+' || peek() == '-')
+                pos++;
+            if (!digits())
+                error("invalid number");
+        }
+
+        std::string str(text.substr(start, pos - start));
+        return strtod(str.c_str(), nullptr);
+    }
+};
+
+} // namespace
+
+namespace slang {
+
+JsonValue JsonValue::parse(string_view text) {
+    return JsonParser(text).parseDocument();
+}
+
+const JsonValue* JsonValue::find(string_view name) const {
+    if (!isObject())
+        return nullptr;
+
+    for (auto& [key, val] : getObject()) {
+        if (key == name)
+            return &val;
+    }
+    return nullptr;
+}
+
+void JsonValue::write(JsonWriter& writer) const {
+    switch (kind()) {
+        case Kind::Null:
+            writer.writeNull();
+            break;
+        case Kind::Boolean:
+            writer.writeValue(getBoolean());
+            break;
+        case Kind::Number: {
+            double d = getNumber();
+            if (std::trunc(d) == d && std::abs(d) < 9007199254740992.0)
+                writer.writeValue(int64_t(d));
+            else
+                writer.writeValue(d);
+            break;
+        }
+        case Kind::String:
+            writer.writeValue(string_view(getString()));
+            break;
+        case Kind::Array:
+            writer.startArray();
+            for (auto& elem : getArray())
+                elem.write(writer);
+            writer.endArray();
+            break;
+        case Kind::Object:
+            writer.startObject();
+            for (auto& [key, val] : getObject()) {
+                writer.writeProperty(key);
+                val.write(writer);
+            }
+            writer.endObject();
+            break;
+    }
 }
 
-} // namespace slang
\ No newline at end of file
+} // namespace slang
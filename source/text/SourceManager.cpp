@@ -6,7 +6,9 @@
 //------------------------------------------------------------------------------
 #include "slang/text/SourceManager.h"
 
+#include <algorithm>
 #include <string>
+#include <unordered_set>
 
 #include "slang/util/OS.h"
 #include "slang/util/StackContainer.h"
@@ -101,6 +103,16 @@ string_view SourceManager::getRawFileName(BufferID buffer) const {
         return info->data->name;
 }
 
+fs::path SourceManager::getFullPath(BufferID buffer) const {
+    auto info = getFileInfo(buffer);
+
+    // LOCKING: not required, immutable after creation
+    if (!info || !info->data || !info->data->directory)
+        return {};
+
+    return *info->data->directory / fs::path(widen(info->data->name)).filename();
+}
+
 SourceLocation SourceManager::getIncludedFrom(BufferID buffer) const {
     auto info = getFileInfo(buffer);
     if (!info)
@@ -265,7 +277,8 @@ string_view SourceManager::getSourceText(BufferID buffer) const {
     if (!info || !info->data)
         return "";
 
-    // LOCKING: not required here, data is immutable after creation
+    // LOCKING: not required here, data is only changed by replaceText, which
+    // requires that nothing else is using the buffer at the time
     auto fd = info->data;
     return string_view(fd->mem.data(), fd->mem.size());
 }
@@ -458,6 +471,121 @@ bool SourceManager::isCached(const fs::path& path) const {
     return it != lookupCache.end();
 }
 
+std::vector<BufferID> SourceManager::getAllBuffers() const {
+    std::vector<BufferID> results;
+    std::shared_lock lock(mut);
+    for (size_t i = 0; i < bufferEntries.size(); i++) {
+        auto info = std::get_if<FileInfo>(&bufferEntries[i]);
+        if (info && info->data)
+            results.emplace_back(BufferID((uint32_t)i, info->data->name));
+    }
+    return results;
+}
+
+bool SourceManager::removeCachedFile(const fs::path& path) {
+    std::error_code ec;
+    fs::path absPath = fs::weakly_canonical(path, ec);
+    if (ec)
+        return false;
+
+    std::unique_lock lock(mut);
+    auto it = lookupCache.find(absPath.u8string());
+    if (it == lookupCache.end())
+        return false;
+
+    if (it->second)
+        retiredFiles.emplace_back(std::move(it->second));
+    lookupCache.erase(it);
+    return true;
+}
+
+size_t SourceManager::releaseRemovedFiles() {
+    std::unique_lock lock(mut);
+    if (retiredFiles.empty())
+        return 0;
+
+    std::unordered_set<const FileData*> released;
+    for (auto& fd : retiredFiles)
+        released.emplace(fd.get());
+
+    for (auto& entry : bufferEntries) {
+        auto info = std::get_if<FileInfo>(&entry);
+        if (info && released.count(info->data)) {
+            info->data = nullptr;
+            info->lineDirectives = {};
+        }
+    }
+
+    size_t count = retiredFiles.size();
+    retiredFiles.clear();
+    return count;
+}
+
+SourceBuffer SourceManager::replaceText(BufferID buffer, size_t offset, size_t length,
+                                        string_view text) {
+    FileInfo* info = getFileInfo(buffer);
+    if (!info || !info->data)
+        return SourceBuffer();
+
+    std::unique_lock lock(mut);
+    auto& mem = info->data->mem;
+
+    // The null terminator at the end of the text stays where it is.
+    size_t size = mem.size();
+    if (size && mem.back() == '\0')
+        size--;
+
+    if (offset > size || length > size - offset)
+        throw std::invalid_argument("Edit range must be within the buffer's text");
+
+    // Replace as much as possible in place so that the vector only needs to
+    // move the text after the edit once.
+    size_t common = std::min(length, text.size());
+    std::copy(text.begin(), text.begin() + ptrdiff_t(common), mem.begin() + ptrdiff_t(offset));
+    auto pos = mem.begin() + ptrdiff_t(offset + common);
+    if (common < length)
+        mem.erase(pos, pos + ptrdiff_t(length - common));
+    else
+        mem.insert(pos, text.begin() + ptrdiff_t(common), text.end());
+
+    info->data->lineOffsets.clear();
+    return SourceBuffer{ string_view(mem.data(), mem.size()), buffer };
+}
+
+bool SourceManager::releaseBuffer(BufferID buffer) {
+    FileInfo* info = getFileInfo(buffer);
+    if (!info || !info->data)
+        return false;
+
+    std::unique_lock lock(mut);
+    const FileData* fd = info->data;
+    diagDirectives.erase(buffer);
+
+    // Other buffers, such as another include of the same file, can
+    // share the same data so they get released along with this one.
+    for (auto& entry : bufferEntries) {
+        auto other = std::get_if<FileInfo>(&entry);
+        if (other && other->data == fd) {
+            other->data = nullptr;
+            other->lineDirectives = {};
+        }
+    }
+
+    for (auto it = lookupCache.begin(); it != lookupCache.end(); ++it) {
+        if (it->second.get() == fd) {
+            lookupCache.erase(it);
+            return true;
+        }
+    }
+
+    // The buffer might have been removed from the cache already.
+    auto it = std::find_if(retiredFiles.begin(), retiredFiles.end(),
+                           [&](auto& retired) { return retired.get() == fd; });
+    if (it != retiredFiles.end())
+        retiredFiles.erase(it);
+    return true;
+}
+
 SourceBuffer SourceManager::openCached(const fs::path& fullPath, SourceLocation includedFrom) {
     std::error_code ec;
     fs::path absPath = fs::weakly_canonical(fullPath, ec);
@@ -630,9 +630,7 @@ const Type& PackedArrayType::fromSyntax(const Scope& scope, const Type& elementT
         return comp.getErrorType();
     }
 
-    auto result = comp.emplace<PackedArrayType>(elementType, range);
-    result->setSyntax(syntax);
-    return *result;
+    return comp.getPackedArrayType(elementType, range, &syntax);
 }
 
 FixedSizeUnpackedArrayType::FixedSizeUnpackedArrayType(const Type& elementType,
@@ -649,8 +647,7 @@ const Type& FixedSizeUnpackedArrayType::fromDims(Compilation& compilation, const
     const Type* result = &elementType;
     size_t count = dimensions.size();
     for (size_t i = 0; i < count; i++) {
-        result =
-            compilation.emplace<FixedSizeUnpackedArrayType>(*result, dimensions[count - i - 1]);
+        result = &compilation.getUnpackedArrayType(*result, dimensions[count - i - 1]);
     }
 
     return *result;
@@ -268,7 +268,7 @@ static const Type* makeSigned(Compilation& compilation, const Type& type) {
     curr = &compilation.getScalarType(flags);
     size_t count = dims.size();
     for (size_t i = 0; i < count; i++)
-        curr = compilation.emplace<PackedArrayType>(*curr, dims[count - i - 1]);
+        curr = &compilation.getPackedArrayType(*curr, dims[count - i - 1]);
 
     return curr;
 }
@@ -389,19 +389,47 @@ bool Type::isTaggedUnion() const {
     }
 }
 
-bool Type::isMatching(const Type& rhs) const {
-    // See [6.22.1] for Matching Types.
-    const Type* l = &getCanonicalType();
-    const Type* r = &rhs.getCanonicalType();
+// Gets the compilation that should cache relations involving the given canonical
+// type. Only types that can require deep comparisons are cached; checks involving
+// anything else are cheap enough to just do directly.
+static Compilation* getRelationCache(const Type& type) {
+    switch (type.kind) {
+        case SymbolKind::EnumType:
+            return &type.as<EnumType>().getCompilation();
+        case SymbolKind::PackedStructType:
+            return &type.as<PackedStructType>().getCompilation();
+        case SymbolKind::UnpackedStructType:
+            return &type.as<UnpackedStructType>().getCompilation();
+        case SymbolKind::PackedUnionType:
+            return &type.as<PackedUnionType>().getCompilation();
+        case SymbolKind::UnpackedUnionType:
+            return &type.as<UnpackedUnionType>().getCompilation();
+        case SymbolKind::ClassType:
+            return &type.as<ClassType>().getCompilation();
+        case SymbolKind::VirtualInterfaceType:
+            return &type.as<VirtualInterfaceType>().iface.body.getCompilation();
+        default:
+            return nullptr;
+    }
+}
 
-    // If the two types have the same address, they are literally the same type.
-    // This handles all built-in types, which are allocated once and then shared,
-    // and also handles simple bit vector types that share the same range, signedness,
-    // and four-stateness because we uniquify them in the compilation cache.
-    // This handles checks [6.22.1] (a), (b), (c), (d), (g), and (h).
-    if (l == r)
-        return true;
+template<typename TFunc>
+static bool checkRelation(TypeRelation relation, const Type& l, const Type& r, TFunc&& func) {
+    auto comp = getRelationCache(l);
+    if (!comp)
+        comp = getRelationCache(r);
+    if (!comp)
+        return func(&l, &r);
 
+    if (auto cached = comp->findTypeRelation(relation, l, r))
+        return *cached;
+
+    bool result = func(&l, &r);
+    comp->cacheTypeRelation(relation, l, r, result);
+    return result;
+}
+
+static bool isMatchingImpl(const Type* l, const Type* r) {
     if (l->getSyntax() && l->getSyntax() == r->getSyntax() &&
         l->getParentScope() == r->getParentScope()) {
         return true;
@@ -480,10 +508,7 @@ bool Type::isMatching(const Type& rhs) const {
     return false;
 }
 
-bool Type::isEquivalent(const Type& rhs) const {
-    // See [6.22.2] for Equivalent Types
-    const Type* l = &getCanonicalType();
-    const Type* r = &rhs.getCanonicalType();
+static bool isEquivalentImpl(const Type* l, const Type* r) {
     if (l->isMatching(*r))
         return true;
 
@@ -531,10 +556,7 @@ bool Type::isEquivalent(const Type& rhs) const {
     return false;
 }
 
-bool Type::isAssignmentCompatible(const Type& rhs) const {
-    // See [6.22.3] for Assignment Compatible
-    const Type* l = &getCanonicalType();
-    const Type* r = &rhs.getCanonicalType();
+static bool isAssignmentCompatibleImpl(const Type* l, const Type* r) {
     if (l->isEquivalent(*r))
         return true;
 
@@ -601,6 +623,43 @@ bool Type::isAssignmentCompatible(const Type& rhs) const {
     return false;
 }
 
+bool Type::isMatching(const Type& rhs) const {
+    // See [6.22.1] for Matching Types.
+    const Type* l = &getCanonicalType();
+    const Type* r = &rhs.getCanonicalType();
+
+    // If the two types have the same address, they are literally the same type.
+    // This handles all built-in types, which are allocated once and then shared,
+    // and also handles simple bit vector types that share the same range, signedness,
+    // and four-stateness, along with fixed size packed and unpacked arrays that share
+    // the same element type and range, because we uniquify them in the compilation cache.
+    // This handles checks [6.22.1] (a), (b), (c), (d), (g), and (h).
+    if (l == r)
+        return true;
+
+    return checkRelation(TypeRelation::Matching, *l, *r, isMatchingImpl);
+}
+
+bool Type::isEquivalent(const Type& rhs) const {
+    // See [6.22.2] for Equivalent Types
+    const Type* l = &getCanonicalType();
+    const Type* r = &rhs.getCanonicalType();
+    if (l == r)
+        return true;
+
+    return checkRelation(TypeRelation::Equivalent, *l, *r, isEquivalentImpl);
+}
+
+bool Type::isAssignmentCompatible(const Type& rhs) const {
+    // See [6.22.3] for Assignment Compatible
+    const Type* l = &getCanonicalType();
+    const Type* r = &rhs.getCanonicalType();
+    if (l == r)
+        return true;
+
+    return checkRelation(TypeRelation::AssignmentCompatible, *l, *r, isAssignmentCompatibleImpl);
+}
+
 bool Type::isCastCompatible(const Type& rhs) const {
     // See [6.22.4] for Cast Compatible
     const Type* l = &getCanonicalType();
@@ -1001,8 +1060,8 @@ const Type& Type::fromSyntax(Compilation& compilation, const Type& elementType,
                 return compilation.getErrorType();
             case DimensionKind::Range:
             case DimensionKind::AbbreviatedRange:
-                next = compilation.emplace<FixedSizeUnpackedArrayType>(*result, dim.range);
-                break;
+                result = &compilation.getUnpackedArrayType(*result, dim.range, &syntax);
+                continue;
             case DimensionKind::Dynamic:
                 next = compilation.emplace<DynamicArrayType>(*result);
                 break;
@@ -6,26 +6,33 @@
 //------------------------------------------------------------------------------
 #include "slang/util/BumpAllocator.h"
 
+#include <algorithm>
 #include <cstdlib>
 
+#if defined(__linux__)
+#    include <sys/mman.h>
+#endif
+
 namespace slang {
 
+#if defined(__linux__)
+static constexpr size_t HugePageSize = 2 * 1024 * 1024;
+#endif
+
 BumpAllocator::BumpAllocator() {
     head = allocSegment(nullptr, INITIAL_SIZE);
     endPtr = (byte*)head + INITIAL_SIZE;
 }
 
 BumpAllocator::~BumpAllocator() {
-    Segment* seg = head;
-    while (seg) {
-        Segment* prev = seg->prev;
-        free(seg);
-        seg = prev;
-    }
+    freeSegments(head);
+    freeSegments(freeList);
 }
 
 BumpAllocator::BumpAllocator(BumpAllocator&& other) noexcept :
-    head(std::exchange(other.head, nullptr)), endPtr(other.endPtr) {
+    head(std::exchange(other.head, nullptr)), endPtr(other.endPtr),
+    freeList(std::exchange(other.freeList, nullptr)), retiredBytes(other.retiredBytes),
+    nextSegmentSize(other.nextSegmentSize), useHugePages(other.useHugePages) {
 }
 
 BumpAllocator& BumpAllocator::operator=(BumpAllocator&& other) noexcept {
@@ -41,6 +48,7 @@ void BumpAllocator::steal(BumpAllocator&& other) {
     if (!seg)
         return;
 
+    retiredBytes += other.getBytesAllocated();
     while (seg->prev)
         seg = seg->prev;
 
@@ -48,25 +56,132 @@ void BumpAllocator::steal(BumpAllocator&& other) {
     head->prev = std::exchange(other.head, nullptr);
 }
 
+void BumpAllocator::reset() {
+    // Large segments are sized for one specific allocation, so they
+    // aren't worth keeping. Everything else goes on the free list.
+    Segment* seg = head;
+    while (seg) {
+        Segment* prev = seg->prev;
+        if (seg->isLarge) {
+            free(seg);
+        }
+        else {
+            seg->current = (byte*)(seg + 1);
+            seg->prev = freeList;
+            freeList = seg;
+        }
+        seg = prev;
+    }
+
+    // Start over with the largest of the retained segments.
+    Segment** best = &freeList;
+    for (Segment** it = &freeList; *it; it = &(*it)->prev) {
+        if ((*it)->size > (*best)->size)
+            best = it;
+    }
+
+    head = *best;
+    *best = head->prev;
+    head->prev = nullptr;
+    endPtr = (byte*)head + head->size;
+    retiredBytes = 0;
+}
+
 byte* BumpAllocator::allocateSlow(size_t size, size_t alignment) {
     // for really large allocations, give them their own segment
-    if (size > (SEGMENT_SIZE >> 1)) {
+    if (size > (nextSegmentSize >> 1)) {
         size = (size + alignment - 1) & ~(alignment - 1);
-        head->prev = allocSegment(head->prev, size + sizeof(Segment));
+        head->prev = allocSegment(head->prev, size + alignment + sizeof(Segment),
+                                  /* isLarge */ true);
+        retiredBytes += head->prev->size - sizeof(Segment);
         return alignPtr(head->prev->current, alignment);
     }
 
-    // otherwise, start a new block
-    head = allocSegment(head, SEGMENT_SIZE);
-    endPtr = (byte*)head + SEGMENT_SIZE;
+    // otherwise, start a new block, reusing a free one if there's one big enough
+    retiredBytes += size_t(head->current - (byte*)(head + 1));
+
+    size_t needed = size + alignment + sizeof(Segment);
+    for (Segment** it = &freeList; *it; it = &(*it)->prev) {
+        Segment* seg = *it;
+        if (seg->size >= needed) {
+            *it = seg->prev;
+            seg->prev = head;
+            head = seg;
+            endPtr = (byte*)head + head->size;
+            return allocate(size, alignment);
+        }
+    }
+
+    size_t segmentSize = nextSegmentSize;
+    nextSegmentSize = std::min(nextSegmentSize * 2, size_t(MAX_SEGMENT_SIZE));
+
+    head = allocSegment(head, segmentSize);
+    endPtr = (byte*)head + segmentSize;
     return allocate(size, alignment);
 }
 
-BumpAllocator::Segment* BumpAllocator::allocSegment(Segment* prev, size_t size) {
-    auto seg = (Segment*)malloc(size);
+BumpAllocator::Segment* BumpAllocator::allocSegment(Segment* prev, size_t size, bool isLarge) {
+    Segment* seg = nullptr;
+
+#if defined(__linux__)
+    if (useHugePages && size >= HugePageSize) {
+        size = (size + HugePageSize - 1) & ~(HugePageSize - 1);
+        seg = (Segment*)aligned_alloc(HugePageSize, size);
+        if (seg)
+            madvise(seg, size, MADV_HUGEPAGE);
+    }
+#endif
+
+    if (!seg)
+        seg = (Segment*)malloc(size);
+
     seg->prev = prev;
-    seg->current = (byte*)seg + sizeof(Segment);
+    seg->current = (byte*)(seg + 1);
+    seg->size = size;
+    seg->isLarge = isLarge;
     return seg;
 }
 
+void BumpAllocator::freeSegments(Segment* seg) {
+    while (seg) {
+        Segment* prev = seg->prev;
+        free(seg);
+        seg = prev;
+    }
+}
+
+BumpAllocator::Stats& BumpAllocator::Stats::operator+=(const Stats& other) {
+    bytesAllocated += other.bytesAllocated;
+    bytesReserved += other.bytesReserved;
+    bytesWasted += other.bytesWasted;
+    segmentCount += other.segmentCount;
+    return *this;
+}
+
+BumpAllocator::Stats BumpAllocator::getStats() const {
+    Stats stats;
+    for (Segment* seg = head; seg; seg = seg->prev) {
+        stats.segmentCount++;
+        stats.bytesReserved += seg->size;
+
+        size_t capacity = seg->size - sizeof(Segment);
+        if (seg->isLarge) {
+            stats.bytesAllocated += capacity;
+        }
+        else {
+            size_t used = size_t(seg->current - (byte*)(seg + 1));
+            stats.bytesAllocated += used;
+            if (seg != head)
+                stats.bytesWasted += capacity - used;
+        }
+    }
+
+    for (Segment* seg = freeList; seg; seg = seg->prev) {
+        stats.segmentCount++;
+        stats.bytesReserved += seg->size;
+    }
+
+    return stats;
+}
+
 } // namespace slang
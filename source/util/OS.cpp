@@ -9,9 +9,25 @@
 #if defined(_MSC_VER)
 #    include <fcntl.h>
 #    include <io.h>
+#    include <process.h>
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    define WIN32_LEAN_AND_MEAN
+#    include <Windows.h>
 #else
+#    include <cerrno>
+#    include <spawn.h>
 #    include <sys/stat.h>
+#    include <sys/wait.h>
 #    include <unistd.h>
+#    if defined(__APPLE__)
+#        include <crt_externs.h>
+#        include <cstring>
+#        include <mach-o/dyld.h>
+#    else
+extern char** environ;
+#    endif
 #endif
 
 #include <fstream>
@@ -75,4 +91,108 @@ bool OS::readFile(const fs::path& path, std::vector<char>& buffer) {
     return true;
 }
 
+#if defined(_MSC_VER)
+
+fs::path OS::getExecutablePath() {
+    std::wstring buffer(MAX_PATH, L'\0');
+    while (true) {
+        DWORD len = GetModuleFileNameW(nullptr, buffer.data(), DWORD(buffer.size()));
+        if (len == 0)
+            return {};
+
+        if (len < buffer.size()) {
+            buffer.resize(len);
+            return fs::path(buffer);
+        }
+        buffer.resize(buffer.size() * 2);
+    }
+}
+
+int OS::runProcess(const std::vector<std::string>& args) {
+    if (args.empty())
+        return -1;
+
+    // The CRT joins arguments with spaces before handing them to the new process,
+    // so each one needs to be quoted according to the usual command line rules.
+    std::vector<std::wstring> quoted;
+    for (auto& arg : args) {
+        std::wstring result = L"\"";
+        size_t backslashes = 0;
+        for (wchar_t c : widen(arg)) {
+            if (c == L'\\') {
+                backslashes++;
+            }
+            else {
+                if (c == L'"')
+                    result.append(backslashes + 1, L'\\');
+                backslashes = 0;
+            }
+            result.push_back(c);
+        }
+        result.append(backslashes, L'\\');
+        result.push_back(L'"');
+        quoted.emplace_back(std::move(result));
+    }
+
+    std::vector<const wchar_t*> argv;
+    for (auto& arg : quoted)
+        argv.push_back(arg.c_str());
+    argv.push_back(nullptr);
+
+    auto program = widen(args[0]);
+    return int(_wspawnvp(_P_WAIT, program.c_str(), argv.data()));
+}
+
+#else
+
+fs::path OS::getExecutablePath() {
+#    if defined(__APPLE__)
+    uint32_t size = 0;
+    _NSGetExecutablePath(nullptr, &size);
+
+    std::string buffer(size, '\0');
+    if (_NSGetExecutablePath(buffer.data(), &size) != 0)
+        return {};
+
+    buffer.resize(strlen(buffer.c_str()));
+    std::error_code ec;
+    auto result = fs::canonical(buffer, ec);
+    return ec ? fs::path() : result;
+#    else
+    std::error_code ec;
+    auto result = fs::read_symlink("/proc/self/exe", ec);
+    return ec ? fs::path() : result;
+#    endif
+}
+
+int OS::runProcess(const std::vector<std::string>& args) {
+    if (args.empty())
+        return -1;
+
+    std::vector<char*> argv;
+    for (auto& arg : args)
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    argv.push_back(nullptr);
+
+#    if defined(__APPLE__)
+    char** env = *_NSGetEnviron();
+#    else
+    char** env = environ;
+#    endif
+
+    pid_t pid;
+    if (posix_spawnp(&pid, argv[0], nullptr, nullptr, argv.data(), env) != 0)
+        return -1;
+
+    int status;
+    while (waitpid(pid, &status, 0) == -1) {
+        if (errno != EINTR)
+            return -1;
+    }
+
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+#endif
+
 } // namespace slang
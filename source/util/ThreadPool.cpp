@@ -0,0 +1,151 @@
+//------------------------------------------------------------------------------
+// ThreadPool.cpp
+// Work-stealing pool of worker threads
+//
+// File is under the MIT license; see LICENSE for details
+//------------------------------------------------------------------------------
+#include "slang/util/ThreadPool.h"
+
+#include <algorithm>
+
+namespace slang {
+
+// The pool and index of the worker running on the current thread, if any.
+static thread_local const ThreadPool* currentPool = nullptr;
+static thread_local uint32_t currentIndex = 0;
+
+ThreadPool::ThreadPool(uint32_t numThreads) {
+    // There is one extra queue, owned by whichever thread is waiting on the pool.
+    for (uint32_t i = 0; i <= numThreads; i++)
+        queues.emplace_back(std::make_unique<WorkerQueue>());
+
+    threads.reserve(numThreads);
+    for (uint32_t i = 0; i < numThreads; i++)
+        threads.emplace_back([this, i] { workerMain(i); });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::unique_lock lock(sleepMutex);
+        stopping = true;
+    }
+    sleepCond.notify_all();
+
+    for (auto& thread : threads)
+        thread.join();
+}
+
+uint32_t ThreadPool::getHardwareThreads() {
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+uint32_t ThreadPool::getCurrentThreadIndex() const {
+    return currentPool == this ? currentIndex : getThreadCount();
+}
+
+void ThreadPool::push(std::function<void()> task) {
+    // Work spawned by a worker stays local to it unless someone else steals it.
+    uint32_t index = getCurrentThreadIndex();
+    if (index == getThreadCount() && !threads.empty())
+        index = nextQueue++ % getThreadCount();
+
+    // The counts go up before the task is visible so that they can never
+    // drop below zero when someone else runs it right away.
+    pendingTasks++;
+    {
+        std::unique_lock lock(sleepMutex);
+        queuedTasks++;
+    }
+
+    {
+        auto& queue = *queues[index];
+        std::unique_lock lock(queue.mutex);
+        queue.tasks.emplace_back(std::move(task));
+    }
+    sleepCond.notify_one();
+}
+
+bool ThreadPool::tryRunOne(uint32_t self) {
+    std::function<void()> task;
+
+    // Take from the back of our own queue first, then steal from the front of others.
+    {
+        auto& queue = *queues[self];
+        std::unique_lock lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+    }
+
+    for (size_t i = 1; !task && i < queues.size(); i++) {
+        auto& queue = *queues[(self + i) % queues.size()];
+        std::unique_lock lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+    }
+
+    if (!task)
+        return false;
+
+    queuedTasks--;
+    runTask(task);
+    return true;
+}
+
+void ThreadPool::runTask(std::function<void()>& task) {
+    try {
+        task();
+    }
+    catch (...) {
+        std::unique_lock lock(errorMutex);
+        if (!firstError)
+            firstError = std::current_exception();
+    }
+
+    if (--pendingTasks == 0) {
+        std::unique_lock lock(sleepMutex);
+        sleepCond.notify_all();
+    }
+}
+
+void ThreadPool::workerMain(uint32_t index) {
+    currentPool = this;
+    currentIndex = index;
+
+    while (true) {
+        if (tryRunOne(index))
+            continue;
+
+        std::unique_lock lock(sleepMutex);
+        sleepCond.wait(lock, [this] { return stopping || queuedTasks > 0; });
+        if (stopping)
+            return;
+    }
+}
+
+void ThreadPool::waitForAll() {
+    uint32_t self = getThreadCount();
+    while (true) {
+        if (tryRunOne(self))
+            continue;
+
+        std::unique_lock lock(sleepMutex);
+        sleepCond.wait(lock, [this] { return pendingTasks == 0 || queuedTasks > 0; });
+        if (pendingTasks == 0)
+            break;
+    }
+
+    std::exception_ptr error;
+    {
+        std::unique_lock lock(errorMutex);
+        std::swap(error, firstError);
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+} // namespace slang
@@ -0,0 +1,41 @@
+# Copies the driver and the simulation runtime libraries into a fresh install-like
+# tree, then uses that copy to build a standalone executable from SOURCE and checks
+# what it prints. Doing this from a relocated copy makes sure the driver doesn't
+# depend on paths in the build tree.
+#
+# Expects DRIVER, RUNTIME_LIB, CORE_LIB, SOURCE, WORK_DIR, and EXE_SUFFIX to be defined.
+
+file(REMOVE_RECURSE "${WORK_DIR}")
+file(MAKE_DIRECTORY "${WORK_DIR}/bin" "${WORK_DIR}/lib")
+file(COPY "${DRIVER}" DESTINATION "${WORK_DIR}/bin")
+file(COPY "${RUNTIME_LIB}" "${CORE_LIB}" DESTINATION "${WORK_DIR}/lib")
+
+get_filename_component(driverName "${DRIVER}" NAME)
+set(driver "${WORK_DIR}/bin/${driverName}")
+
+execute_process(COMMAND "${driver}" --emit-obj "${WORK_DIR}/sim.o" "${SOURCE}"
+                RESULT_VARIABLE result)
+if(NOT result EQUAL 0 OR NOT EXISTS "${WORK_DIR}/sim.o")
+    message(FATAL_ERROR "--emit-obj failed: ${result}")
+endif()
+
+file(SIZE "${WORK_DIR}/sim.o" objSize)
+if(objSize EQUAL 0)
+    message(FATAL_ERROR "--emit-obj wrote an empty object file")
+endif()
+
+set(exe "${WORK_DIR}/sim${EXE_SUFFIX}")
+execute_process(COMMAND "${driver}" --emit-exe "${exe}" "${SOURCE}"
+                RESULT_VARIABLE result)
+if(NOT result EQUAL 0 OR NOT EXISTS "${exe}")
+    message(FATAL_ERROR "--emit-exe failed: ${result}")
+endif()
+
+execute_process(COMMAND "${exe}" RESULT_VARIABLE result OUTPUT_VARIABLE output)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "simulation executable failed: ${result}")
+endif()
+
+if(NOT output STREQUAL "Hello from slang:          42\n")
+    message(FATAL_ERROR "unexpected simulation output: '${output}'")
+endif()
@@ -0,0 +1,113 @@
+#!/usr/bin/env python
+# Drives `slang --server` over stdin/stdout: compiles a small design, edits its
+# files on disk, and checks that the next compile request only reparses the files
+# that changed and reports the updated diagnostics.
+#
+# Usage: compile_server.py <driver> <work dir>
+
+import json
+import os
+import shutil
+import subprocess
+import sys
+
+driver, workDir = sys.argv[1:3]
+shutil.rmtree(workDir, ignore_errors=True)
+os.makedirs(workDir)
+
+top = os.path.join(workDir, "top.sv")
+leaf = os.path.join(workDir, "leaf.sv")
+other = os.path.join(workDir, "other.sv")
+bump = [0]
+
+
+def write(path, text):
+    with open(path, "w") as f:
+        f.write(text)
+
+    # Make sure the server sees a new timestamp even on file systems
+    # with coarse timestamp resolution.
+    bump[0] += 10
+    stat = os.stat(path)
+    os.utime(path, (stat.st_atime, stat.st_mtime + bump[0]))
+
+
+def fail(message):
+    server.kill()
+    sys.exit(message)
+
+
+write(top, "module top;\n    leaf l();\n    other o();\nendmodule\n")
+write(leaf, "module leaf;\n    int i = foo;\nendmodule\n")
+write(other, "module other;\n    int k = 1;\nendmodule\n")
+
+server = subprocess.Popen(
+    [driver, "--server", top, leaf, other],
+    stdin=subprocess.PIPE,
+    stdout=subprocess.PIPE,
+    universal_newlines=True,
+)
+nextId = [0]
+
+
+def request(method):
+    nextId[0] += 1
+    server.stdin.write(json.dumps({"jsonrpc": "2.0", "id": nextId[0], "method": method}) + "\n")
+    server.stdin.flush()
+
+    line = server.stdout.readline()
+    if not line:
+        fail("server exited before responding to '{}'".format(method))
+
+    response = json.loads(line)
+    if response.get("id") != nextId[0]:
+        fail("unexpected response: {}".format(line))
+    return response
+
+
+def compile(expectReparsed, expectMessages):
+    result = request("compile").get("result")
+    if result is None:
+        fail("compile request failed")
+
+    messages = [d["message"] for d in result["diagnostics"]]
+    if result["reparsed"] != expectReparsed or messages != expectMessages:
+        fail("unexpected compile result: {}".format(json.dumps(result, indent=2)))
+
+    if result["errors"] != len(expectMessages) or result["success"] != (not expectMessages):
+        fail("unexpected error count: {}".format(json.dumps(result, indent=2)))
+    return result
+
+
+# The first request compiles what was loaded on startup.
+compile(0, ["use of undeclared identifier 'foo'"])
+
+# Nothing changed, so nothing gets reparsed.
+compile(0, ["use of undeclared identifier 'foo'"])
+
+# Fixing the error only reparses the file that changed.
+write(leaf, "module leaf;\n    int i = 1;\nendmodule\n")
+compile(1, [])
+
+# A new error in a different place shows up too.
+write(leaf, "module leaf;\n    int i = 1;\n    int j = bar;\nendmodule\n")
+result = compile(1, ["use of undeclared identifier 'bar'"])
+diag = result["diagnostics"][0]
+if diag["line"] != 3 or os.path.basename(diag["file"]) != "leaf.sv":
+    fail("wrong location for diagnostic: {}".format(json.dumps(diag)))
+
+# Changing more than one file reparses each of them.
+write(leaf, "module leaf;\n    int i = 1;\nendmodule\n")
+write(other, "module other;\n    int k = baz;\nendmodule\n")
+compile(2, ["use of undeclared identifier 'baz'"])
+
+# Touching a file without changing its contents doesn't reparse it.
+write(top, "module top;\n    leaf l();\n    other o();\nendmodule\n")
+compile(0, ["use of undeclared identifier 'baz'"])
+
+if request("shutdown").get("result", 0) is not None:
+    fail("bad shutdown response")
+
+server.stdin.close()
+if server.wait() != 0:
+    sys.exit("server exited with code {}".format(server.returncode))
@@ -0,0 +1,6 @@
+module hello_sim;
+    initial begin
+        automatic int i = 42;
+        $display("Hello from slang: ", i);
+    end
+endmodule
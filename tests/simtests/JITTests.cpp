@@ -1,9 +1,15 @@
 #include "Test.h"
 
+#include <filesystem>
+#include <fmt/format.h>
+#include <fstream>
+
 #include "slang/codegen/JIT.h"
 #include "slang/runtime/Runtime.h"
 #include "slang/symbols/BlockSymbols.h"
 
+namespace fs = std::filesystem;
+
 #ifdef __APPLE__
 // Work around a clang optimization bug on deallocating "result" before lambda call
 [[clang::optnone]]
@@ -38,3 +44,197 @@ endmodule
 
     CHECK(result == "          3          4          4 Hello, World!\n");
 }
+
+TEST_CASE("JIT object cache") {
+    auto dir = fs::temp_directory_path() / "slang_jit_cache_test";
+    fs::remove_all(dir);
+
+    auto runOnce = [&](uint64_t& hits, uint64_t& misses) {
+        Compilation compilation;
+        compile(compilation, R"(
+module m;
+    initial $display("Hello, cache!");
+endmodule
+)");
+
+        auto& block =
+            *compilation.getRoot().topInstances[0]->body.membersOfType<ProceduralBlockSymbol>()[0];
+
+        MIRBuilder builder(compilation);
+        Procedure proc(builder, block);
+
+        CodeGenerator codegen(compilation);
+        codegen.emit(proc);
+
+        std::string result;
+        slang::runtime::setOutputHandler([&](string_view text) { result += text; });
+
+        JITOptions options;
+        options.objectCacheDir = dir.string();
+
+        JIT jit(options);
+        jit.addCode(codegen.finish());
+        CHECK(jit.run() == 0);
+        CHECK(result == "Hello, cache!\n");
+
+        hits = jit.getNumCacheHits();
+        misses = jit.getNumCacheMisses();
+    };
+
+    uint64_t hits, misses;
+    runOnce(hits, misses);
+    CHECK(hits == 0);
+    CHECK(misses > 0);
+
+    runOnce(hits, misses);
+    CHECK(hits > 0);
+    CHECK(misses == 0);
+
+    fs::remove_all(dir);
+}
+
+TEST_CASE("JIT with optimization") {
+    Compilation compilation;
+    compile(compilation, R"(
+module m;
+    initial begin
+        automatic int i = -4;
+        $display(-i, "Optimized");
+    end
+endmodule
+)");
+
+    auto& block =
+        *compilation.getRoot().topInstances[0]->body.membersOfType<ProceduralBlockSymbol>()[0];
+
+    MIRBuilder builder(compilation);
+    Procedure proc(builder, block);
+
+    CodegenOptions options;
+    options.optLevel = 2;
+
+    CodeGenerator codegen(compilation, options);
+    codegen.emit(proc);
+
+    auto code = codegen.finish();
+    REQUIRE(code.size() == 1);
+    CHECK(code[0].getTiming().codegen > 0.0);
+    CHECK(code[0].getTiming().optimize > 0.0);
+
+    std::string result;
+    slang::runtime::setOutputHandler([&](string_view text) { result += text; });
+
+    JIT jit;
+    jit.addCode(std::move(code));
+    CHECK(jit.run() == 0);
+
+    CHECK(result == "          4Optimized\n");
+}
+
+TEST_CASE("JIT parallel codegen") {
+    Compilation compilation;
+    compile(compilation, R"(
+module m;
+    initial $display("one");
+    initial $display("two");
+    initial $display("three");
+endmodule
+)");
+
+    MIRBuilder builder(compilation);
+    builder.elaborate();
+
+    CodegenOptions options;
+    options.numThreads = 2;
+
+    CodeGenerator codegen(compilation, options);
+    codegen.emitAll(builder);
+
+    auto code = codegen.finish();
+    CHECK(code.size() == 3);
+
+    std::string result;
+    slang::runtime::setOutputHandler([&](string_view text) { result += text; });
+
+    JITOptions jitOptions;
+    jitOptions.numCompileThreads = 2;
+
+    JIT jit(jitOptions);
+    jit.addCode(std::move(code));
+    CHECK(jit.run() == 0);
+
+    CHECK(result == "one\ntwo\nthree\n");
+}
+
+TEST_CASE("JIT file output") {
+    auto path = fs::temp_directory_path() / "slang_jit_file_output.txt";
+    fs::remove(path);
+
+    Compilation compilation;
+    compile(compilation, fmt::format(R"(
+module m;
+    initial begin
+        automatic int fd = $fopen("{}", "w");
+        $fwrite(fd, "Hello, ");
+        $fdisplayh(fd, 8'd255);
+        $fclose(fd);
+    end
+endmodule
+)",
+                                     path.generic_string()));
+
+    auto& block =
+        *compilation.getRoot().topInstances[0]->body.membersOfType<ProceduralBlockSymbol>()[0];
+
+    MIRBuilder builder(compilation);
+    Procedure proc(builder, block);
+
+    CodeGenerator codegen(compilation);
+    codegen.emit(proc);
+
+    JIT jit;
+    jit.addCode(codegen.finish());
+    CHECK(jit.run() == 0);
+
+    std::ifstream file(path);
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    CHECK(contents == "Hello, ff\n");
+
+    file.close();
+    fs::remove(path);
+}
+
+TEST_CASE("Object file output") {
+    auto path = fs::temp_directory_path() / "slang_codegen_object.o";
+    fs::remove(path);
+
+    Compilation compilation;
+    compile(compilation, R"(
+module m;
+    initial $display("Hello, object!");
+endmodule
+)");
+
+    auto& block =
+        *compilation.getRoot().topInstances[0]->body.membersOfType<ProceduralBlockSymbol>()[0];
+
+    MIRBuilder builder(compilation);
+    Procedure proc(builder, block);
+
+    CodeGenerator codegen(compilation);
+    codegen.emit(proc);
+
+    auto code = codegen.finish();
+    REQUIRE(code.size() == 1);
+    code[0].writeObjectFile(path.string());
+
+    // The object should define the entry point and contain the string being printed.
+    std::ifstream file(path, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    CHECK(!contents.empty());
+    CHECK(contents.find("main") != std::string::npos);
+    CHECK(contents.find("Hello, object!") != std::string::npos);
+
+    file.close();
+    fs::remove(path);
+}
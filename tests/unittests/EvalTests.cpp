@@ -2147,6 +2147,13 @@ TEST_CASE("Array ordering methods") {
     session.eval("b.rsort");
     CHECK(session.eval("b").toString() == "[8,4,1,-2,-8,-9]");
 
+    // Elements with equal keys keep their original relative order.
+    session.eval("int e[$] = {13, 2, 21, 4, 3, 11, 32};");
+    session.eval("e.sort with (item % 10)");
+    CHECK(session.eval("e").toString() == "[21,11,2,32,13,3,4]");
+    session.eval("e.rsort with (item % 10)");
+    CHECK(session.eval("e").toString() == "[4,13,3,2,32,21,11]");
+
     session.eval("int c[] = {1, 9, 4, 3};");
     session.eval("string d[$] = {\"asdf\", \"baz\", \"bar\"};");
     session.eval("c.reverse");
@@ -2189,6 +2196,60 @@ TEST_CASE("Array locator methods") {
     CHECK(session.eval("f.unique_index").toString() == "[\"a\",\"b\"]");
     CHECK(session.eval("f.unique_index with (item == 5 ? 1 : item)").toString() == "[\"a\"]");
 
+    // Equality predicates against a value that doesn't depend on the iterator.
+    session.eval("int k = 8;");
+    CHECK(session.eval("a.find with (item == k)").toString() == "[8,8]");
+    CHECK(session.eval("a.find_last_index with (k == item)").toString() == "[5]");
+    CHECK(session.eval("b.find_first_index with (item === -9)").toString() == "[3]");
+    CHECK(session.eval("c.find_index with (item == 4)").toString() == "[\"good\"]");
+    CHECK(session.eval("d.find with (item == k)").toString() == "[]");
+
+    session.eval("string g[$] = {\"foo\", \"bar\", \"foo\"};");
+    CHECK(session.eval("g.find_index with (item == \"foo\")").toString() == "[0,2]");
+
+    // Comparisons against something with side effects need to be evaluated every time.
+    session.eval(R"(
+function automatic int locateSideEffects();
+    int e[] = '{1, 1, 4, 9, -3, 1, 2};
+    int r1[$], r2[$];
+    int cnt = 0, x = 0;
+    r1 = e.find_index with (item == cnt++);
+    r2 = e.find_index with (item == (x = x + 1));
+    return r1[0] * 1000 + cnt * 100 + r2.size() * 10 + x;
+endfunction
+)");
+    CHECK(session.eval("locateSideEffects()").integer() == 1717);
+
+    NO_SESSION_ERRORS;
+}
+
+TEST_CASE("Associative arrays with integral keys") {
+    ScriptSession session;
+    session.eval("int m[int] = '{5:1, -3:2, 0:3, -100:4, 1000:5};");
+    CHECK(session.eval("m").toString() == "[-100:4,-3:2,0:3,5:1,1000:5]");
+    CHECK(session.eval("m[-3]").integer() == 2);
+    CHECK(session.eval("m[1000]").integer() == 5);
+
+    session.eval("m[-4] = 6;");
+    session.eval("m.delete(0);");
+    CHECK(session.eval("m").toString() == "[-100:4,-4:6,-3:2,5:1,1000:5]");
+
+    session.eval("bit [7:0] u[bit [7:0]] = '{8'hff:1, 8'h01:2, 8'h80:3};");
+    CHECK(session.eval("u").toString() == "[8'd1:8'd2,8'd128:8'd3,8'd255:8'd1]");
+
+    session.eval(R"(
+function automatic int lookup(int n);
+    int tbl[int];
+    int sum = 0;
+    for (int i = 0; i < n; i++)
+        tbl[i * 3] = i;
+    for (int i = 0; i < n; i++)
+        sum += tbl[i * 3];
+    return sum;
+endfunction
+)");
+    CHECK(session.eval("lookup(1000)").integer() == 499500);
+
     NO_SESSION_ERRORS;
 }
 
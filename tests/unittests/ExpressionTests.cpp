@@ -2563,6 +2563,53 @@ endmodule
     CHECK(diags[4].code == diag::MultipleUDNTDrivers);
 }
 
+TEST_CASE("Driver overlap queries") {
+    auto tree = SyntaxTree::fromText(R"(
+module m;
+    logic [7:0] arr[512];
+    for (genvar i = 0; i < 512; i++) begin
+        assign arr[i] = 8'(i);
+    end
+    assign arr[100][3:0] = '0;
+
+    logic [15:0] v;
+    assign v[3:0] = '0;
+    assign v[7:4] = '1;
+    always_comb v[15:8] = '0;
+    initial v = '0;
+endmodule
+)");
+
+    Compilation compilation;
+    compilation.addSyntaxTree(tree);
+
+    auto& diags = compilation.getAllDiagnostics();
+    REQUIRE(diags.size() == 2);
+    CHECK(diags[0].code == diag::MultipleContAssigns);
+    CHECK(diags[1].code == diag::MixedVarAssigns);
+
+    auto& root = compilation.getRoot();
+    auto& arr = root.lookupName<VariableSymbol>("m.arr");
+    SmallVectorSized<const ValueSymbol::Driver*, 4> drivers;
+    arr.getOverlappingDrivers({ 10, 12 }, drivers);
+    CHECK(drivers.size() == 3);
+
+    drivers.clear();
+    arr.getOverlappingDrivers({ 100, 100 }, drivers);
+    CHECK(drivers.size() == 1);
+
+    auto& v = root.lookupName<VariableSymbol>("m.v");
+    drivers.clear();
+    v.getOverlappingDrivers({ 5, 2 }, drivers);
+    REQUIRE(drivers.size() == 2);
+    CHECK(drivers[0]->getPrefix()[0].upper() == 3);
+    CHECK(drivers[1]->getPrefix()[0].upper() == 7);
+
+    drivers.clear();
+    v.getOverlappingDrivers({ 15, 15 }, drivers);
+    CHECK(drivers.size() == 1);
+}
+
 TEST_CASE("Recursive function in always_comb driver check") {
     auto tree = SyntaxTree::fromText(R"(
 module top;
@@ -1,5 +1,10 @@
 #include "Test.h"
 
+#include <fstream>
+
+#include "slang/syntax/SyntaxPrinter.h"
+#include "slang/syntax/SyntaxTreeCache.h"
+
 std::string getTestInclude() {
     return findTestDir() + "/include.svh";
 }
@@ -68,3 +73,157 @@ TEST_CASE("Read header (include dirs)") {
     buffer = manager.readHeader("../infinite_chain.svh", SourceLocation(buffer.id, 0), false);
     CHECK(buffer);
 }
+
+TEST_CASE("Release removed files") {
+    auto dir = fs::temp_directory_path() / "slang_release_files_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    auto path = dir / "file.sv";
+    auto writeFile = [&](string_view text) {
+        std::ofstream file(path);
+        file << text;
+    };
+
+    SourceManager manager;
+    writeFile("module a; endmodule\n");
+    auto oldBuffer = manager.readSource(path);
+    REQUIRE(oldBuffer);
+
+    // Nothing has been removed yet.
+    CHECK(manager.releaseRemovedFiles() == 0);
+
+    writeFile("module b; endmodule\n");
+    CHECK(manager.removeCachedFile(path));
+    auto newBuffer = manager.readSource(path);
+    REQUIRE(newBuffer);
+
+    // The old buffer stays valid until its file gets released.
+    CHECK(manager.getSourceText(oldBuffer.id).substr(0, 8) == "module a");
+    CHECK(manager.getAllBuffers().size() == 2);
+
+    CHECK(manager.releaseRemovedFiles() == 1);
+    CHECK(manager.getSourceText(oldBuffer.id).empty());
+    CHECK(manager.getFileName(SourceLocation(oldBuffer.id, 0)).empty());
+    CHECK(manager.getSourceText(newBuffer.id).substr(0, 8) == "module b");
+
+    auto buffers = manager.getAllBuffers();
+    REQUIRE(buffers.size() == 1);
+    CHECK(buffers[0] == newBuffer.id);
+
+    CHECK(manager.releaseRemovedFiles() == 0);
+    fs::remove_all(dir);
+}
+
+TEST_CASE("Syntax tree cache") {
+    auto dir = fs::temp_directory_path() / "slang_syntax_cache_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    auto writeInclude = [&](string_view text) {
+        std::ofstream file(dir / "cache_inc.svh");
+        file << text;
+    };
+
+    SyntaxTreeCache cache((dir / "cache").string());
+
+    PreprocessorOptions ppOptions;
+    ppOptions.predefines.push_back("WIDTH=8");
+
+    Bag options;
+    options.set(ppOptions);
+    options.set(SyntaxCacheOptions{ &cache });
+
+    auto text = R"(
+`include "cache_inc.svh"
+`define ADD(a, b) a + b
+`timescale 1ns/1ps
+module m #(parameter int P = `WIDTH) (input logic [P-1:0] a, output logic [P-1:0] b);
+    // comment
+    assign b = `ADD(a, 8'h3) + COUNT;
+    initial #1.5ns $display("%d\n", 'x, 3.25, `__LINE__);
+endmodule
+
+module top;
+    logic [7:0] a, b;
+    m #(.P(8)) m1(.a, .b);
+endmodule
+)";
+
+    auto parse = [&](SourceManager& sourceManager) {
+        sourceManager.addUserDirectory(dir.string());
+        auto buffer = sourceManager.assignText("cached.sv", text);
+        return SyntaxTree::fromBuffer(buffer, sourceManager, options);
+    };
+
+    writeInclude("localparam int COUNT = 4;\n");
+
+    SourceManager sm1;
+    auto tree1 = parse(sm1);
+    CHECK(tree1->diagnostics().empty());
+    CHECK(cache.getNumHits() == 0);
+    CHECK(cache.getNumMisses() == 1);
+
+    SourceManager sm2;
+    auto tree2 = parse(sm2);
+    CHECK(cache.getNumHits() == 1);
+    CHECK(cache.getNumMisses() == 1);
+
+    CHECK(SyntaxPrinter::printFile(*tree2) == SyntaxPrinter::printFile(*tree1));
+    CHECK(tree2->getMetadata().nodeMap.size() == tree1->getMetadata().nodeMap.size());
+    CHECK(tree2->getMetadata().globalInstances.size() == 1);
+
+    // Locations in the loaded tree should resolve through the new source manager.
+    auto& assign = tree2->root()
+                       .as<CompilationUnitSyntax>()
+                       .members[1]
+                       ->as<ModuleDeclarationSyntax>()
+                       .members[0]
+                       ->as<ContinuousAssignSyntax>();
+    auto& rhs =
+        assign.assignments[0]->as<BinaryExpressionSyntax>().right->as<BinaryExpressionSyntax>();
+    auto count = rhs.right->getFirstToken();
+    CHECK(count.valueText() == "COUNT");
+    CHECK(sm2.getLineNumber(count.location()) == 7);
+
+    auto addLoc = rhs.left->as<BinaryExpressionSyntax>().operatorToken.location();
+    CHECK(sm2.isMacroLoc(addLoc));
+    CHECK(sm2.getMacroName(addLoc) == "ADD");
+
+    Compilation compilation;
+    compilation.addSyntaxTree(tree2);
+    NO_COMPILATION_ERRORS;
+
+    auto& unit = *compilation.getRoot().compilationUnits[0];
+    CHECK(unit.find<ParameterSymbol>("COUNT").getValue().integer() == 4);
+
+    auto& top = *compilation.getRoot().topInstances[0];
+    CHECK(top.name == "top");
+
+    auto& m1 = top.body.find<InstanceSymbol>("m1");
+    CHECK(m1.body.getTimeScale().base.unit == TimeUnit::Nanoseconds);
+
+    // Changing the included file should invalidate the entry.
+    writeInclude("localparam int COUNT = 5;\n");
+
+    SourceManager sm3;
+    auto tree3 = parse(sm3);
+    CHECK(cache.getNumMisses() == 2);
+    auto countDecl = tree3->root().as<CompilationUnitSyntax>().members[0]->toString();
+    CHECK(countDecl.find("COUNT = 5") != std::string::npos);
+
+    SourceManager sm4;
+    auto tree4 = parse(sm4);
+    CHECK(cache.getNumHits() == 2);
+    CHECK(SyntaxPrinter::printFile(*tree4) == SyntaxPrinter::printFile(*tree3));
+
+    // As should changing the predefined macros.
+    ppOptions.predefines[0] = "WIDTH=16";
+    options.set(ppOptions);
+
+    SourceManager sm5;
+    parse(sm5);
+    CHECK(cache.getNumMisses() == 3);
+
+    fs::remove_all(dir);
+}
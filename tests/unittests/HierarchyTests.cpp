@@ -1,5 +1,7 @@
 #include "Test.h"
 
+#include "slang/compilation/DependencyGraph.h"
+
 TEST_CASE("Finding top level") {
     auto file1 = SyntaxTree::fromText(
         "module A; endmodule\nmodule B; A a(); endmodule\nmodule C; endmodule");
@@ -1693,3 +1695,255 @@ module m(I i);
            ^
 )");
 }
+
+TEST_CASE("Replacing a syntax tree reuses diagnostics") {
+    std::string text = R"(
+module top;
+    leaf l1();
+    other #(1) o1();
+    other #(2) o2();
+endmodule
+
+module leaf;
+    int i = foo;
+endmodule
+)";
+
+    auto tree1 = SyntaxTree::fromText(text);
+    auto tree2 = SyntaxTree::fromText(R"(
+module other #(parameter int P = 1);
+    if (P == 2) begin : g
+        int j = bar;
+    end
+
+    logic [3:0] a, b, c;
+    assign a = b & c;
+    always_comb b = a | c;
+endmodule
+)");
+
+    // Counters are collected so we can tell how much checking was skipped.
+    CompilationOptions coptions;
+    coptions.collectStats = true;
+
+    Bag options;
+    options.set(coptions);
+
+    Compilation compilation(options);
+    compilation.addSyntaxTree(tree1);
+    compilation.addSyntaxTree(tree2);
+    CHECK(compilation.getAllDiagnostics().size() == 2);
+
+    size_t offset = text.find("foo");
+    BufferID buffer = tree1->getEOFToken().location().buffer();
+    SourceRange range(SourceLocation(buffer, offset), SourceLocation(buffer, offset + 3));
+
+    auto newTree = SyntaxTree::reparse(*tree1, range, "1");
+    text.replace(offset, 3, "1");
+
+    // Only the first tree's elements should need to be checked again.
+    auto& graph = compilation.getDependencyGraph();
+    std::vector<const DependencyGraph::Element*> changed;
+    for (auto& elem : graph.getElements(*tree1)) {
+        if (elem.name == "leaf")
+            changed.push_back(&elem);
+    }
+
+    REQUIRE(changed.size() == 1);
+    auto affected = graph.getAffected(changed);
+    CHECK(affected.size() == 2);
+    for (auto elem : affected)
+        CHECK(elem->tree == tree1.get());
+
+    auto newCompilation = compilation.replaceSyntaxTreeReusingDiagnostics(*tree1, newTree);
+
+    Compilation expected(options);
+    expected.addSyntaxTree(SyntaxTree::fromText(text));
+    expected.addSyntaxTree(tree2);
+
+    auto& diags = newCompilation->getAllDiagnostics();
+    REQUIRE(diags.size() == 1);
+    CHECK(diags[0].code == diag::UndeclaredIdentifier);
+    CHECK(report(diags) == report(expected.getAllDiagnostics()));
+
+    // The contents of the two instances of "other" didn't need to be checked again,
+    // so getting there took fewer lookups than compiling from scratch.
+    auto counters = newCompilation->getElaborationCounters();
+    auto expectedCounters = expected.getElaborationCounters();
+    CHECK(counters.lookups > 0);
+    CHECK(counters.lookups < expectedCounters.lookups);
+    CHECK(newCompilation->getNumReusedElements() == 1);
+
+    // Replacing a tree again before checking the intermediate compilation passes along
+    // the diagnostics it carried over for the elements that are still unaffected.
+    offset = text.find("i = 1");
+    buffer = newTree->getEOFToken().location().buffer();
+    range = SourceRange(SourceLocation(buffer, offset + 4), SourceLocation(buffer, offset + 5));
+
+    auto newerTree = SyntaxTree::reparse(*newTree, range, "2");
+    text.replace(offset + 4, 1, "2");
+
+    auto unchecked = compilation.replaceSyntaxTreeReusingDiagnostics(*tree1, newTree);
+    auto chained = unchecked->replaceSyntaxTreeReusingDiagnostics(*newTree, newerTree);
+    CHECK(chained->getNumReusedElements() == 1);
+
+    Compilation expectedChained(options);
+    expectedChained.addSyntaxTree(SyntaxTree::fromText(text));
+    expectedChained.addSyntaxTree(tree2);
+
+    auto& chainedDiags = chained->getAllDiagnostics();
+    REQUIRE(chainedDiags.size() == 1);
+    CHECK(report(chainedDiags) == report(expectedChained.getAllDiagnostics()));
+    CHECK(chained->getElaborationCounters().lookups <
+          expectedChained.getElaborationCounters().lookups);
+
+    // A compilation that was never checked has nothing to pass along.
+    Compilation fresh(options);
+    fresh.addSyntaxTree(tree1);
+    fresh.addSyntaxTree(tree2);
+    CHECK(fresh.replaceSyntaxTreeReusingDiagnostics(*tree1, newTree)->getNumReusedElements() ==
+          0);
+}
+
+TEST_CASE("Replacing several syntax trees at once") {
+    auto top = SyntaxTree::fromText(R"(
+module top;
+    a a1();
+    b b1();
+    c c1();
+endmodule
+)");
+    auto a = SyntaxTree::fromText("module a; int i = foo; endmodule");
+    auto b = SyntaxTree::fromText("module b; int i = 1; endmodule");
+    auto c = SyntaxTree::fromText("module c; int i = baz; endmodule");
+
+    Compilation compilation;
+    for (auto& tree : { top, a, b, c })
+        compilation.addSyntaxTree(tree);
+    CHECK(compilation.getAllDiagnostics().size() == 2);
+
+    auto newA = SyntaxTree::fromText("module a; int i = 1; endmodule");
+    auto newB = SyntaxTree::fromText("module b; int i = bar; endmodule");
+
+    std::vector<Compilation::TreeReplacement> replacements;
+    replacements.emplace_back(a.get(), newA);
+    replacements.emplace_back(b.get(), newB);
+    auto newCompilation = compilation.replaceSyntaxTreesReusingDiagnostics(replacements);
+
+    // Only "c" is unaffected by both changes.
+    CHECK(newCompilation->getNumReusedElements() == 1);
+
+    Compilation expected;
+    for (auto& tree : { top, newA, newB, c })
+        expected.addSyntaxTree(tree);
+
+    auto& diags = newCompilation->getAllDiagnostics();
+    CHECK(diags.size() == 2);
+    CHECK(report(diags) == report(expected.getAllDiagnostics()));
+
+    replacements.emplace_back(a.get(), newA);
+    CHECK_THROWS(compilation.replaceSyntaxTreesReusingDiagnostics(replacements));
+    CHECK_THROWS(compilation.replaceSyntaxTreeReusingDiagnostics(*newA, a));
+}
+
+TEST_CASE("Dependency graph for packages") {
+    auto tree = SyntaxTree::fromText(R"(
+package p;
+    localparam int W = 4;
+endpackage
+
+module m;
+    import p::*;
+    child #(W) c();
+endmodule
+
+module child #(parameter int N = 1);
+    grandchild g();
+endmodule
+
+module grandchild;
+endmodule
+
+module unrelated;
+endmodule
+)");
+
+    DependencyGraph graph;
+    graph.addTree(*tree);
+
+    auto elements = graph.getElements(*tree);
+    REQUIRE(elements.size() == 6);
+    CHECK(elements.back().isCompilationUnit());
+
+    std::vector<const DependencyGraph::Element*> changed{ &elements[0] };
+    CHECK(changed[0]->name == "p");
+
+    // The package feeds a parameter value into the hierarchy below
+    // the module that imports it, so all of that is affected.
+    auto affected = graph.getAffected(changed);
+    CHECK(affected.size() == 4);
+    for (auto elem : affected)
+        CHECK(elem->name != "unrelated");
+
+    // Changing a leaf only affects the things that use it.
+    changed = { &elements[3] };
+    CHECK(changed[0]->name == "grandchild");
+
+    affected = graph.getAffected(changed);
+    CHECK(affected.size() == 3);
+    CHECK(affected.find(&elements[0]) == affected.end());
+}
+
+TEST_CASE("Elaboration statistics") {
+    auto tree = SyntaxTree::fromText(R"(
+module leaf #(parameter int W = 1);
+    function automatic int f(int n);
+        int s = 0;
+        for (int i = 0; i < n; i++) s += i;
+        return s;
+    endfunction
+
+    localparam int P = f(W * 10);
+    logic [W-1:0] data;
+endmodule
+
+module top;
+    leaf #(1) a();
+    leaf #(2) b();
+endmodule
+)");
+
+    CompilationOptions coptions;
+    coptions.collectStats = true;
+
+    Bag options;
+    options.set(coptions);
+
+    Compilation compilation(options);
+    compilation.addSyntaxTree(tree);
+    NO_COMPILATION_ERRORS;
+
+    auto counters = compilation.getElaborationCounters();
+    CHECK(counters.lookups > 0);
+    CHECK(counters.typesCreated > 0);
+    CHECK(counters.evalSteps > 0);
+
+    auto& root = compilation.getRoot();
+    auto& leaf = root.lookupName<InstanceSymbol>("top.a").getDefinition();
+    auto leafStats = compilation.getDefinitionStats(leaf);
+    REQUIRE(leafStats);
+    CHECK(leafStats->bytesAllocated > 0);
+    CHECK(leafStats->constEvalTime.count() > 0);
+
+    auto& top = root.topInstances[0]->getDefinition();
+    CHECK(compilation.getDefinitionStats(top));
+
+    // Nothing gets counted unless it was asked for.
+    Compilation plain;
+    plain.addSyntaxTree(tree);
+    CHECK(plain.getAllDiagnostics().empty());
+    CHECK(plain.getElaborationCounters().lookups == 0);
+    CHECK(plain.getElaborationCounters().evalSteps == 0);
+    CHECK(!plain.getDefinitionStats(
+        plain.getRoot().lookupName<InstanceSymbol>("top.a").getDefinition()));
+}
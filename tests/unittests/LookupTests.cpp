@@ -193,6 +193,74 @@ endmodule
     NO_COMPILATION_ERRORS;
 }
 
+TEST_CASE("Wildcard import lookup cache") {
+    auto tree = SyntaxTree::fromText(R"(
+package p1;
+    localparam int y = 1;
+endpackage
+
+package p2;
+    localparam int z = 2;
+endpackage
+
+module top;
+    import p1::*;
+    localparam int a = y;
+    if (1) begin : b
+        localparam int c = z;
+    end
+    import p2::*;
+    localparam int d = z;
+    localparam int e = z + y;
+    if (1) begin : b2
+        localparam int f = z + y;
+    end
+    import p3::*;
+    localparam int g = h;
+endmodule
+)");
+
+    Compilation compilation;
+    compilation.addSyntaxTree(tree);
+
+    auto& diags = compilation.getAllDiagnostics();
+    REQUIRE(diags.size() == 2);
+    CHECK(diags[0].code == diag::UndeclaredIdentifier);
+    CHECK(diags[1].code == diag::UnknownPackage);
+
+    auto& root = compilation.getRoot();
+    CHECK(root.lookupName<ParameterSymbol>("top.a").getValue().integer() == 1);
+    CHECK(root.lookupName<ParameterSymbol>("top.d").getValue().integer() == 2);
+    CHECK(root.lookupName<ParameterSymbol>("top.e").getValue().integer() == 3);
+    CHECK(root.lookupName<ParameterSymbol>("top.b2.f").getValue().integer() == 3);
+}
+
+TEST_CASE("Lookup through scopes without named members") {
+    auto tree = SyntaxTree::fromText(R"(
+module top;
+    int x;
+    initial begin : b1
+        begin : b2
+            x = 1;
+        end
+    end
+endmodule
+)");
+
+    Compilation compilation;
+    compilation.addSyntaxTree(tree);
+    NO_COMPILATION_ERRORS;
+
+    auto& root = compilation.getRoot();
+    auto x = root.lookupName("top.x");
+    REQUIRE(x);
+    auto& b2 = root.lookupName<StatementBlockSymbol>("top.b1.b2");
+    CHECK(b2.getNameMap().empty());
+    CHECK(!b2.find("x"));
+    CHECK(b2.lookupName("x") == x);
+    CHECK(root.lookupName<StatementBlockSymbol>("top.b1").find("b2") == &b2);
+}
+
 TEST_CASE("Package references") {
     auto tree = SyntaxTree::fromText(R"(
 package ComplexPkg;
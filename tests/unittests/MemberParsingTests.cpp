@@ -1,5 +1,7 @@
 #include "Test.h"
 
+#include "slang/syntax/SyntaxPrinter.h"
+
 TEST_CASE("Simple module") {
     auto& text = "module foo(); endmodule";
     const auto& module = parseModule(text);
@@ -970,3 +972,235 @@ endmodule
     parseCompilationUnit(text);
     CHECK_DIAGNOSTICS_EMPTY;
 }
+
+static void checkSameTree(const SyntaxNode& left, const SyntaxNode& right) {
+    REQUIRE(left.kind == right.kind);
+    REQUIRE(left.getChildCount() == right.getChildCount());
+
+    for (size_t i = 0; i < left.getChildCount(); i++) {
+        auto leftNode = left.childNode(i);
+        auto rightNode = right.childNode(i);
+        REQUIRE(!leftNode == !rightNode);
+
+        if (leftNode) {
+            // Children of lists have their parent pointers set to the list's owner.
+            auto parent = SyntaxListBase::isKind(left.kind) ? left.parent : &left;
+            CHECK(leftNode->parent == parent);
+            checkSameTree(*leftNode, *rightNode);
+        }
+        else {
+            // Either a token or an empty optional node.
+            Token lt = left.childToken(i);
+            Token rt = right.childToken(i);
+            REQUIRE(!lt == !rt);
+            if (!lt)
+                continue;
+
+            REQUIRE(lt.kind == rt.kind);
+            CHECK(lt.rawText() == rt.rawText());
+            CHECK(lt.isMissing() == rt.isMissing());
+            CHECK(lt.location().offset() == rt.location().offset());
+            CHECK(lt.trivia().size() == rt.trivia().size());
+        }
+    }
+}
+
+TEST_CASE("Incremental reparse") {
+    std::string text = R"(
+module a;
+    int i = 1;
+endmodule
+
+module b #(parameter int P = 2) (input logic clk);
+    a a1();
+    import pkg::*;
+endmodule
+
+module c;
+    string s = "hello";
+    logic [99:0] big = 100'hfffffffffffffffffffffff;
+endmodule
+)";
+
+    auto tree = SyntaxTree::fromText(text);
+    REQUIRE(tree->diagnostics().empty());
+
+    // Replaces the first occurrence of @a from with @a to and checks that the
+    // reparsed tree matches one parsed from scratch. If the caller hands over
+    // the only reference to the old tree, it should get updated in place unless
+    // its memory is due to be compacted.
+    auto edit = [&](std::shared_ptr<SyntaxTree> oldTree, string_view from, string_view to,
+                    bool incremental = true, bool compact = false) {
+        size_t offset = text.find(from);
+        REQUIRE(offset != std::string::npos);
+
+        BufferID buffer = oldTree->getEOFToken().location().buffer();
+        SourceRange range(SourceLocation(buffer, offset),
+                          SourceLocation(buffer, offset + from.size()));
+
+        bool shared = oldTree.use_count() > 1;
+        auto result = SyntaxTree::reparse(std::move(oldTree), range, to);
+        text.replace(offset, from.size(), to);
+
+        auto& stats = result->getReparseStats();
+        REQUIRE(stats);
+        CHECK(stats->fullParse == !incremental);
+        if (incremental) {
+            CHECK(stats->reusedInPlace == (!shared && !compact));
+            CHECK(stats->membersParsed > 0);
+            CHECK(stats->bufferReused == (result->getEOFToken().location().buffer() == buffer));
+        }
+
+        // Parse without guessing, since a single module would otherwise
+        // not get wrapped in a compilation unit.
+        auto& sm = SyntaxTree::getDefaultSourceManager();
+        auto expected = SyntaxTree::fromBuffer(sm.assignText(text), sm);
+        CHECK(SyntaxPrinter(result->sourceManager())
+                  .setIncludeDirectives(true)
+                  .setIncludeSkipped(true)
+                  .setIncludePreprocessed(false)
+                  .setSquashNewlines(false)
+                  .print(*result)
+                  .str() == text);
+        checkSameTree(result->root(), expected->root());
+
+        auto& meta = result->getMetadata();
+        auto& expectedMeta = expected->getMetadata();
+        CHECK(meta.nodeMap.size() == expectedMeta.nodeMap.size());
+        CHECK(meta.globalInstances == expectedMeta.globalInstances);
+        CHECK(meta.packageImports.size() == expectedMeta.packageImports.size());
+        CHECK(meta.classPackageNames.size() == expectedMeta.classPackageNames.size());
+
+        REQUIRE(result->diagnostics().size() == expected->diagnostics().size());
+        for (size_t i = 0; i < result->diagnostics().size(); i++) {
+            auto& diag = result->diagnostics()[i];
+            auto& expectedDiag = expected->diagnostics()[i];
+            CHECK(diag.code == expectedDiag.code);
+            CHECK(diag.location.offset() == expectedDiag.location.offset());
+        }
+        return result;
+    };
+
+    // Simple edit within a single module. The module after it is reused as is.
+    const SyntaxNode* oldC = tree->root().as<CompilationUnitSyntax>().members[2];
+    auto tree2 = edit(std::move(tree), "P = 2", "P = 42");
+    CHECK(tree2->getReparseStats()->membersReused == 1);
+    CHECK(!tree2->getReparseStats()->bufferReused);
+
+    auto& members = tree2->root().as<CompilationUnitSyntax>().members;
+    REQUIRE(members.size() == 3);
+    CHECK(members[2] == oldC);
+
+    auto& sm = tree2->sourceManager();
+    auto last = members[2]->getLastToken();
+    CHECK(sm.getLineNumber(last.location()) == 14);
+    CHECK(sm.getFileName(last.location()) == "source");
+
+    auto& c = members[2]->as<ModuleDeclarationSyntax>();
+    auto& str = c.members[0]->as<DataDeclarationSyntax>().declarators[0]->initializer->expr;
+    CHECK(str->getFirstToken().valueText() == "hello");
+
+    auto& big = c.members[1]->as<DataDeclarationSyntax>().declarators[0]->initializer->expr;
+    CHECK(big->getFirstToken().kind == TokenKind::IntegerLiteral);
+    CHECK(big->getLastToken().intValue() == SVInt::fromString("100'hfffffffffffffffffffffff"));
+
+    // Removing an endmodule merges modules, which requires parsing past the edit.
+    // The old tree is still in use here, so the reused members get copied.
+    auto tree3 = edit(tree2, "endmodule\n\nmodule b", "\n\nmodule b");
+    CHECK(tree3->root().as<CompilationUnitSyntax>().members.size() == 1);
+    CHECK(!tree3->diagnostics().empty());
+    CHECK(tree2->root().as<CompilationUnitSyntax>().members.size() == 3);
+    tree2.reset();
+
+    // Putting it back fixes things up again.
+    auto tree4 = edit(std::move(tree3), "\n\nmodule b", "endmodule\n\nmodule b");
+    CHECK(tree4->diagnostics().empty());
+    CHECK(tree4->getReparseStats()->bufferReused);
+
+    // Editing at the very end of the file. The last edit reparsed everything into
+    // the old tree's memory, so this time the tree gets copied to reclaim it.
+    auto tree5 = edit(std::move(tree4), "fff;\nendmodule\n",
+                      "fff;\nendmodule\nmodule d; c c1(); endmodule\n", true, true);
+    CHECK(tree5->root().as<CompilationUnitSyntax>().members.size() == 4);
+    CHECK(tree5->getMetadata().globalInstances.count("c"));
+    CHECK(tree5->getReparseStats()->membersReused == 1);
+
+    // An edit before a module shifts everything after it.
+    auto tree6 = edit(std::move(tree5), "int i = 1;", "int i = 12345;");
+    CHECK(tree6->getReparseStats()->bufferReused);
+    CHECK(tree6->getMetadata().globalInstances.count("c"));
+    CHECK(tree6->getMetadata().globalInstances.count("a"));
+
+    // Edits that involve directives fall back to parsing the whole file.
+    auto tree7 = edit(std::move(tree6), "int i = 12345;", "int i = `FOO;", false);
+    CHECK(!tree7->diagnostics().empty());
+}
+
+TEST_CASE("Incremental reparse releases old buffers") {
+    SourceManager sourceManager;
+    std::string text = "module a;\n    int i = 1;\nendmodule\n\nmodule b;\n    a a1();\nendmodule\n";
+    auto tree = SyntaxTree::fromText(text, sourceManager);
+    BufferID original = tree->getEOFToken().location().buffer();
+
+    auto edit = [&](std::shared_ptr<SyntaxTree> oldTree, string_view from, string_view to) {
+        size_t offset = text.find(from);
+        REQUIRE(offset != std::string::npos);
+
+        BufferID buffer = oldTree->getEOFToken().location().buffer();
+        SourceRange range(SourceLocation(buffer, offset),
+                          SourceLocation(buffer, offset + from.size()));
+
+        auto result = SyntaxTree::reparse(std::move(oldTree), range, to);
+        text.replace(offset, from.size(), to);
+
+        CHECK(!result->getReparseStats()->fullParse);
+        CHECK(SyntaxPrinter(sourceManager)
+                  .setIncludeDirectives(true)
+                  .setIncludeSkipped(true)
+                  .setIncludePreprocessed(false)
+                  .setSquashNewlines(false)
+                  .print(*result)
+                  .str() == text);
+
+        // Everything after the edit should have been moved along with the text.
+        auto last = result->root().as<CompilationUnitSyntax>().members[1]->getLastToken();
+        CHECK(text.substr(last.location().offset(), 9) == "endmodule");
+        CHECK(sourceManager.getLineNumber(last.location()) ==
+              size_t(std::count(text.begin(), text.end(), '\n')));
+        CHECK(result->getMetadata().globalInstances.count("a"));
+        return result;
+    };
+
+    // The first edit moves the text into a buffer that belongs to the tree,
+    // along with a scratch buffer for parsing the edited region.
+    tree = edit(std::move(tree), "1;", "2;");
+    CHECK(!tree->getReparseStats()->bufferReused);
+    BufferID buffer = tree->getEOFToken().location().buffer();
+    CHECK(buffer != original);
+    CHECK(sourceManager.getAllBuffers().size() == 3);
+
+    // From then on the edits go straight into that buffer, even when it has
+    // to grow, and no new buffers get left behind.
+    std::string comment = "// " + std::string(1000, 'x') + "\n";
+    tree = edit(std::move(tree), "2;", "3;");
+    tree = edit(std::move(tree), "module b", comment + "module b");
+    tree = edit(std::move(tree), comment, "");
+    CHECK(tree->getReparseStats()->bufferReused);
+    CHECK(tree->getEOFToken().location().buffer() == buffer);
+    CHECK(sourceManager.getAllBuffers().size() == 3);
+
+    // Copying a tree that's still in use creates a new pair of buffers,
+    // which are released along with the copy.
+    auto copy = SyntaxTree::reparse(*tree, SourceRange(SourceLocation(buffer, 0),
+                                                       SourceLocation(buffer, 0)),
+                                    "\n");
+    CHECK(!copy->getReparseStats()->reusedInPlace);
+    CHECK(sourceManager.getAllBuffers().size() == 5);
+
+    copy.reset();
+    CHECK(sourceManager.getAllBuffers().size() == 3);
+
+    tree.reset();
+    CHECK(sourceManager.getAllBuffers().size() == 1);
+    CHECK(sourceManager.getSourceText(buffer).empty());
+}
@@ -4,6 +4,7 @@
 #include "slang/compilation/Definition.h"
 #include "slang/symbols/ASTSerializer.h"
 #include "slang/symbols/AttributeSymbol.h"
+#include "slang/symbols/BinaryASTWriter.h"
 #include "slang/text/Json.h"
 #include "slang/types/NetType.h"
 
@@ -403,6 +404,124 @@ endmodule
 })");
 }
 
+TEST_CASE("JSON dump -- streaming and compact output") {
+    auto tree = SyntaxTree::fromText(R"(
+module m #(parameter int P = 4);
+    logic [P-1:0] a, b;
+    assign a = b + 1;
+endmodule
+)");
+
+    Compilation compilation;
+    compilation.addSyntaxTree(tree);
+    NO_COMPILATION_ERRORS;
+
+    auto serialize = [&](JsonWriter& writer) {
+        ASTSerializer serializer(compilation, writer);
+        serializer.setIncludeAddresses(false);
+        serializer.serialize(compilation.getRoot());
+    };
+
+    JsonWriter buffered;
+    buffered.setPrettyPrint(true);
+    serialize(buffered);
+
+    std::string streamed;
+    JsonWriter writer;
+    writer.setPrettyPrint(true);
+    writer.setOutput([&](string_view text) { streamed += text; }, 16);
+    serialize(writer);
+    writer.flush();
+
+    CHECK(writer.view().empty());
+    CHECK(streamed == buffered.view());
+
+    JsonWriter compact;
+    serialize(compact);
+
+    std::string expected(buffered.view());
+    bool inString = false;
+    expected.erase(std::remove_if(expected.begin(), expected.end(),
+                                  [&](char c) {
+                                      if (c == '"')
+                                          inString = !inString;
+                                      return !inString && (c == ' ' || c == '\n');
+                                  }),
+                   expected.end());
+    CHECK(compact.view() == expected);
+}
+
+TEST_CASE("Binary AST dump") {
+    auto tree = SyntaxTree::fromText(R"(
+module child;
+    logic a, b;
+    assign a = b;
+endmodule
+
+module top;
+    child c1();
+    child c2();
+endmodule
+)");
+
+    Compilation compilation;
+    compilation.addSyntaxTree(tree);
+    NO_COMPILATION_ERRORS;
+
+    BinaryASTWriter writer;
+    ASTSerializer serializer(compilation, writer);
+    serializer.setIncludeAddresses(false);
+    serializer.serialize(compilation.getRoot());
+
+    std::string data;
+    writer.finish([&](string_view text) { data.append(text); });
+
+    // The format is little-endian no matter what the host is.
+    REQUIRE(data.size() > sizeof(BinaryAST::Header));
+    CHECK(data.substr(8, 4) == std::string("\x01\x00\x00\x00", 4));
+    CHECK(data.substr(16, 8) == std::string("\x30\x00\x00\x00\x00\x00\x00\x00", 8));
+
+    BinaryASTReader reader(span<const char>(data.data(), data.size()));
+    REQUIRE(reader.getNumRoots() == 1);
+
+    auto root = reader.getRoot(0);
+    REQUIRE(root.isObject());
+    CHECK(root.find("name")->getString() == "$root");
+    CHECK(root.find("kind")->getString() == "Root");
+    CHECK(!root.find("addr"));
+
+    REQUIRE(reader.getNumScopes() == 3);
+    CHECK(reader.getScopePath(0) == "top");
+    CHECK(reader.getScopePath(1) == "top.c1");
+    CHECK(reader.getScopePath(2) == "top.c2");
+    CHECK(!reader.findScope("top.c3"));
+
+    auto c2 = reader.findScope("top.c2");
+    REQUIRE(c2);
+    CHECK(c2->find("name")->getString() == "c2");
+
+    // Find the continuous assignment and follow the link from
+    // its right hand side back to the declaration of 'b'.
+    optional<BinaryASTValue> link;
+    auto body = c2->find("body");
+    REQUIRE(body);
+    body->find("members")->forEachElement([&](BinaryASTValue member) {
+        if (member.find("kind")->getString() == "ContinuousAssign")
+            link = member.find("assignment")->find("right")->find("symbol");
+    });
+
+    REQUIRE(link);
+    REQUIRE(link->isLink());
+    CHECK(link->getLinkText() == "b");
+
+    auto target = reader.findSymbol(link->getSymbolId());
+    REQUIRE(target);
+    CHECK(target->find("name")->getString() == "b");
+    CHECK(target->find("type")->getString() == "logic");
+
+    CHECK_THROWS(BinaryASTReader(span<const char>(data.data(), 16)));
+}
+
 TEST_CASE("Attributes") {
     auto tree = SyntaxTree::fromText(R"(
 module m;
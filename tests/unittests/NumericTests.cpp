@@ -639,6 +639,17 @@ TEST_CASE("SVInt misc functions") {
     CHECK("64'd1"_si.reverse() == 1ull << 63);
     CHECK_THAT("129'b1x10"_si.shl(125).reverse(), exactlyEquals("129'b1x1"_si));
     CHECK_THAT("128'b1x10"_si.shl(124).reverse(), exactlyEquals("128'b1x1"_si));
+
+    CHECK("32'h01020304"_si.reverseBlocks(8, 8) == "32'h04030201"_si);
+    CHECK("6'b110101"_si.reverseBlocks(4, 4) == "6'b010111"_si);
+    CHECK("12'habc"_si.reverseBlocks(8, 4) == "12'hcab"_si);
+    CHECK("12'habc"_si.reverseBlocks(16, 16) == "12'habc"_si);
+    CHECK("128'h0102030405060708090a0b0c0d0e0f10"_si.reverseBlocks(8, 8) ==
+          "128'h100f0e0d0c0b0a090807060504030201"_si);
+    CHECK("72'h010203040506070809"_si.reverseBlocks(8, 8) == "72'h090807060504030201"_si);
+    CHECK_THAT("12'hx3z"_si.reverseBlocks(4, 4), exactlyEquals("12'hz3x"_si));
+    CHECK_THAT("128'hx0000000000000000000000000000001"_si.reverseBlocks(8, 8),
+               exactlyEquals("128'h010000000000000000000000000000x0"_si));
 }
 
 TEST_CASE("Double conversions") {
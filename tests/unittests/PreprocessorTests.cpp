@@ -1879,3 +1879,90 @@ endmodule
     compilation.addSyntaxTree(tree);
     NO_COMPILATION_ERRORS;
 }
+
+TEST_CASE("Streaming preprocessor output") {
+    auto& text = R"(
+`define FOO(a) a + 1
+module m;
+
+
+    int i = `FOO(2);
+endmodule
+)";
+
+    diagnostics.clear();
+    Preprocessor preprocessor(getSourceManager(), alloc, diagnostics);
+    preprocessor.pushSource(text);
+
+    std::string streamed;
+    size_t chunks = 0;
+    SyntaxPrinter output;
+    output.setOutput(
+        [&](string_view chunk) {
+            streamed += chunk;
+            chunks++;
+        },
+        4);
+
+    SyntaxPrinter buffered;
+    while (true) {
+        Token token = preprocessor.next();
+        output.print(token);
+        buffered.print(token);
+        if (token.kind == TokenKind::EndOfFile)
+            break;
+    }
+
+    output.flush();
+    CHECK(output.str().empty());
+    CHECK(chunks > 1);
+    CHECK(streamed == buffered.str());
+    CHECK_DIAGNOSTICS_EMPTY;
+}
+
+TEST_CASE("Releasing preprocessor tokens") {
+    std::string text = R"(
+`define STR "some \"string\""
+`define BIG 128'hffffffff_ffffffff_ffffffff_ffffffff
+`define ADD(a, b = 1) (a) + (b) /* comment */
+`define MAKE(name) `define name(x) x * 2
+`MAKE(DOUBLE)
+)";
+    for (int i = 0; i < 200; i++)
+        text += "int i" + std::to_string(i) + " = `ADD(`DOUBLE(3)) + `BIG; string s = `STR;\n";
+
+    auto run = [&](BumpAllocator& tokenAlloc, bool release) {
+        diagnostics.clear();
+        Preprocessor preprocessor(getSourceManager(), tokenAlloc, diagnostics);
+        preprocessor.pushSource(text);
+
+        size_t released = 0;
+        size_t refused = 0;
+        SyntaxPrinter output;
+        while (true) {
+            Token token = preprocessor.next();
+            output.print(token);
+            if (token.kind == TokenKind::EndOfFile)
+                break;
+
+            if (release) {
+                if (preprocessor.releaseTokens())
+                    released++;
+                else
+                    refused++;
+            }
+        }
+
+        if (release) {
+            CHECK(released > 200);
+            CHECK(refused > 200);
+        }
+        return output.str();
+    };
+
+    BumpAllocator keptAlloc;
+    BumpAllocator releasedAlloc;
+    CHECK(run(releasedAlloc, true) == run(keptAlloc, false));
+    CHECK(releasedAlloc.getBytesAllocated() * 10 < keptAlloc.getBytesAllocated());
+    CHECK_DIAGNOSTICS_EMPTY;
+}
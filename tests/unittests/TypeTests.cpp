@@ -437,6 +437,40 @@ endmodule
     NO_COMPILATION_ERRORS;
 }
 
+TEST_CASE("Array types are uniquified") {
+    auto tree = SyntaxTree::fromText(R"(
+module Top;
+    logic [3:0][1:0] a;
+    logic [3:0][1:0] b;
+    logic signed [3:0][1:0] c;
+    int d[4];
+    int e[4];
+    int f[0:3];
+    logic [3:0] g;
+
+    localparam logic [7:0] p = 0;
+    localparam q = p[3:0];
+    localparam int r[4] = '{1, 2, 3, 4};
+    localparam s = r[0:3];
+endmodule
+)");
+
+    Compilation compilation;
+    const auto& instance = evalModule(tree, compilation).body;
+
+    auto typeOf = [&](string_view name) { return &instance.find<ValueSymbol>(name).getType(); };
+    CHECK(typeOf("a") == typeOf("b"));
+    CHECK(typeOf("a") != typeOf("c"));
+    CHECK(typeOf("d") == typeOf("e"));
+    CHECK(typeOf("d") == typeOf("f"));
+
+    // Range selects produce the same types as declarations.
+    CHECK(typeOf("q") == typeOf("g"));
+    CHECK(typeOf("s") == typeOf("d"));
+
+    NO_COMPILATION_ERRORS;
+}
+
 TEST_CASE("Unpacked array ports") {
     auto tree = SyntaxTree::fromText(R"(
 module Top(logic f[3], g, h[0:1]);
@@ -596,6 +630,62 @@ source:11:15: error: value of type 'test2' (aka 'unpacked array [3] of logic[3:0
 )");
 }
 
+TEST_CASE("Type relation cache") {
+    auto tree = SyntaxTree::fromText(R"(
+interface I; endinterface
+
+module m;
+    typedef enum { A, B } e_t;
+    typedef struct { int a; e_t b; } s_t;
+
+    class Base; endclass
+    class Derived extends Base; endclass
+
+    I i();
+    virtual I vi1 = i;
+    virtual I vi2 = vi1;
+
+    e_t e1, e2;
+    s_t s1, s2;
+    Base b1, b2;
+    Derived d1;
+    int x;
+
+    initial begin
+        e1 = e2;
+        e2 = e1;
+        s1 = s2;
+        s2 = s1;
+        b1 = d1;
+        b2 = d1;
+        vi1 = vi2;
+        vi2 = vi1;
+        e1 = x;
+        e2 = x;
+    end
+endmodule
+)");
+
+    Compilation compilation;
+    compilation.addSyntaxTree(tree);
+
+    auto& diags = compilation.getAllDiagnostics();
+    REQUIRE(diags.size() == 2);
+    CHECK(diags[0].code == diag::NoImplicitConversion);
+    CHECK(diags[1].code == diag::NoImplicitConversion);
+
+    auto stats = compilation.getTypeRelationStats();
+    CHECK(stats.hits > 0);
+    CHECK(stats.misses > 0);
+
+    auto& root = compilation.getRoot();
+    auto& b1 = root.lookupName<VariableSymbol>("m.b1").getType();
+    auto& d1 = root.lookupName<VariableSymbol>("m.d1").getType();
+    CHECK(b1.isAssignmentCompatible(d1));
+    CHECK(!d1.isAssignmentCompatible(b1));
+    CHECK(!b1.isMatching(d1));
+}
+
 TEST_CASE("Type matching") {
     std::vector<std::shared_ptr<SyntaxTree>> savedTrees;
 
@@ -1,6 +1,9 @@
 #include "Test.h"
 
+#include "slang/text/Json.h"
+#include "slang/util/BumpAllocator.h"
 #include "slang/util/CommandLine.h"
+#include "slang/util/ThreadPool.h"
 
 TEST_CASE("Test CommandLine -- basic") {
     optional<bool> a, b, longFlag, longFlag2;
@@ -417,3 +420,116 @@ TEST_CASE("Test CommandLine -- ignore duplicates") {
 
     CHECK(foo == 123);
 }
+
+TEST_CASE("JSON parsing") {
+    auto value = JsonValue::parse(R"(
+{
+    "jsonrpc": "2.0", "id": 12, "method": "compile",
+    "params": { "files": ["a.sv", "b\u00e9\n.sv"], "quiet": true, "limit": -1.5e2, "x": null },
+    "empty": [], "obj": {}
+}
+)");
+
+    REQUIRE(value.isObject());
+    CHECK(value.getObject().size() == 6);
+    CHECK(value.find("jsonrpc")->getString() == "2.0");
+    CHECK(value.find("id")->getNumber() == 12);
+    CHECK(value.find("missing") == nullptr);
+
+    auto params = value.find("params");
+    REQUIRE(params);
+    auto& files = params->find("files")->getArray();
+    REQUIRE(files.size() == 2);
+    CHECK(files[0].getString() == "a.sv");
+    CHECK(files[1].getString() == "b\xc3\xa9\n.sv");
+    CHECK(params->find("quiet")->getBoolean());
+    CHECK(params->find("limit")->getNumber() == -150.0);
+    CHECK(params->find("x")->isNull());
+    CHECK(value.find("empty")->getArray().empty());
+    CHECK(value.find("obj")->getObject().empty());
+
+    JsonWriter writer;
+    params->write(writer);
+    CHECK(writer.view() ==
+          "{\"files\":[\"a.sv\",\"b\xc3\xa9\\n.sv\"],\"quiet\":true,\"limit\":-150,\"x\":null}"sv);
+    CHECK(JsonValue::parse(writer.view()).find("files")->getArray()[1].getString() ==
+          "b\xc3\xa9\n.sv");
+
+    CHECK_THROWS_AS(JsonValue::parse("{"), std::runtime_error);
+    CHECK_THROWS_AS(JsonValue::parse("[1,]"), std::runtime_error);
+    CHECK_THROWS_AS(JsonValue::parse("tru"), std::runtime_error);
+    CHECK_THROWS_AS(JsonValue::parse("\"abc"), std::runtime_error);
+    CHECK_THROWS_AS(JsonValue::parse("\"\\q\""), std::runtime_error);
+    CHECK_THROWS_AS(JsonValue::parse("1 2"), std::runtime_error);
+    CHECK_THROWS_AS(JsonValue::parse(std::string(1000, '[')), std::runtime_error);
+}
+
+TEST_CASE("ThreadPool runs nested tasks") {
+    for (uint32_t threads : { 0u, 3u }) {
+        ThreadPool pool(threads);
+        std::atomic<int> count = 0;
+        std::function<void(int)> spawn = [&](int depth) {
+            count++;
+            if (depth < 6) {
+                pool.push([&, depth] { spawn(depth + 1); });
+                pool.push([&, depth] { spawn(depth + 1); });
+            }
+        };
+
+        pool.push([&] { spawn(0); });
+        pool.waitForAll();
+        CHECK(count == 127);
+
+        // Exceptions are passed along to the waiting thread, and the pool stays usable.
+        pool.push([] { throw std::runtime_error("oops"); });
+        pool.push([&] { count++; });
+        CHECK_THROWS_AS(pool.waitForAll(), std::runtime_error);
+        CHECK(count == 128);
+
+        pool.push([&] { count++; });
+        pool.waitForAll();
+        CHECK(count == 129);
+    }
+}
+
+TEST_CASE("BumpAllocator segment reuse and stats") {
+    BumpAllocator alloc;
+    for (int i = 0; i < 10000; i++)
+        *(uint64_t*)alloc.allocate(sizeof(uint64_t), alignof(uint64_t)) = uint64_t(i);
+
+    byte* big = alloc.allocate(1 << 20, 16);
+    memset(big, 0, 1 << 20);
+
+    auto stats = alloc.getStats();
+    CHECK(stats.bytesAllocated >= 10000 * sizeof(uint64_t) + (1 << 20));
+    CHECK(alloc.getBytesAllocated() == stats.bytesAllocated);
+    CHECK(stats.bytesReserved > stats.bytesAllocated);
+    CHECK(stats.bytesWasted < stats.bytesReserved - stats.bytesAllocated);
+
+    // Segments grow geometrically, so there should be far fewer
+    // of them than fixed size segments would need.
+    CHECK(stats.segmentCount < 10);
+
+    // The large allocation's segment goes away; everything else stays.
+    alloc.reset();
+    auto afterReset = alloc.getStats();
+    CHECK(afterReset.bytesAllocated == 0);
+    CHECK(alloc.getBytesAllocated() == 0);
+    CHECK(afterReset.bytesWasted == 0);
+    CHECK(afterReset.segmentCount == stats.segmentCount - 1);
+    CHECK(afterReset.bytesReserved < stats.bytesReserved);
+
+    // Doing the same small allocations again shouldn't need any new memory.
+    for (int i = 0; i < 10000; i++)
+        *(uint64_t*)alloc.allocate(sizeof(uint64_t), alignof(uint64_t)) = uint64_t(i);
+
+    auto reused = alloc.getStats();
+    CHECK(reused.bytesReserved == afterReset.bytesReserved);
+    CHECK(reused.segmentCount == afterReset.segmentCount);
+    CHECK(alloc.getBytesAllocated() == reused.bytesAllocated);
+
+    BumpAllocator::Stats total;
+    total += stats;
+    total += reused;
+    CHECK(total.segmentCount == stats.segmentCount + reused.segmentCount);
+}
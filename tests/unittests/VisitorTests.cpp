@@ -3,8 +3,10 @@
 
 #include "slang/compilation/SemanticModel.h"
 #include "slang/symbols/ASTVisitor.h"
+#include "slang/symbols/ParallelASTVisitor.h"
 #include "slang/syntax/SyntaxPrinter.h"
 #include "slang/syntax/SyntaxVisitor.h"
+#include "slang/text/Json.h"
 
 class TestRewriter : public SyntaxRewriter<TestRewriter> {
 public:
@@ -153,3 +155,276 @@ endmodule
     compilation.getRoot().visit(visitor);
     CHECK(visitor.count == 11);
 }
+
+TEST_CASE("SemanticModel symbol index") {
+    auto tree = SyntaxTree::fromText(R"(
+module m;
+    int count;
+    function int inc(int x);
+        return x + 1;
+    endfunction
+    always_comb count = inc(count);
+endmodule
+
+module top;
+    m m1();
+    m m2();
+    int total = m1.count + m2.count;
+endmodule
+)");
+
+    Compilation compilation;
+    compilation.addSyntaxTree(tree);
+    NO_COMPILATION_ERRORS;
+
+    auto& sm = *compilation.getSourceManager();
+    auto text = sm.getSourceText(tree->root().getFirstToken().location().buffer());
+    auto locOf = [&](string_view needle, size_t skip = 0) {
+        size_t offset = text.find(needle);
+        for (size_t i = 0; i < skip; i++)
+            offset = text.find(needle, offset + 1);
+        REQUIRE(offset != std::string::npos);
+        return SourceLocation(tree->root().getFirstToken().location().buffer(), offset);
+    };
+
+    SemanticModel model(compilation);
+
+    // Declarations and references both resolve to the declared symbol.
+    auto count = model.getSymbolAt(locOf("count;") + 2);
+    REQUIRE(count);
+    CHECK(count->kind == SymbolKind::Variable);
+    CHECK(model.getSymbolAt(locOf("count = inc")) == count);
+    CHECK(model.getSymbolAt(locOf("count);")) == count);
+
+    auto inc = model.getSymbolAt(locOf("inc(count)") + 1);
+    REQUIRE(inc);
+    CHECK(inc->kind == SymbolKind::Subroutine);
+    CHECK(model.getSymbolAt(locOf("inc(int")) == inc);
+    CHECK(model.getReferences(*inc).size() == 1);
+
+    // Nothing is declared or referenced inside the keyword or whitespace.
+    CHECK(!model.getSymbolAt(locOf("module m;") + 1));
+    CHECK(!model.getSymbolAt(locOf("    int count") + 1));
+
+    // Each instance has its own variable; the references in the
+    // instance body and the hierarchical one are all found.
+    CHECK(model.getReferences(*count).size() == 3);
+    auto m2Count = model.getSymbolAt(locOf("m2.count"));
+    REQUIRE(m2Count);
+    CHECK(m2Count != count);
+    CHECK(model.getReferences(*m2Count).size() == 3);
+
+    JsonWriter writer;
+    model.serializeIndex(writer);
+    auto json = JsonValue::parse(writer.view());
+    CHECK(json.find("locations")->getArray().size() > 10);
+    CHECK(json.find("references")->getArray().size() >= 4);
+
+    // Locations come out in source order.
+    double prevLine = 0;
+    for (auto& entry : json.find("locations")->getArray()) {
+        auto line = entry.find("line")->getNumber();
+        CHECK(line >= prevLine);
+        prevLine = line;
+    }
+
+    // The output doesn't depend on where things ended up in memory.
+    Compilation compilation2;
+    compilation2.addSyntaxTree(tree);
+    SemanticModel model2(compilation2);
+
+    JsonWriter writer2;
+    model2.serializeIndex(writer2);
+    CHECK(writer.view() == writer2.view());
+}
+
+struct CountingVisitor : public ParallelASTVisitorBase<CountingVisitor, true, true> {
+    size_t statements = 0;
+    size_t bodies = 0;
+    size_t blocks = 0;
+
+    template<typename T>
+    void handle(const T& t) {
+        if constexpr (std::is_base_of_v<Statement, T>)
+            statements++;
+        else if constexpr (std::is_same_v<InstanceBodySymbol, T>)
+            bodies++;
+        else if constexpr (std::is_same_v<GenerateBlockSymbol, T>)
+            blocks++;
+        visitDefault(t);
+    }
+};
+
+TEST_CASE("Parallel AST visiting") {
+    auto tree = SyntaxTree::fromText(R"(
+module leaf #(parameter int N = 1);
+    int j;
+    initial begin
+        j = N;
+        if (N > 2) j++;
+    end
+endmodule
+
+module mid #(parameter int D = 3);
+    for (genvar i = 0; i < 4; i++) begin : g
+        leaf #(i) l();
+        if (i % 2 == 0) begin : even
+            leaf #(i * 2) l2();
+        end
+    end
+    if (D > 0) begin : deeper
+        mid #(D - 1) m();
+    end
+endmodule
+
+module top;
+    mid m1();
+    mid #(1) m2();
+endmodule
+)");
+
+    Compilation compilation;
+    compilation.addSyntaxTree(tree);
+    NO_COMPILATION_ERRORS;
+    CHECK(compilation.isFullyElaborated());
+
+    CountingVisitor sequential;
+    compilation.getRoot().visit(sequential);
+    CHECK(sequential.bodies > 20);
+
+    for (uint32_t threads : { 0u, 1u, 4u }) {
+        ThreadPool pool(threads);
+        ParallelASTVisitor<CountingVisitor> parallel(pool);
+        parallel.visit(compilation);
+
+        CountingVisitor total;
+        size_t used = 0;
+        parallel.reduce([&](CountingVisitor& v) {
+            total.statements += v.statements;
+            total.bodies += v.bodies;
+            total.blocks += v.blocks;
+            used++;
+        });
+
+        CHECK(used == threads + 1);
+        CHECK(total.statements == sequential.statements);
+        CHECK(total.bodies == sequential.bodies);
+        CHECK(total.blocks == sequential.blocks);
+    }
+}
+
+struct RelationVisitor : public ParallelASTVisitorBase<RelationVisitor, false, false> {
+    const Type* target;
+    size_t variables = 0;
+    size_t equivalent = 0;
+
+    explicit RelationVisitor(const Type* target) : target(target) {}
+
+    void handle(const VariableSymbol& symbol) {
+        variables++;
+        if (symbol.getType().isEquivalent(*target))
+            equivalent++;
+    }
+};
+
+TEST_CASE("Parallel AST visiting with type relations") {
+    auto tree = SyntaxTree::fromText(R"(
+package p;
+    typedef struct packed { logic [3:0] a; logic b; } s1_t;
+    typedef struct packed { logic [3:0] a; logic b; } s2_t;
+    typedef enum { A, B } e_t;
+endpackage
+
+module leaf #(parameter int N = 1);
+    p::s1_t s1;
+    p::s2_t s2;
+    p::e_t e;
+    logic [4:0] v;
+endmodule
+
+module top;
+    for (genvar i = 0; i < 16; i++) begin : g
+        leaf #(i) l();
+    end
+endmodule
+)");
+
+    Compilation compilation;
+    compilation.addSyntaxTree(tree);
+    NO_COMPILATION_ERRORS;
+
+    auto& target = compilation.getRoot().lookupName<VariableSymbol>("top.g[0].l.s1").getType();
+
+    RelationVisitor sequential(&target);
+    compilation.getRoot().visit(sequential);
+    CHECK(sequential.variables == 64);
+    CHECK(sequential.equivalent == 48);
+
+    ThreadPool pool(4);
+    ParallelASTVisitor<RelationVisitor> parallel(pool, &target);
+    parallel.visit(compilation);
+
+    size_t variables = 0;
+    size_t equivalent = 0;
+    parallel.reduce([&](RelationVisitor& v) {
+        variables += v.variables;
+        equivalent += v.equivalent;
+    });
+
+    CHECK(variables == sequential.variables);
+    CHECK(equivalent == sequential.equivalent);
+    CHECK(compilation.getTypeRelationStats().hits > 0);
+}
+
+TEST_CASE("Parallel AST visiting past the error limit") {
+    auto tree = SyntaxTree::fromText(R"(
+module leaf #(parameter int N = 1);
+    int j = missing1;
+    initial begin
+        j = N + missing2;
+    end
+endmodule
+
+module top;
+    for (genvar i = 0; i < 8; i++) begin : g
+        leaf #(i) l();
+    end
+endmodule
+)");
+
+    CompilationOptions options;
+    options.errorLimit = 1;
+
+    Bag bag;
+    bag.set(options);
+    Compilation compilation(bag);
+    compilation.addSyntaxTree(tree);
+
+    // Checking stops partway through the design, so parts of it are
+    // still unelaborated and it has to be visited serially.
+    compilation.getAllDiagnostics();
+    CHECK(!compilation.isFullyElaborated());
+
+    ThreadPool pool(4);
+    ParallelASTVisitor<CountingVisitor> parallel(pool);
+    parallel.visit(compilation);
+
+    CountingVisitor sequential;
+    compilation.getRoot().visit(sequential);
+    CHECK(sequential.bodies == 9);
+
+    CountingVisitor total;
+    size_t busy = 0;
+    parallel.reduce([&](CountingVisitor& v) {
+        total.statements += v.statements;
+        total.bodies += v.bodies;
+        total.blocks += v.blocks;
+        if (v.bodies)
+            busy++;
+    });
+
+    CHECK(busy == 1);
+    CHECK(total.statements == sequential.statements);
+    CHECK(total.bodies == sequential.bodies);
+    CHECK(total.blocks == sequential.blocks);
+}
@@ -0,0 +1,128 @@
+//------------------------------------------------------------------------------
+// astbench.cpp
+// Compares the cost of producing and consuming the JSON and binary AST
+// output formats for a given design.
+//
+// File is under the MIT license; see LICENSE for details
+//------------------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "slang/compilation/Compilation.h"
+#include "slang/symbols/ASTSerializer.h"
+#include "slang/symbols/BinaryASTWriter.h"
+#include "slang/symbols/CompilationUnitSymbols.h"
+#include "slang/syntax/SyntaxTree.h"
+#include "slang/text/BinaryAST.h"
+#include "slang/text/Json.h"
+
+using namespace slang;
+
+template<typename TFunc>
+static double timeIt(TFunc&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+// There's no JSON parser in the tree, so as a stand-in this does the minimum
+// amount of work any parser would need to do: find the boundaries of every
+// token while correctly skipping over string contents. Real parsers will be
+// slower than this, so it's a lower bound on the cost of reading JSON.
+static size_t scanJson(string_view json) {
+    size_t tokens = 0;
+    for (size_t i = 0; i < json.size(); i++) {
+        char c = json[i];
+        if (c == '"') {
+            for (i++; i < json.size() && json[i] != '"'; i++) {
+                if (json[i] == '\\')
+                    i++;
+            }
+            tokens++;
+        }
+        else if (c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',') {
+            tokens++;
+        }
+    }
+    return tokens;
+}
+
+static size_t countValues(BinaryASTValue value) {
+    size_t count = 1;
+    if (value.isObject()) {
+        value.forEachProperty(
+            [&](string_view, BinaryASTValue prop) { count += countValues(prop); });
+    }
+    else if (value.isArray()) {
+        value.forEachElement([&](BinaryASTValue elem) { count += countValues(elem); });
+    }
+    return count;
+}
+
+int main(int argc, char** argv) try {
+    if (argc < 2) {
+        fprintf(stderr, "usage: astbench file...\n");
+        return 1;
+    }
+
+    Compilation compilation;
+    for (int i = 1; i < argc; i++)
+        compilation.addSyntaxTree(SyntaxTree::fromFile(argv[i]));
+
+    double elabTime = timeIt([&] { compilation.getAllDiagnostics(); });
+    printf("elaboration: %.1f ms\n\n", elabTime);
+
+    std::string json;
+    double jsonWrite = timeIt([&] {
+        JsonWriter writer;
+        writer.setOutput([&](string_view text) { json.append(text); });
+
+        ASTSerializer serializer(compilation, writer);
+        serializer.setIncludeAddresses(false);
+        serializer.serialize(compilation.getRoot());
+        writer.flush();
+    });
+
+    size_t jsonTokens = 0;
+    double jsonRead = timeIt([&] { jsonTokens = scanJson(json); });
+
+    std::string binary;
+    double binaryWrite = timeIt([&] {
+        BinaryASTWriter writer;
+        ASTSerializer serializer(compilation, writer);
+        serializer.setIncludeAddresses(false);
+        serializer.serialize(compilation.getRoot());
+        writer.finish([&](string_view text) { binary.append(text); });
+    });
+
+    BinaryASTReader reader(span<const char>(binary.data(), binary.size()));
+
+    size_t binaryValues = 0;
+    double binaryRead = timeIt([&] {
+        for (uint32_t i = 0; i < reader.getNumRoots(); i++)
+            binaryValues += countValues(reader.getRoot(i));
+    });
+
+    size_t found = 0;
+    double lookup = timeIt([&] {
+        for (uint32_t i = 0; i < reader.getNumScopes(); i++) {
+            if (reader.findScope(reader.getScopePath(i)))
+                found++;
+        }
+    });
+
+    printf("format   size (bytes)   write (ms)   read (ms)\n");
+    printf("json     %12zu   %10.1f   %9.1f  (scan only, %zu tokens)\n", json.size(), jsonWrite,
+           jsonRead, jsonTokens);
+    printf("binary   %12zu   %10.1f   %9.1f  (full traversal, %zu values)\n", binary.size(),
+           binaryWrite, binaryRead, binaryValues);
+    printf("\nindexed lookup of %zu instances: %.3f ms\n", found, lookup);
+    return 0;
+}
+catch (const std::exception& e) {
+    printf("internal compiler error (exception): %s\n", e.what());
+    return 2;
+}
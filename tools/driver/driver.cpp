@@ -5,10 +5,13 @@
 // File is under the MIT license; see LICENSE for details
 //------------------------------------------------------------------------------
 
+#include <cstdlib>
 #include <fstream>
+#include <functional>
 #include <iostream>
 
 #include "slang/compilation/Compilation.h"
+#include "slang/compilation/Definition.h"
 #include "slang/diagnostics/DeclarationsDiags.h"
 #include "slang/diagnostics/DiagnosticEngine.h"
 #include "slang/diagnostics/ExpressionsDiags.h"
@@ -18,10 +21,13 @@
 #include "slang/diagnostics/TextDiagnosticClient.h"
 #include "slang/parsing/Preprocessor.h"
 #include "slang/symbols/ASTSerializer.h"
+#include "slang/symbols/ASTVisitor.h"
+#include "slang/symbols/BinaryASTWriter.h"
 #include "slang/symbols/CompilationUnitSymbols.h"
 #include "slang/symbols/InstanceSymbols.h"
 #include "slang/syntax/SyntaxPrinter.h"
 #include "slang/syntax/SyntaxTree.h"
+#include "slang/syntax/SyntaxTreeCache.h"
 #include "slang/text/Json.h"
 #include "slang/text/SourceManager.h"
 #include "slang/util/CommandLine.h"
@@ -41,7 +47,9 @@ static constexpr auto warningColor = fmt::terminal_color::bright_yellow;
 static constexpr auto errorColor = fmt::terminal_color::bright_red;
 static constexpr auto highlightColor = fmt::terminal_color::bright_green;
 
-void writeToFile(string_view fileName, string_view contents);
+using WriteCallback = function_ref<void(string_view)>;
+void writeToFile(string_view fileName, function_ref<void(WriteCallback)> writeContents,
+                 std::ios::openmode mode = std::ios::out);
 
 bool runPreprocessor(SourceManager& sourceManager, const Bag& options,
                      const std::vector<SourceBuffer>& buffers, bool includeComments,
@@ -53,17 +61,31 @@ bool runPreprocessor(SourceManager& sourceManager, const Bag& options,
     for (auto it = buffers.rbegin(); it != buffers.rend(); it++)
         preprocessor.pushSource(*it);
 
+    // Stream the output as we go instead of building up the whole thing in memory,
+    // since preprocessed output can be very large.
     SyntaxPrinter output;
     output.setIncludeComments(includeComments);
     output.setIncludeDirectives(includeDirectives);
+    output.setOutput([](string_view text) { OS::print("{}", text); });
 
+    // Tokens aren't needed once they've been printed, so the memory they use gets
+    // released every so often. Macro definitions are kept across each release, so
+    // the threshold grows along with them to keep the cost of copying them amortized.
+    const size_t releaseChunkSize = 16 * 1024 * 1024;
+    size_t releaseThreshold = releaseChunkSize;
     while (true) {
         Token token = preprocessor.next();
         output.print(token);
         if (token.kind == TokenKind::EndOfFile)
             break;
+
+        if (alloc.getBytesAllocated() > releaseThreshold && preprocessor.releaseTokens())
+            releaseThreshold = alloc.getBytesAllocated() * 2 + releaseChunkSize;
     }
 
+    output.flush();
+    OS::print("\n");
+
     // Only print diagnostics if actual errors occurred.
     for (auto& diag : diagnostics) {
         if (diag.isError()) {
@@ -72,7 +94,6 @@ bool runPreprocessor(SourceManager& sourceManager, const Bag& options,
         }
     }
 
-    OS::print("{}\n", output.str());
     return true;
 }
 
@@ -299,6 +320,208 @@ bool loadAllSources(Compilation& compilation, SourceManager& sourceManager,
     return ok;
 }
 
+/// Statistics about an elaborated design, broken down by definition, for finding
+/// out which parts of the design are responsible for slow elaboration.
+struct DesignStats {
+    struct Row {
+        const Definition* definition = nullptr;
+        size_t instances = 0;
+        size_t symbols = 0;
+        size_t bytesAllocated = 0;
+        double constEvalMs = 0;
+
+        // One instance body for each distinct set of parameter values, bucketed
+        // by a hash of those values.
+        flat_hash_map<size_t, std::vector<const InstanceBodySymbol*>> uniqueBodies;
+        size_t numUnique = 0;
+    };
+
+    std::vector<Row> rows;
+    size_t totalInstances = 0;
+    Compilation::ElaborationCounters counters;
+    Compilation::TypeRelationStats typeRelations;
+    BumpAllocator::Stats memory;
+
+    explicit DesignStats(Compilation& compilation) :
+        counters(compilation.getElaborationCounters()),
+        typeRelations(compilation.getTypeRelationStats()), memory(compilation.getStats()) {
+
+        Visitor visitor(*this);
+        compilation.getRoot().visit(visitor);
+
+        for (auto& row : rows) {
+            totalInstances += row.instances;
+            if (auto defStats = compilation.getDefinitionStats(*row.definition)) {
+                row.bytesAllocated = defStats->bytesAllocated;
+                row.constEvalMs =
+                    std::chrono::duration<double, std::milli>(defStats->constEvalTime).count();
+            }
+        }
+
+        // Put the most expensive definitions first.
+        std::stable_sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+            if (a.bytesAllocated != b.bytesAllocated)
+                return a.bytesAllocated > b.bytesAllocated;
+            return a.symbols > b.symbols;
+        });
+    }
+
+    void printTable() const {
+        size_t nameWidth = 10;
+        for (auto& row : rows)
+            nameWidth = std::max(nameWidth, row.definition->name.size());
+
+        OS::print(fg(warningColor), "Elaboration statistics:\n");
+        OS::print("{}\n", fmt::format("{:<{}} {:>10} {:>8} {:>10} {:>14} {:>12}", "Definition",
+                                      nameWidth, "Instances", "Unique", "Symbols", "Bytes",
+                                      "Eval (ms)"));
+
+        for (auto& row : rows) {
+            OS::print("{}\n", fmt::format("{:<{}} {:>10} {:>8} {:>10} {:>14} {:>12.3f}",
+                                          row.definition->name, nameWidth, row.instances,
+                                          row.numUnique, row.symbols,
+                                          row.bytesAllocated, row.constEvalMs));
+        }
+
+        OS::print("\n");
+        OS::print("Instances:            {}\n", totalInstances);
+        OS::print("Name lookups:         {}\n", counters.lookups);
+        OS::print("Types created:        {}\n", counters.typesCreated);
+        OS::print("Const eval steps:     {}\n", counters.evalSteps);
+        OS::print("Type relation cache:  {} hits, {} misses\n", typeRelations.hits,
+                  typeRelations.misses);
+        OS::print("Arena memory:         {} bytes allocated, {} reserved, {} wasted, "
+                  "{} segments\n",
+                  memory.bytesAllocated, memory.bytesReserved, memory.bytesWasted,
+                  memory.segmentCount);
+    }
+
+    void writeJson(JsonWriter& writer) const {
+        writer.startObject();
+        writer.writeProperty("definitions");
+        writer.startArray();
+        for (auto& row : rows) {
+            writer.startObject();
+            writer.writeProperty("name");
+            writer.writeValue(row.definition->name);
+            writer.writeProperty("kind");
+            writer.writeValue(row.definition->getKindString());
+            writer.writeProperty("instances");
+            writer.writeValue(uint64_t(row.instances));
+            writer.writeProperty("uniqueParameterizations");
+            writer.writeValue(uint64_t(row.numUnique));
+            writer.writeProperty("symbols");
+            writer.writeValue(uint64_t(row.symbols));
+            writer.writeProperty("bytesAllocated");
+            writer.writeValue(uint64_t(row.bytesAllocated));
+            writer.writeProperty("constEvalMs");
+            writer.writeValue(row.constEvalMs);
+            writer.endObject();
+        }
+        writer.endArray();
+
+        writer.writeProperty("totals");
+        writer.startObject();
+        writer.writeProperty("instances");
+        writer.writeValue(uint64_t(totalInstances));
+        writer.writeProperty("lookups");
+        writer.writeValue(uint64_t(counters.lookups));
+        writer.writeProperty("typesCreated");
+        writer.writeValue(uint64_t(counters.typesCreated));
+        writer.writeProperty("evalSteps");
+        writer.writeValue(uint64_t(counters.evalSteps));
+        writer.writeProperty("typeRelationCacheHits");
+        writer.writeValue(uint64_t(typeRelations.hits));
+        writer.writeProperty("typeRelationCacheMisses");
+        writer.writeValue(uint64_t(typeRelations.misses));
+        writer.writeProperty("bytesAllocated");
+        writer.writeValue(uint64_t(memory.bytesAllocated));
+        writer.writeProperty("bytesReserved");
+        writer.writeValue(uint64_t(memory.bytesReserved));
+        writer.writeProperty("bytesWasted");
+        writer.writeValue(uint64_t(memory.bytesWasted));
+        writer.writeProperty("segmentCount");
+        writer.writeValue(uint64_t(memory.segmentCount));
+        writer.endObject();
+        writer.endObject();
+    }
+
+private:
+    // Counts instances and symbols, charging each symbol to the definition
+    // of the instance body that contains it.
+    struct Visitor : public ASTVisitor<Visitor, false, false> {
+        DesignStats& stats;
+        flat_hash_map<const Definition*, size_t> rowIndex;
+
+        // Index of the row for the instance body being visited. Rows are
+        // referred to by index because new ones can be added at any time.
+        size_t current = SIZE_MAX;
+
+        explicit Visitor(DesignStats& stats) : stats(stats) {}
+
+        template<typename T>
+        void handle(const T& symbol) {
+            countSymbol();
+            visitDefault(symbol);
+        }
+
+        void handle(const GenerateBlockSymbol& symbol) {
+            if (!symbol.isInstantiated)
+                return;
+
+            countSymbol();
+            visitDefault(symbol);
+        }
+
+        void handle(const InstanceSymbol& symbol) {
+            countSymbol();
+
+            auto& def = symbol.getDefinition();
+            auto [it, inserted] = rowIndex.emplace(&def, stats.rows.size());
+            if (inserted)
+                stats.rows.emplace_back().definition = &def;
+
+            auto& row = stats.rows[it->second];
+            row.instances++;
+
+            // Only bodies whose parameters hash the same need a full comparison.
+            auto& bodies = row.uniqueBodies[hashParameters(symbol.body)];
+            if (std::none_of(bodies.begin(), bodies.end(),
+                             [&](auto body) { return body->hasSameType(symbol.body); })) {
+                bodies.push_back(&symbol.body);
+                row.numUnique++;
+            }
+
+            auto saved = std::exchange(current, it->second);
+            visitDefault(symbol.body);
+            current = saved;
+        }
+
+        void countSymbol() {
+            if (current != SIZE_MAX)
+                stats.rows[current].symbols++;
+        }
+
+        // Hashes the parameter values of an instance body such that bodies for
+        // which hasSameType is true always hash the same. Type parameters only
+        // contribute their bit width, since types can match without being identical.
+        static size_t hashParameters(const InstanceBodySymbol& body) {
+            size_t h = 0;
+            for (auto param : body.parameters) {
+                auto& symbol = param->symbol;
+                if (symbol.kind == SymbolKind::Parameter) {
+                    hash_combine(h, symbol.as<ParameterSymbol>().getValue().hash());
+                }
+                else {
+                    auto& type = symbol.as<TypeParameterSymbol>().targetType.getType();
+                    hash_combine(h, type.getBitWidth());
+                }
+            }
+            return h;
+        }
+    };
+};
+
 enum class CompatMode { None, VCS };
 
 class Compiler {
@@ -344,12 +567,15 @@ public:
             diagEngine.issue(diag);
     }
 
+    void issueDiagnostics() {
+        auto& diags = onlyParse ? compilation.getParseDiagnostics()
+                                : compilation.getAllDiagnostics();
+        for (auto& diag : diags)
+            diagEngine.issue(diag);
+    }
+
     bool run() {
-        if (onlyParse) {
-            for (auto& diag : compilation.getParseDiagnostics())
-                diagEngine.issue(diag);
-        }
-        else {
+        if (!onlyParse) {
 #ifndef FUZZ_TARGET
             auto topInstances = compilation.getRoot().topInstances;
             if (!quiet && !topInstances.empty()) {
@@ -359,11 +585,10 @@ public:
                 OS::print("\n");
             }
 #endif
-
-            for (auto& diag : compilation.getAllDiagnostics())
-                diagEngine.issue(diag);
         }
 
+        issueDiagnostics();
+
         bool succeeded = diagEngine.getNumErrors() == 0;
 
 #ifndef FUZZ_TARGET
@@ -388,11 +613,49 @@ public:
         return succeeded;
     }
 
-    void printJson(const std::string& fileName, const std::vector<std::string>& scopes) {
-        JsonWriter writer;
-        writer.setPrettyPrint(true);
+    void printJson(const std::string& fileName, const std::vector<std::string>& scopes,
+                   bool pretty) {
+        // The JSON for a large design can be huge, so stream it out
+        // as it's generated instead of building it up in memory.
+        writeToFile(fileName, [&](WriteCallback write) {
+            JsonWriter writer;
+            writer.setPrettyPrint(pretty);
+            writer.setOutput([&](string_view text) { write(text); });
+
+            ASTSerializer serializer(compilation, writer);
+            serializeScopes(serializer, scopes);
+            writer.flush();
+        });
+    }
+
+    void printStats(bool showTable, const optional<std::string>& jsonFile) {
+        DesignStats stats(compilation);
+        if (showTable)
+            stats.printTable();
+
+        if (jsonFile) {
+            writeToFile(*jsonFile, [&](WriteCallback write) {
+                JsonWriter writer;
+                writer.setPrettyPrint(true);
+                stats.writeJson(writer);
+                write(writer.view());
+            });
+        }
+    }
 
+    void printBinary(const std::string& fileName, const std::vector<std::string>& scopes) {
+        BinaryASTWriter writer;
         ASTSerializer serializer(compilation, writer);
+        serializer.setIncludeAddresses(false);
+        serializeScopes(serializer, scopes);
+
+        writeToFile(
+            fileName, [&](WriteCallback write) { writer.finish(write); },
+            std::ios::out | std::ios::binary);
+    }
+
+private:
+    void serializeScopes(ASTSerializer& serializer, const std::vector<std::string>& scopes) {
         if (scopes.empty()) {
             serializer.serialize(compilation.getRoot());
         }
@@ -403,25 +666,533 @@ public:
                     serializer.serialize(*sym);
             }
         }
+    }
+};
+
+/// Collects reported diagnostics so that they can be handed to other tools.
+class CollectingDiagnosticClient : public DiagnosticClient {
+public:
+    struct Entry {
+        std::string severity;
+        std::string message;
+        std::string file;
+        size_t line = 0;
+        size_t column = 0;
+    };
+
+    std::vector<Entry> entries;
+
+    void report(const ReportedDiagnostic& diag) override {
+        Entry entry;
+        entry.severity = std::string(getSeverityString(diag.severity));
+        entry.message = std::string(diag.formattedMessage);
+        if (diag.location != SourceLocation::NoLocation) {
+            entry.file = std::string(sourceManager->getFileName(diag.location));
+            entry.line = sourceManager->getLineNumber(diag.location);
+            entry.column = sourceManager->getColumnNumber(diag.location);
+        }
+        entries.emplace_back(std::move(entry));
+    }
 
-        writeToFile(fileName, writer.view());
+    void write(JsonWriter& writer) const {
+        writer.startArray();
+        for (auto& entry : entries) {
+            writer.startObject();
+            writer.writeProperty("severity");
+            writer.writeValue(entry.severity);
+            writer.writeProperty("message");
+            writer.writeValue(entry.message);
+            if (!entry.file.empty()) {
+                writer.writeProperty("file");
+                writer.writeValue(entry.file);
+                writer.writeProperty("line");
+                writer.writeValue(uint64_t(entry.line));
+                writer.writeProperty("column");
+                writer.writeValue(uint64_t(entry.column));
+            }
+            writer.endObject();
+        }
+        writer.endArray();
+    }
+};
+
+/// Keeps a compilation resident in memory and services compile requests read from
+/// stdin, one JSON-RPC message per line. Each request checks the files that went into
+/// the compilation for changes, reloads only the ones whose contents actually changed,
+/// and creates a new compilation with their new syntax trees that reuses the previous
+/// diagnostics for unaffected design elements.
+class CompileServer {
+public:
+    using LoadCallback = std::function<bool(Compilation&)>;
+    using SetupCallback = std::function<void(Compiler&)>;
+
+    CompileServer(SourceManager& sourceManager, const Bag& options, bool singleUnit,
+                  LoadCallback loadSources, SetupCallback setupCompiler) :
+        sourceManager(sourceManager),
+        options(options), singleUnit(singleUnit), loadSources(std::move(loadSources)),
+        setupCompiler(std::move(setupCompiler)) {}
+
+    void run() {
+        rebuild();
+
+        std::string line;
+        while (std::getline(std::cin, line)) {
+            if (line.find_first_not_of(" \t\r") == std::string::npos)
+                continue;
+
+            if (!handleMessage(line))
+                break;
+        }
+    }
+
+private:
+    struct FileStamp {
+        fs::file_time_type mtime;
+        size_t hash = 0;
+    };
+
+    SourceManager& sourceManager;
+    const Bag& options;
+    bool singleUnit;
+    LoadCallback loadSources;
+    SetupCallback setupCompiler;
+
+    std::unique_ptr<Compilation> compilation;
+    bool sourcesLoaded = false;
+
+    // Buffers created before this point belong to older versions of the design.
+    uint32_t firstBuffer = 0;
+
+    // Source buffers whose files can't be reparsed on their own; if any file loaded
+    // into them changes the whole compilation needs to be rebuilt.
+    flat_hash_set<BufferID> globalRoots;
+
+    // Files that went into each syntax tree, with the tree's own file first.
+    flat_hash_map<const SyntaxTree*, std::vector<std::string>> treeFiles;
+    flat_hash_set<std::string> globalFiles;
+    flat_hash_map<std::string, FileStamp> stamps;
+
+    static size_t hashText(string_view text) { return std::hash<string_view>()(text); }
+
+    BufferID getRootBuffer(BufferID buffer) const {
+        while (true) {
+            auto includedFrom = sourceManager.getIncludedFrom(buffer);
+            if (!includedFrom.buffer())
+                return buffer;
+            buffer = includedFrom.buffer();
+        }
+    }
+
+    flat_hash_map<BufferID, const SyntaxTree*> getTreesByBuffer() const {
+        // With a single compilation unit the first tree is made up of all of the
+        // source files, so it can't be reparsed from just one of them.
+        flat_hash_map<BufferID, const SyntaxTree*> results;
+        auto trees = compilation->getSyntaxTrees();
+        for (size_t i = singleUnit ? 1 : 0; i < trees.size(); i++) {
+            auto loc = sourceManager.getFullyExpandedLoc(trees[i]->getEOFToken().location());
+            if (sourceManager.isFileLoc(loc))
+                results.emplace(getRootBuffer(loc.buffer()), trees[i].get());
+        }
+        return results;
+    }
+
+    void rebuild() {
+        auto buffers = sourceManager.getAllBuffers();
+        firstBuffer = buffers.empty() ? 0 : buffers.back().getId() + 1;
+
+        compilation = std::make_unique<Compilation>(options);
+        sourcesLoaded = loadSources(*compilation);
+
+        auto treesByBuffer = getTreesByBuffer();
+        globalRoots.clear();
+        for (auto buffer : sourceManager.getAllBuffers()) {
+            if (buffer.getId() >= firstBuffer && !sourceManager.getIncludedFrom(buffer) &&
+                treesByBuffer.find(buffer) == treesByBuffer.end()) {
+                globalRoots.emplace(buffer);
+            }
+        }
+
+        stamps.clear();
+        trackFiles();
+    }
+
+    void trackFiles() {
+        auto treesByBuffer = getTreesByBuffer();
+        treeFiles.clear();
+        globalFiles.clear();
+
+        flat_hash_map<std::string, FileStamp> newStamps;
+        for (auto buffer : sourceManager.getAllBuffers()) {
+            if (buffer.getId() < firstBuffer)
+                continue;
+
+            fs::path path = sourceManager.getFullPath(buffer);
+            if (path.empty())
+                continue;
+
+            // Buffers for trees that have since been replaced are left behind in the
+            // source manager; only files for the current set of trees matter.
+            auto pathStr = path.u8string();
+            BufferID root = getRootBuffer(buffer);
+            if (auto it = treesByBuffer.find(root); it != treesByBuffer.end()) {
+                auto& files = treeFiles[it->second];
+                if (root == buffer)
+                    files.insert(files.begin(), pathStr);
+                else
+                    files.push_back(pathStr);
+            }
+            else if (globalRoots.find(root) != globalRoots.end()) {
+                globalFiles.emplace(pathStr);
+            }
+            else {
+                continue;
+            }
+
+            if (newStamps.find(pathStr) != newStamps.end())
+                continue;
+
+            if (auto it = stamps.find(pathStr); it != stamps.end()) {
+                newStamps.emplace(pathStr, it->second);
+                continue;
+            }
+
+            FileStamp stamp;
+            std::error_code ec;
+            stamp.mtime = fs::last_write_time(path, ec);
+            stamp.hash = hashText(sourceManager.getSourceText(buffer));
+            newStamps.emplace(pathStr, stamp);
+        }
+
+        stamps = std::move(newStamps);
+    }
+
+    // Finds all of the files that have changed on disk since they were loaded.
+    flat_hash_set<std::string> findChangedFiles() {
+        flat_hash_set<std::string> changed;
+        for (auto& [pathStr, stamp] : stamps) {
+            fs::path path = widen(pathStr);
+            std::error_code ec;
+            auto mtime = fs::last_write_time(path, ec);
+            if (!ec && mtime == stamp.mtime)
+                continue;
+
+            // A newer timestamp doesn't necessarily mean the contents changed,
+            // so check the hash before throwing away any work.
+            std::vector<char> buffer;
+            if (!ec && OS::readFile(path, buffer)) {
+                if (hashText(string_view(buffer.data(), buffer.size())) == stamp.hash) {
+                    stamp.mtime = mtime;
+                    continue;
+                }
+            }
+
+            changed.emplace(pathStr);
+        }
+        return changed;
+    }
+
+    // Brings the compilation up to date with any changes to its files on disk.
+    // Returns the number of syntax trees that had to be parsed again.
+    size_t update() {
+        auto changed = findChangedFiles();
+        if (changed.empty())
+            return 0;
+
+        bool needRebuild = false;
+        for (auto& path : changed) {
+            sourceManager.removeCachedFile(widen(path));
+            stamps.erase(path);
+            if (globalFiles.find(path) != globalFiles.end())
+                needRebuild = true;
+        }
+
+        std::vector<const SyntaxTree*> toReplace;
+        if (!needRebuild) {
+            for (auto& [tree, files] : treeFiles) {
+                for (auto& file : files) {
+                    if (changed.find(file) != changed.end()) {
+                        toReplace.push_back(tree);
+                        break;
+                    }
+                }
+            }
+        }
+
+        // All of the changed trees are replaced at once, so that the checking done for
+        // the current compilation is reused for everything none of them affect.
+        std::vector<std::pair<const SyntaxTree*, std::shared_ptr<SyntaxTree>>> replacements;
+        for (auto oldTree : toReplace) {
+            SourceBuffer buffer = sourceManager.readSource(widen(treeFiles[oldTree][0]));
+            if (!buffer) {
+                needRebuild = true;
+                break;
+            }
+
+            auto newTree = SyntaxTree::fromBuffer(buffer, sourceManager, options);
+            newTree->isLibrary = oldTree->isLibrary;
+            replacements.emplace_back(oldTree, std::move(newTree));
+        }
+
+        if (!needRebuild && !replacements.empty())
+            compilation = compilation->replaceSyntaxTreesReusingDiagnostics(replacements);
+
+        size_t reparsed = toReplace.size();
+        if (needRebuild) {
+            rebuild();
+            reparsed = compilation->getSyntaxTrees().size();
+        }
+        else {
+            trackFiles();
+        }
+
+        // The old versions of the changed files were only used by the syntax trees
+        // that have just been replaced, so their memory can be given back.
+        sourceManager.releaseRemovedFiles();
+        return reparsed;
+    }
+
+    struct CompileResult {
+        std::shared_ptr<CollectingDiagnosticClient> diagnostics;
+        std::string output;
+        size_t errors = 0;
+        size_t warnings = 0;
+        size_t reparsed = 0;
+        bool success = false;
+    };
+
+    CompileResult compile() {
+        CompileResult result;
+        result.reparsed = update();
+
+        Compiler compiler(*compilation);
+        setupCompiler(compiler);
+        compiler.diagClient->showColors(false);
+
+        result.diagnostics = std::make_shared<CollectingDiagnosticClient>();
+        compiler.diagEngine.addClient(result.diagnostics);
+        compiler.issueDiagnostics();
+
+        result.output = compiler.diagClient->getString();
+        result.errors = compiler.diagEngine.getNumErrors();
+        result.warnings = compiler.diagEngine.getNumWarnings();
+        result.success = sourcesLoaded && result.errors == 0;
+        return result;
+    }
+
+    static void writeResult(JsonWriter& writer, const CompileResult& result) {
+        writer.startObject();
+        writer.writeProperty("success");
+        writer.writeValue(result.success);
+        writer.writeProperty("errors");
+        writer.writeValue(uint64_t(result.errors));
+        writer.writeProperty("warnings");
+        writer.writeValue(uint64_t(result.warnings));
+        writer.writeProperty("reparsed");
+        writer.writeValue(uint64_t(result.reparsed));
+        writer.writeProperty("diagnostics");
+        result.diagnostics->write(writer);
+        writer.writeProperty("output");
+        writer.writeValue(result.output);
+        writer.endObject();
+    }
+
+    static void respond(const JsonValue* id, function_ref<void(JsonWriter&)> writeBody) {
+        JsonWriter writer;
+        writer.startObject();
+        writer.writeProperty("jsonrpc");
+        writer.writeValue("2.0"sv);
+        writer.writeProperty("id");
+        if (id)
+            id->write(writer);
+        else
+            writer.writeNull();
+
+        writeBody(writer);
+        writer.endObject();
+
+        OS::print("{}\n", writer.view());
+        fflush(stdout);
+    }
+
+    static void respondError(const JsonValue* id, int code, string_view message) {
+        respond(id, [&](JsonWriter& writer) {
+            writer.writeProperty("error");
+            writer.startObject();
+            writer.writeProperty("code");
+            writer.writeValue(int64_t(code));
+            writer.writeProperty("message");
+            writer.writeValue(message);
+            writer.endObject();
+        });
+    }
+
+    // Handles a single JSON-RPC message. Returns false if the server should exit.
+    bool handleMessage(string_view text) {
+        JsonValue message;
+        try {
+            message = JsonValue::parse(text);
+        }
+        catch (const std::exception& e) {
+            respondError(nullptr, -32700, e.what());
+            return true;
+        }
+
+        // Messages without an ID are notifications, which don't get a response.
+        auto id = message.find("id");
+        auto method = message.find("method");
+        if (!method || !method->isString()) {
+            respondError(id, -32600, "Invalid request");
+            return true;
+        }
+
+        auto& name = method->getString();
+        if (name == "exit")
+            return false;
+
+        if (name == "shutdown") {
+            if (id) {
+                respond(id, [](JsonWriter& writer) {
+                    writer.writeProperty("result");
+                    writer.writeNull();
+                });
+            }
+            return false;
+        }
+
+        if (name != "compile") {
+            if (id)
+                respondError(id, -32601, fmt::format("Unknown method '{}'", name));
+            return true;
+        }
+
+        // Do the work before starting the response, so that an
+        // internal error doesn't leave a partially written result.
+        CompileResult result;
+        try {
+            result = compile();
+        }
+        catch (const std::exception& e) {
+            if (id)
+                respondError(id, -32603, fmt::format("internal compiler error: {}", e.what()));
+            return true;
+        }
+
+        if (id) {
+            respond(id, [&](JsonWriter& writer) {
+                writer.writeProperty("result");
+                writeResult(writer, result);
+            });
+        }
+        return true;
     }
 };
 
 #if defined(INCLUDE_SIM)
 using namespace slang::mir;
 
-bool runSim(Compilation& compilation) {
+struct SimOptions {
+    CodegenOptions codegen;
+    JITOptions jit;
+    bool showTiming = false;
+};
+
+std::vector<GeneratedCode> generateSimCode(Compilation& compilation, const SimOptions& options) {
     MIRBuilder builder(compilation);
     builder.elaborate();
 
-    CodeGenerator codegen(compilation);
+    CodeGenerator codegen(compilation, options.codegen);
     codegen.emitAll(builder);
 
-    JIT jit;
-    jit.addCode(codegen.finish());
+    auto code = codegen.finish();
+    if (options.showTiming) {
+        for (auto& module : code) {
+            auto& timing = module.getTiming();
+            OS::print("module '{}': codegen {:.3f}s, optimize {:.3f}s (-O{})\n",
+                      module.getName(), timing.codegen, timing.optimize,
+                      options.codegen.optLevel);
+        }
+    }
+    return code;
+}
+
+bool runSim(Compilation& compilation, const SimOptions& options) {
+    // Generating the code first also sets up the native target that the JIT needs.
+    auto code = generateSimCode(compilation, options);
+
+    JIT jit(options.jit);
+    jit.addCode(std::move(code));
     return jit.run() == 0;
 }
+
+void emitSimObject(Compilation& compilation, const SimOptions& options,
+                   const std::string& objFile) {
+    // Parallel code generation produces multiple modules, but we want just one object.
+    SimOptions singleModule = options;
+    singleModule.codegen.numThreads = 1;
+
+    auto code = generateSimCode(compilation, singleModule);
+    ASSERT(code.size() == 1);
+    code[0].writeObjectFile(objFile);
+}
+
+// Finds one of the libraries that simulation executables link against. The driver
+// and libraries are laid out the same way in the build tree and in an install tree
+// (bin/ and lib/ siblings), so look next to the running binary first and then fall
+// back to the configured install location.
+optional<std::string> findSimLibrary(const std::string& name) {
+    std::vector<fs::path> searchDirs;
+    if (auto exePath = OS::getExecutablePath(); !exePath.empty())
+        searchDirs.push_back(exePath.parent_path().parent_path() / "lib");
+    searchDirs.push_back(fs::path(SLANG_SIM_INSTALL_LIBDIR));
+
+    for (auto& dir : searchDirs) {
+        std::error_code ec;
+        auto path = dir / name;
+        if (fs::is_regular_file(path, ec))
+            return path.string();
+    }
+    return std::nullopt;
+}
+
+bool emitSimExecutable(Compilation& compilation, const SimOptions& options,
+                       const std::string& exeFile) {
+    std::vector<std::string> args = { SLANG_SIM_LINKER };
+    for (auto name : { SLANG_SIM_RUNTIME_LIB, SLANG_SIM_CORE_LIB }) {
+        auto lib = findSimLibrary(name);
+        if (!lib) {
+            OS::printE(fg(errorColor), "error: ");
+            OS::printE("unable to find simulation runtime library '{}'\n", name);
+            return false;
+        }
+        args.emplace_back(std::move(*lib));
+    }
+
+    std::string objFile = exeFile + ".o";
+    emitSimObject(compilation, options, objFile);
+
+    // Hand off to the system compiler driver to link against the runtime. The runtime
+    // libraries need to come after the object file that refers to them.
+    args.insert(args.begin() + 1, { objFile, "-o", exeFile });
+    string_view systemLibs = SLANG_SIM_SYSTEM_LIBS;
+    while (!systemLibs.empty()) {
+        size_t end = systemLibs.find(' ');
+        if (end != 0)
+            args.emplace_back(systemLibs.substr(0, end));
+        systemLibs = end == string_view::npos ? string_view() : systemLibs.substr(end + 1);
+    }
+
+    int result = OS::runProcess(args);
+
+    std::error_code ec;
+    fs::remove(objFile, ec);
+
+    if (result != 0) {
+        OS::printE(fg(errorColor), "error: ");
+        OS::printE("failed to link simulation executable '{}'\n", exeFile);
+        return false;
+    }
+    return true;
+}
 #endif
 
 template<typename TArgs>
@@ -436,6 +1207,11 @@ int driverMain(int argc, TArgs argv, bool suppressColorsStdout, bool suppressCol
     cmdLine.add("--version", showVersion, "Display version information and exit");
     cmdLine.add("-q,--quiet", quiet, "Suppress non-essential output");
 
+    optional<bool> serverMode;
+    cmdLine.add("--server", serverMode,
+                "Run as a persistent compile server that reads JSON-RPC requests from stdin, "
+                "one per line, and recompiles only what has changed for each request");
+
     // Output control
     optional<bool> onlyPreprocess;
     optional<bool> onlyParse;
@@ -483,12 +1259,16 @@ int driverMain(int argc, TArgs argv, bool suppressColorsStdout, bool suppressCol
     // Parsing
     optional<uint32_t> maxParseDepth;
     optional<uint32_t> maxLexerErrors;
+    optional<std::string> syntaxCacheDir;
     cmdLine.add("--max-parse-depth", maxParseDepth,
                 "Maximum depth of nested language constructs allowed", "<depth>");
     cmdLine.add("--max-lexer-errors", maxLexerErrors,
                 "Maximum number of errors that can occur during lexing before the rest of the file "
                 "is skipped",
                 "<count>");
+    cmdLine.add("--syntax-cache", syntaxCacheDir,
+                "Directory in which to cache parsed syntax trees across runs", "<dir>",
+                /* isFileName */ true);
 
     // JSON dumping
     optional<std::string> astJsonFile;
@@ -502,6 +1282,29 @@ int driverMain(int argc, TArgs argv, bool suppressColorsStdout, bool suppressCol
                 "given hierarchical paths",
                 "<path>");
 
+    optional<bool> astJsonCompact;
+    cmdLine.add("--ast-json-compact", astJsonCompact,
+                "When dumping AST to JSON, omit all whitespace and indentation");
+
+    optional<std::string> astBinaryFile;
+    cmdLine.add("--ast-binary", astBinaryFile,
+                "Dump the compiled AST in the compact binary format to the specified file. "
+                "The scopes to include can be selected with --ast-json-scope",
+                "<file>", /* isFileName */ true);
+
+    // Statistics
+    optional<bool> showStats;
+    cmdLine.add("--stats", showStats,
+                "After elaborating, print per-definition statistics (instances, unique "
+                "parameterizations, symbols, memory, and constant evaluation time) along with "
+                "totals for the whole design");
+
+    optional<std::string> statsJsonFile;
+    cmdLine.add("--stats-json", statsJsonFile,
+                "Write the statistics shown by --stats in JSON format to the specified file, "
+                "or '-' for stdout",
+                "<file>", /* isFileName */ true);
+
     // Compilation
     optional<uint32_t> maxInstanceDepth;
     optional<uint32_t> maxGenerateSteps;
@@ -621,7 +1424,31 @@ int driverMain(int argc, TArgs argv, bool suppressColorsStdout, bool suppressCol
 #if defined(INCLUDE_SIM)
     // Simulation
     optional<bool> shouldSim;
+    optional<std::string> simCacheDir;
+    optional<uint32_t> simOptLevel;
+    optional<uint32_t> simThreads;
+    optional<bool> simTiming;
     cmdLine.add("--sim", shouldSim, "After compiling, try to simulate the design");
+    cmdLine.add("-O", simOptLevel, "Optimization level for generated simulation code (0-3)",
+                "<level>");
+    cmdLine.add("--sim-threads", simThreads,
+                "Number of threads to use for generating and compiling simulation code",
+                "<count>");
+    cmdLine.add("--sim-timing", simTiming,
+                "Print the time spent generating and optimizing simulation code");
+    cmdLine.add("--sim-cache", simCacheDir,
+                "Directory in which to cache compiled simulation code across runs", "<dir>",
+                /* isFileName */ true);
+
+    optional<std::string> emitObjFile;
+    optional<std::string> emitExeFile;
+    cmdLine.add("--emit-obj", emitObjFile,
+                "After compiling, write the simulation code to the specified object file",
+                "<file>", /* isFileName */ true);
+    cmdLine.add("--emit-exe", emitExeFile,
+                "After compiling, build a standalone simulation executable at the "
+                "specified path",
+                "<file>", /* isFileName */ true);
 #endif
 
     if (!cmdLine.parse(argc, argv)) {
@@ -728,6 +1555,7 @@ int driverMain(int argc, TArgs argv, bool suppressColorsStdout, bool suppressCol
 
     CompilationOptions coptions;
     coptions.suppressUnused = false;
+    coptions.collectStats = showStats == true || statsJsonFile.has_value();
     if (maxInstanceDepth.has_value())
         coptions.maxInstanceDepth = *maxInstanceDepth;
     if (maxGenerateSteps.has_value())
@@ -778,6 +1606,12 @@ int driverMain(int argc, TArgs argv, bool suppressColorsStdout, bool suppressCol
     options.set(poptions);
     options.set(coptions);
 
+    std::unique_ptr<SyntaxTreeCache> syntaxCache;
+    if (syntaxCacheDir.has_value()) {
+        syntaxCache = std::make_unique<SyntaxTreeCache>(*syntaxCacheDir);
+        options.set(SyntaxCacheOptions{ syntaxCache.get() });
+    }
+
     std::vector<SourceBuffer> buffers;
     for (const std::string& file : sourceFiles) {
         SourceBuffer buffer = readSource(sourceManager, file);
@@ -806,6 +1640,12 @@ int driverMain(int argc, TArgs argv, bool suppressColorsStdout, bool suppressCol
         return 4;
     }
 
+    if (serverMode == true && (onlyPreprocess == true || onlyMacros == true)) {
+        OS::printE(fg(errorColor), "error: ");
+        OS::printE("--server can't be combined with --preprocess or --macros-only");
+        return 4;
+    }
+
     try {
         if (onlyPreprocess == true) {
             anyErrors = !runPreprocessor(sourceManager, options, buffers, includeComments == true,
@@ -815,41 +1655,92 @@ int driverMain(int argc, TArgs argv, bool suppressColorsStdout, bool suppressCol
             printMacros(sourceManager, options, buffers);
         }
         else {
+            if (onlyLint == true)
+                ignoreUnknownModules = true;
+
+            auto setupCompiler = [&](Compiler& compiler) {
+                compiler.quiet = quiet == true;
+                compiler.onlyParse = onlyParse == true;
+
+                auto& diag = *compiler.diagClient;
+                diag.showColors(showColors);
+                diag.showColumn(diagColumn.value_or(true));
+                diag.showLocation(diagLocation.value_or(true));
+                diag.showSourceLine(diagSourceLine.value_or(true));
+                diag.showOptionName(diagOptionName.value_or(true));
+                diag.showIncludeStack(diagIncludeStack.value_or(true));
+                diag.showMacroExpansion(diagMacroExpansion.value_or(true));
+                diag.showHierarchyInstance(diagHierarchy.value_or(true));
+
+                compiler.diagEngine.setErrorLimit((int)errorLimit.value_or(20));
+                compiler.setDiagnosticOptions(warningOptions, ignoreUnknownModules == true,
+                                              allowUseBeforeDeclare == true, compatMode);
+            };
+
+            if (serverMode == true) {
+                // The server reloads the sources itself whenever it needs to rebuild.
+                auto loadSources = [&](Compilation& compilation) {
+                    bool ok = true;
+                    std::vector<SourceBuffer> currBuffers;
+                    for (const std::string& file : sourceFiles) {
+                        SourceBuffer buffer = readSource(sourceManager, file);
+                        if (buffer)
+                            currBuffers.push_back(buffer);
+                        else
+                            ok = false;
+                    }
+
+                    return loadAllSources(compilation, sourceManager, currBuffers, options,
+                                          singleUnit == true, onlyLint == true, libraryFiles,
+                                          libDirs, libExts) &&
+                           ok;
+                };
+
+                CompileServer server(sourceManager, options, singleUnit == true, loadSources,
+                                     setupCompiler);
+                server.run();
+                return 0;
+            }
+
             Compilation compilation(options);
             anyErrors =
                 !loadAllSources(compilation, sourceManager, buffers, options, singleUnit == true,
                                 onlyLint == true, libraryFiles, libDirs, libExts);
 
-            if (onlyLint == true)
-                ignoreUnknownModules = true;
-
             Compiler compiler(compilation);
-            compiler.quiet = quiet == true;
-            compiler.onlyParse = onlyParse == true;
-
-            auto& diag = *compiler.diagClient;
-            diag.showColors(showColors);
-            diag.showColumn(diagColumn.value_or(true));
-            diag.showLocation(diagLocation.value_or(true));
-            diag.showSourceLine(diagSourceLine.value_or(true));
-            diag.showOptionName(diagOptionName.value_or(true));
-            diag.showIncludeStack(diagIncludeStack.value_or(true));
-            diag.showMacroExpansion(diagMacroExpansion.value_or(true));
-            diag.showHierarchyInstance(diagHierarchy.value_or(true));
-
-            compiler.diagEngine.setErrorLimit((int)errorLimit.value_or(20));
-            compiler.setDiagnosticOptions(warningOptions, ignoreUnknownModules == true,
-                                          allowUseBeforeDeclare == true, compatMode);
+            setupCompiler(compiler);
 
             anyErrors |= !compiler.run();
 
             if (astJsonFile) {
-                compiler.printJson(*astJsonFile, astJsonScopes);
+                compiler.printJson(*astJsonFile, astJsonScopes, astJsonCompact != true);
+            }
+
+            if (astBinaryFile) {
+                compiler.printBinary(*astBinaryFile, astJsonScopes);
             }
 
+            if ((showStats == true || statsJsonFile) && !onlyParse.value_or(false))
+                compiler.printStats(showStats == true, statsJsonFile);
+
 #if defined(INCLUDE_SIM)
-            if (!anyErrors && !onlyParse.value_or(false) && shouldSim == true) {
-                anyErrors = !runSim(compilation);
+            if (!anyErrors && !onlyParse.value_or(false)) {
+                SimOptions simOptions;
+                simOptions.codegen.optLevel = std::min(simOptLevel.value_or(0), 3u);
+                simOptions.codegen.numThreads = std::max(simThreads.value_or(1), 1u);
+                simOptions.jit.objectCacheDir = simCacheDir.value_or("");
+                simOptions.jit.numCompileThreads =
+                    simOptions.codegen.numThreads > 1 ? simOptions.codegen.numThreads : 0;
+                simOptions.showTiming = simTiming == true;
+
+                if (emitObjFile)
+                    emitSimObject(compilation, simOptions, *emitObjFile);
+
+                if (emitExeFile)
+                    anyErrors = !emitSimExecutable(compilation, simOptions, *emitExeFile);
+
+                if (!anyErrors && shouldSim == true)
+                    anyErrors = !runSim(compilation, simOptions);
             }
 #endif
         }
@@ -876,9 +1767,14 @@ catch (const std::exception& e) {
 #endif
 }
 
-template<typename Stream, typename String>
-void writeToFile(Stream& os, string_view fileName, String contents) {
-    os.write(contents.data(), contents.size());
+template<typename Stream, typename TConvert>
+void writeToFile(Stream& os, string_view fileName, function_ref<void(WriteCallback)> writeContents,
+                 TConvert&& convert) {
+    writeContents([&](string_view text) {
+        auto contents = convert(text);
+        os.write(contents.data(), contents.size());
+    });
+
     os.flush();
     if (!os)
         throw std::runtime_error(fmt::format("Unable to write AST to '{}'", fileName));
@@ -889,13 +1785,28 @@ void writeToFile(Stream& os, string_view fileName, String contents) {
 #    include <fcntl.h>
 #    include <io.h>
 
-void writeToFile(string_view fileName, string_view contents) {
-    if (fileName == "-") {
-        writeToFile(std::wcout, "stdout", widen(contents));
+void writeToFile(string_view fileName, function_ref<void(WriteCallback)> writeContents,
+                 std::ios::openmode mode) {
+    if (fileName == "-" && (mode & std::ios::binary)) {
+        // Binary data can't go through the wide character conversion, so switch
+        // stdout over to raw bytes for the duration of the write.
+        std::wcout.flush();
+        fflush(stdout);
+        int oldMode = _setmode(_fileno(stdout), _O_BINARY);
+        writeContents([](string_view text) { fwrite(text.data(), 1, text.size(), stdout); });
+        fflush(stdout);
+        _setmode(_fileno(stdout), oldMode);
+
+        if (ferror(stdout))
+            throw std::runtime_error("Unable to write AST to 'stdout'");
+    }
+    else if (fileName == "-") {
+        writeToFile(std::wcout, "stdout", writeContents,
+                    [](string_view text) { return widen(text); });
     }
     else {
-        std::ofstream file(widen(fileName));
-        writeToFile(file, fileName, contents);
+        std::ofstream file(widen(fileName), mode);
+        writeToFile(file, fileName, writeContents, [](string_view text) { return text; });
     }
 }
 
@@ -924,13 +1835,15 @@ int wmain(int argc, wchar_t** argv) {
 
 #else
 
-void writeToFile(string_view fileName, string_view contents) {
+void writeToFile(string_view fileName, function_ref<void(WriteCallback)> writeContents,
+                 std::ios::openmode mode) {
+    auto convert = [](string_view text) { return text; };
     if (fileName == "-") {
-        writeToFile(std::cout, "stdout", contents);
+        writeToFile(std::cout, "stdout", writeContents, convert);
     }
     else {
-        std::ofstream file{ std::string(fileName) };
-        writeToFile(file, fileName, contents);
+        std::ofstream file(std::string(fileName), mode);
+        writeToFile(file, fileName, writeContents, convert);
     }
 }
 
@@ -0,0 +1,98 @@
+//------------------------------------------------------------------------------
+// lookupbench.cpp
+// Measures name lookup cost in a generated design that leans heavily
+// on wildcard package imports.
+//
+// File is under the MIT license; see LICENSE for details
+//------------------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "slang/compilation/Compilation.h"
+#include "slang/syntax/SyntaxTree.h"
+
+using namespace slang;
+
+template<typename TFunc>
+static double timeIt(TFunc&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+// Builds a design with the given number of packages, each declaring the given number
+// of parameters. A single module wildcard imports all of the packages and then has a
+// number of generate blocks that each reference every parameter of the last package,
+// which is the worst case for searching through the imports in order.
+static std::string generateDesign(int numPackages, int numItems, int numBlocks) {
+    std::string text;
+    for (int p = 0; p < numPackages; p++) {
+        text += "package pkg" + std::to_string(p) + ";\n";
+        for (int i = 0; i < numItems; i++) {
+            text += "    localparam int p" + std::to_string(p) + "_" + std::to_string(i) +
+                    " = " + std::to_string(i) + ";\n";
+        }
+        text += "endpackage\n\n";
+    }
+
+    text += "module top;\n";
+    for (int p = 0; p < numPackages; p++)
+        text += "    import pkg" + std::to_string(p) + "::*;\n";
+
+    std::string last = "p" + std::to_string(numPackages - 1) + "_";
+    text += "    for (genvar g = 0; g < " + std::to_string(numBlocks) + "; g++) begin : gen\n";
+    text += "        localparam int s = 0";
+    for (int i = 0; i < numItems; i++)
+        text += " + " + last + std::to_string(i);
+    text += ";\n    end\nendmodule\n";
+
+    return text;
+}
+
+static int parseArg(int argc, char** argv, int index, int defaultValue) {
+    if (index >= argc)
+        return defaultValue;
+
+    int value = atoi(argv[index]);
+    return value > 0 ? value : defaultValue;
+}
+
+int main(int argc, char** argv) try {
+    if (argc > 4) {
+        fprintf(stderr, "usage: lookupbench [packages] [items] [blocks]\n");
+        return 1;
+    }
+
+    int numPackages = parseArg(argc, argv, 1, 64);
+    int numItems = parseArg(argc, argv, 2, 64);
+    int numBlocks = parseArg(argc, argv, 3, 4000);
+
+    std::string text = generateDesign(numPackages, numItems, numBlocks);
+    printf("%d packages, %d items per package, %d generate blocks (%zu lookups)\n\n",
+           numPackages, numItems, numBlocks, size_t(numItems) * size_t(numBlocks));
+
+    std::shared_ptr<SyntaxTree> tree;
+    double parseTime = timeIt([&] { tree = SyntaxTree::fromText(text); });
+
+    Compilation compilation;
+    compilation.addSyntaxTree(tree);
+
+    size_t numDiags = 0;
+    double elabTime = timeIt([&] { numDiags = compilation.getAllDiagnostics().size(); });
+
+    printf("parse:       %.1f ms\n", parseTime);
+    printf("elaboration: %.1f ms\n", elabTime);
+    if (numDiags) {
+        printf("\nunexpected diagnostics: %zu\n", numDiags);
+        return 1;
+    }
+    return 0;
+}
+catch (const std::exception& e) {
+    printf("internal compiler error (exception): %s\n", e.what());
+    return 2;
+}